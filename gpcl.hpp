@@ -12,40 +12,59 @@
 #define GPCL_HPP
 
 #include <gpcl/assert.hpp>
+#include <gpcl/barrier.hpp>
+#include <gpcl/big_reader_lock.hpp>
+#include <gpcl/bitmap_segregated_storage.hpp>
 #include <gpcl/buffer.hpp>
 #include <gpcl/buffer_sequence.hpp>
 #include <gpcl/clock.hpp>
 #include <gpcl/clone_ptr.hpp>
 #include <gpcl/condition_variable.hpp>
+#include <gpcl/counting_semaphore.hpp>
 #include <gpcl/creation_tag.hpp>
 #include <gpcl/decay_copy.hpp>
 #include <gpcl/error.hpp>
 #include <gpcl/event.hpp>
 #include <gpcl/expected.hpp>
 #include <gpcl/expected_fwd.hpp>
+#include <gpcl/fast_condition_variable.hpp>
+#include <gpcl/fast_event.hpp>
+#include <gpcl/fast_mutex.hpp>
 #include <gpcl/file.hpp>
 #include <gpcl/in_place.hpp>
 #include <gpcl/intrusive_list.hpp>
 #include <gpcl/inttypes.hpp>
 #include <gpcl/is_basic_lockable.hpp>
 #include <gpcl/is_lockable.hpp>
+#include <gpcl/latch.hpp>
 #include <gpcl/lock_file.hpp>
+#include <gpcl/lockfree_singleton_pool.hpp>
+#include <gpcl/managed_shared_memory.hpp>
 #include <gpcl/message_queue.hpp>
+#include <gpcl/mpmc_queue.hpp>
 #include <gpcl/mutex.hpp>
 #include <gpcl/narrow_cast.hpp>
 #include <gpcl/noncopyable.hpp>
+#include <gpcl/numa_pool.hpp>
 #include <gpcl/object_pool.hpp>
 #include <gpcl/offset_ptr.hpp>
 #include <gpcl/optional.hpp>
 #include <gpcl/optional_fwd.hpp>
 #include <gpcl/pool.hpp>
 #include <gpcl/pool_allocator.hpp>
+#include <gpcl/pool_statistics.hpp>
 #include <gpcl/semaphore.hpp>
+#include <gpcl/shared_lock.hpp>
+#include <gpcl/shared_mutex.hpp>
+#include <gpcl/shm_mpsc_channel.hpp>
+#include <gpcl/shm_spsc_ring.hpp>
 #include <gpcl/simple_segregated_storage.hpp>
 #include <gpcl/span.hpp>
 #include <gpcl/thread.hpp>
 #include <gpcl/thread_annotations.hpp>
 #include <gpcl/thread_attributes.hpp>
+#include <gpcl/thread_cached_pool.hpp>
+#include <gpcl/thread_pool.hpp>
 #include <gpcl/time.hpp>
 #include <gpcl/unexpected.hpp>
 #include <gpcl/unique_lock.hpp>
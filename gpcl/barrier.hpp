@@ -0,0 +1,173 @@
+//
+// barrier.hpp
+// ~~~~~~~~~~~
+//
+// Copyright (c) 2020 Zhengyi Fu (tsingyat at outlook dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef GPCL_BARRIER_HPP
+#define GPCL_BARRIER_HPP
+
+#include <gpcl/assert.hpp>
+#include <gpcl/detail/config.hpp>
+#include <gpcl/detail/futex.hpp>
+#include <gpcl/noncopyable.hpp>
+#include <gpcl/time.hpp>
+#include <atomic>
+#include <cerrno>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#ifdef GPCL_POSIX
+
+namespace gpcl {
+
+namespace detail {
+
+struct barrier_noop
+{
+  void operator()() const noexcept {}
+};
+
+} // namespace detail
+
+/// A reusable barrier: in each phase, a fixed number of threads arrive, the
+/// last one runs the completion function, and then all waiters are released.
+///
+/// The phase number is a futex word; arriving is an atomic decrement, and
+/// only the last arrival makes a system call, if threads wait.
+///
+/// \requires Calling CompletionFunction does not throw.
+template <typename CompletionFunction = detail::barrier_noop>
+class barrier : noncopyable
+{
+public:
+  /// Identifies the phase a thread arrived in.
+  class arrival_token
+  {
+  public:
+    arrival_token() = default;
+
+  private:
+    friend class barrier;
+
+    explicit arrival_token(std::uint32_t phase) noexcept : phase_(phase) {}
+
+    std::uint32_t phase_{};
+  };
+
+  /// \requires 0 <= expected <= max().
+  explicit barrier(std::ptrdiff_t expected,
+                   CompletionFunction f = CompletionFunction())
+      : expected_(expected),
+        remaining_(expected),
+        completion_(std::move(f))
+  {
+    GPCL_ASSERT(expected >= 0 && expected <= max());
+  }
+
+  /// \requires No thread waits on the barrier.
+  ~barrier() { GPCL_ASSERT(waiters_.load() == 0); }
+
+  static constexpr std::ptrdiff_t max() noexcept { return INT_MAX; }
+
+  /// \effects Arrives update times in the current phase, completing it if
+  /// these are the last expected arrivals.
+  ///
+  /// \returns A token to wait for the end of the phase with.
+  [[nodiscard]] arrival_token arrive(std::ptrdiff_t update = 1) noexcept
+  {
+    GPCL_ASSERT(update > 0);
+    // The phase cannot end before we arrive, so it is still current.
+    std::uint32_t phase = phase_.load(std::memory_order_relaxed);
+    std::ptrdiff_t left = remaining_.fetch_sub(update) - update;
+    GPCL_ASSERT(left >= 0);
+    if (left == 0)
+      complete_phase();
+    return arrival_token(phase);
+  }
+
+  /// \effects Blocks until the phase of token has completed.
+  void wait(arrival_token &&token) const noexcept
+  {
+    while (phase_.load() == token.phase_)
+      sleep(token.phase_, nullptr);
+  }
+
+  /// \effects Blocks for at most rel_time until the phase of token has
+  /// completed.
+  ///
+  /// \returns Whether the phase has completed.
+  bool wait_for(arrival_token &&token, const duration &rel_time) const noexcept
+  {
+    return wait_until(std::move(token),
+                      instant::now().saturating_add(rel_time));
+  }
+
+  /// \effects Blocks until abs_time at the latest until the phase of token
+  /// has completed.
+  ///
+  /// \returns Whether the phase has completed.
+  bool wait_until(arrival_token &&token, const instant &abs_time) const
+      noexcept
+  {
+    while (phase_.load() == token.phase_)
+    {
+      if (sleep(token.phase_, &abs_time) == ETIMEDOUT)
+        return phase_.load() != token.phase_;
+    }
+    return true;
+  }
+
+  /// \effects Arrives and waits for the end of the phase.
+  void arrive_and_wait() noexcept { wait(arrive()); }
+
+  /// \effects Arrives and leaves the barrier: the following phases expect
+  /// one arrival less.
+  void arrive_and_drop() noexcept
+  {
+    expected_.fetch_sub(1, std::memory_order_relaxed);
+    (void)arrive();
+  }
+
+private:
+  void complete_phase() noexcept
+  {
+    completion_();
+    remaining_.store(expected_.load(std::memory_order_relaxed),
+                     std::memory_order_relaxed);
+    // Releasing the new phase publishes the completion and the reset
+    // counter to the threads that arrive in it after waiting.
+    phase_.fetch_add(1);
+    if (waiters_.load() != 0)
+      detail::futex_wake(phase_, INT_MAX, false);
+  }
+
+  int sleep(std::uint32_t phase, const instant *deadline) const noexcept
+  {
+    waiters_.fetch_add(1);
+    int err = deadline
+                  ? detail::futex_wait_until(phase_, phase, *deadline, false)
+                  : detail::futex_wait(phase_, phase, nullptr, false);
+    waiters_.fetch_sub(1, std::memory_order_relaxed);
+    return err;
+  }
+
+  std::atomic<std::ptrdiff_t> expected_;
+  std::atomic<std::ptrdiff_t> remaining_;
+  CompletionFunction completion_;
+
+  mutable detail::futex_word phase_{0};
+  mutable std::atomic<std::uint32_t> waiters_{0};
+};
+
+} // namespace gpcl
+
+#endif // GPCL_POSIX
+
+#endif // GPCL_BARRIER_HPP
@@ -0,0 +1,81 @@
+//
+// big_reader_lock.hpp
+// ~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2020 Zhengyi Fu (tsingyat at outlook dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef GPCL_BIG_READER_LOCK_HPP
+#define GPCL_BIG_READER_LOCK_HPP
+
+#include <gpcl/detail/config.hpp>
+#include <gpcl/detail/percpu_rwlock.hpp>
+#include <gpcl/noncopyable.hpp>
+#include <gpcl/thread_annotations.hpp>
+#include <cstddef>
+
+#ifdef GPCL_POSIX
+
+namespace gpcl {
+
+/// A reader-writer lock for data that is read far more often than it is
+/// written.
+///
+/// Every CPU has its own cache line for counting readers, so that readers on
+/// different CPUs do not contend: taking the lock shared costs two atomic
+/// instructions on a line that is local to the reader. In exchange, taking
+/// it exclusively has to look at every CPU's line and wait until all of them
+/// are drained. Waiting writers hold off new readers.
+///
+/// A thread counts itself on the line of the CPU it first took the lock on.
+/// The lock is not recursive in either mode, and a thread must release a
+/// shared lock itself.
+class GPCL_CAPABILITY("mutex") big_reader_lock : noncopyable
+{
+public:
+  using impl_type = detail::percpu_rwlock;
+
+  /// Constructs a lock with one reader counter per configured CPU.
+  big_reader_lock() = default;
+
+  /// Constructs a lock with the given number of reader counters, which is
+  /// at least 1.
+  explicit big_reader_lock(std::size_t slots) : impl_(slots) {}
+
+  GPCL_ACQUIRE() auto lock() noexcept -> void { impl_.lock(); }
+  GPCL_RELEASE() auto unlock() noexcept -> void { impl_.unlock(); }
+  GPCL_TRY_ACQUIRE(true) auto try_lock() noexcept -> bool
+  {
+    return impl_.try_lock();
+  }
+
+  GPCL_ACQUIRE_SHARED() auto lock_shared() noexcept -> void
+  {
+    impl_.lock_shared();
+  }
+
+  GPCL_RELEASE_SHARED() auto unlock_shared() noexcept -> void
+  {
+    impl_.unlock_shared();
+  }
+
+  GPCL_TRY_ACQUIRE_SHARED(true) auto try_lock_shared() noexcept -> bool
+  {
+    return impl_.try_lock_shared();
+  }
+
+  /// \returns The number of reader counters.
+  auto slots() const noexcept -> std::size_t { return impl_.slots(); }
+
+private:
+  impl_type impl_;
+};
+
+} // namespace gpcl
+
+#endif // GPCL_POSIX
+
+#endif // GPCL_BIG_READER_LOCK_HPP
@@ -0,0 +1,489 @@
+//
+// bitmap_segregated_storage.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2020 Zhengyi Fu (tsingyat at outlook dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef GPCL_BITMAP_SEGREGATED_STORAGE_HPP
+#define GPCL_BITMAP_SEGREGATED_STORAGE_HPP
+
+#include <gpcl/assert.hpp>
+#include <gpcl/detail/config.hpp>
+#include <gpcl/noncopyable.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace gpcl {
+
+namespace detail {
+
+inline unsigned count_trailing_zeros(std::uint64_t x) noexcept
+{
+  GPCL_ASSERT(x != 0);
+#ifdef __GNUC__
+  return unsigned(__builtin_ctzll(x));
+#else
+  unsigned n = 0;
+  while (!(x & 1))
+  {
+    x >>= 1;
+    ++n;
+  }
+  return n;
+#endif
+}
+
+inline unsigned count_leading_zeros(std::uint64_t x) noexcept
+{
+  GPCL_ASSERT(x != 0);
+#ifdef __GNUC__
+  return unsigned(__builtin_clzll(x));
+#else
+  unsigned n = 0;
+  while (!(x & (std::uint64_t(1) << 63)))
+  {
+    x <<= 1;
+    ++n;
+  }
+  return n;
+#endif
+}
+
+} // namespace detail
+
+/// Segregated storage that tracks free chunks with a per-block bitmap.
+///
+/// This is a drop-in storage policy for pool with the same interface as
+/// simple_segregated_storage. Every block carries a bitmap with one bit per
+/// chunk (set if the chunk is free) and a small descriptor, both placed at
+/// the end of the block. Blocks are indexed by address.
+///
+/// Compared to simple_segregated_storage:
+/// - free(), ordered_free() and ordered_free_n() locate the block with a
+///   binary search over the blocks and set bits, in O(log B + n / 64) where
+///   B is the number of blocks; nothing walks the free list.
+/// - malloc_n() scans the bitmaps one 64-bit word at a time, in
+///   O(C / 64) where C is the number of chunks.
+/// - The storage is always ordered: malloc() returns the lowest free chunk
+///   of the current block.
+template <typename SizeType = std::size_t>
+class bitmap_segregated_storage : noncopyable
+{
+  using word_type = std::uint64_t;
+  static const SizeType word_bits = 64;
+
+  struct block_descriptor
+  {
+    char *begin;
+    SizeType partition_sz;
+    SizeType count;
+    SizeType free;
+    word_type *bits;
+
+    // No free chunk lives in the words before this one.
+    SizeType hint;
+  };
+
+public:
+  using size_type = SizeType;
+
+  /// \returns An upper bound of the bytes used for bookkeeping in a block of
+  /// size sz.
+  static constexpr size_type block_overhead(size_type sz,
+                                            size_type partition_sz) noexcept
+  {
+    return (sz / partition_sz + word_bits - 1) / word_bits * sizeof(word_type) +
+           sizeof(block_descriptor) + alignof(block_descriptor) +
+           alignof(word_type);
+  }
+
+  /// \effects Partitions the memory block of size sz into partition_sz-sized
+  /// chunks and marks all of them free.
+  ///
+  /// \preconditions sz >= partition_sz + block_overhead(sz, partition_sz),
+  /// block is properly aligned for an array of objects of size partition_sz.
+  ///
+  /// \postconditions !this->empty().
+  ///
+  /// \complexity O(sz / partition_sz / 64 + B).
+  void add_block(void *const block, size_type sz, size_type partition_sz)
+  {
+    GPCL_ASSERT(block);
+    GPCL_ASSERT(partition_sz != 0);
+
+    size_type count = sz / partition_sz;
+    size_type bits_offset, desc_offset;
+    for (;; --count)
+    {
+      GPCL_ASSERT(count != 0);
+      bits_offset = align_up(count * partition_sz, alignof(word_type));
+      desc_offset = align_up(bits_offset + words(count) * sizeof(word_type),
+                             alignof(block_descriptor));
+      if (desc_offset + sizeof(block_descriptor) <= sz)
+        break;
+    }
+
+    char *p = static_cast<char *>(block);
+    auto *desc = reinterpret_cast<block_descriptor *>(p + desc_offset);
+    desc->begin = p;
+    desc->partition_sz = partition_sz;
+    desc->count = count;
+    desc->free = count;
+    desc->bits = reinterpret_cast<word_type *>(p + bits_offset);
+    desc->hint = 0;
+
+    std::fill_n(desc->bits, words(count), ~word_type(0));
+    if (count % word_bits)
+      desc->bits[count / word_bits] = (word_type(1) << count % word_bits) - 1;
+
+    auto pos = std::upper_bound(blocks_.begin(), blocks_.end(), p, less_begin);
+    pos = blocks_.insert(pos, desc);
+    current_ = static_cast<size_type>(pos - blocks_.begin());
+    free_ += count;
+  }
+
+  /// \effects Same as add_block(); the storage is always ordered.
+  void add_ordered_block(void *const block, size_type sz,
+                         size_type partition_sz)
+  {
+    add_block(block, sz, partition_sz);
+  }
+
+  /// \returns true if `this` is empty.
+  bool empty() const { return free_ == 0; }
+
+  /// \effects Remove the lowest free chunk of the current block.
+  /// \preconditions !this->empty().
+  /// \returns Pointer to the removed chunk.
+  ///
+  /// \complexity O(B + C / 64) in the worst case. Each block remembers the
+  /// lowest word that may hold a free chunk, so the usual cost is O(1).
+  void *malloc(size_type partition_sz)
+  {
+    (void)partition_sz;
+    GPCL_ASSERT(!empty());
+
+    block_descriptor *desc = blocks_[current_];
+    if (desc->free == 0)
+    {
+      current_ = 0;
+      while (blocks_[current_]->free == 0)
+        ++current_;
+      desc = blocks_[current_];
+    }
+
+    for (size_type w = desc->hint;; ++w)
+    {
+      GPCL_ASSERT(w < words(desc->count));
+      if (word_type x = desc->bits[w])
+      {
+        desc->hint = w;
+        unsigned bit = detail::count_trailing_zeros(x);
+        desc->bits[w] = x & (x - 1);
+        --desc->free;
+        --free_;
+        return desc->begin + (w * word_bits + bit) * desc->partition_sz;
+      }
+    }
+  }
+
+  /// \effects Attempt to find a sequence of n contiguous free chunks. If
+  /// found, remove them from the storage.
+  ///
+  /// \returns Pointer to the first removed chunk, or null.
+  ///
+  /// \complexity O(C / 64 + n / 64 * log n).
+  void *malloc_n(size_type n, size_type partition_sz)
+  {
+    (void)partition_sz;
+    GPCL_ASSERT(n != 0);
+
+    for (block_descriptor *desc : blocks_)
+    {
+      if (desc->free < n)
+        continue;
+
+      size_type first = find_run(desc, n);
+      if (first != desc->count)
+      {
+        clear_bits(desc->bits, first, n);
+        desc->free -= n;
+        free_ -= n;
+        return desc->begin + first * desc->partition_sz;
+      }
+    }
+    return nullptr;
+  }
+
+  /// \effects Remove up to n chunks from the storage. The removed chunks are
+  /// linked through their first word and the last one points to null.
+  ///
+  /// \param n maximum number of chunks to remove.
+  /// \param first receives the first removed chunk.
+  /// \returns The number of removed chunks.
+  size_type malloc_batch(size_type n, void *&first)
+  {
+    first = nullptr;
+    void **link = &first;
+    size_type m = 0;
+
+    for (block_descriptor *desc : blocks_)
+    {
+      for (size_type w = desc->hint;
+           m < n && desc->free != 0 && w < words(desc->count); ++w)
+      {
+        desc->hint = w;
+        word_type x = desc->bits[w];
+        while (m < n && x)
+        {
+          unsigned bit = detail::count_trailing_zeros(x);
+          x &= x - 1;
+          char *chunk =
+              desc->begin + (w * word_bits + bit) * desc->partition_sz;
+          *link = chunk;
+          link = reinterpret_cast<void **>(chunk);
+          --desc->free;
+          ++m;
+        }
+        desc->bits[w] = x;
+      }
+      if (m == n)
+        break;
+    }
+
+    *link = nullptr;
+    free_ -= m;
+    return m;
+  }
+
+  /// \effects Put chunk back to the storage.
+  ///
+  /// \preconditions chunk was previously returned from this->malloc() or
+  /// this->malloc_batch().
+  ///
+  /// \complexity O(log B).
+  void free(void *const chunk)
+  {
+    block_descriptor *desc = find_block(chunk);
+    size_type i = index_of(desc, chunk);
+    GPCL_ASSERT(!(desc->bits[i / word_bits] & (word_type(1) << i % word_bits)));
+    desc->bits[i / word_bits] |= word_type(1) << i % word_bits;
+    desc->hint = (std::min)(desc->hint, i / word_bits);
+    ++desc->free;
+    ++free_;
+  }
+
+  /// \effects Put a list of chunks linked through their first word back to
+  /// the storage.
+  ///
+  /// \complexity O(m log B) where m is the length of the list.
+  void free_batch(void *const first, void *const last)
+  {
+    GPCL_ASSERT(first && last);
+    void *chunk = first;
+    for (;;)
+    {
+      void *next = *static_cast<void **>(chunk);
+      free(chunk);
+      if (chunk == last)
+        break;
+      chunk = next;
+    }
+  }
+
+  /// \effects Put an array of n chunks back to the storage.
+  ///
+  /// \preconditions the array of chunks was previously returned from a call to
+  /// this->malloc_n().
+  ///
+  /// \complexity O(log B + n / 64).
+  void free_n(void *const chunk, size_type partition_sz, size_type n)
+  {
+    (void)partition_sz;
+    block_descriptor *desc = find_block(chunk);
+    size_type i = index_of(desc, chunk);
+    set_bits(desc->bits, i, n);
+    desc->hint = (std::min)(desc->hint, i / word_bits);
+    desc->free += n;
+    free_ += n;
+  }
+
+  /// \effects Same as free().
+  void ordered_free(void *const chunk) { free(chunk); }
+
+  /// \effects Same as free_n().
+  void ordered_free_n(void *const chunk, size_type n, size_type partition_sz)
+  {
+    free_n(chunk, partition_sz, n);
+  }
+
+  /// \effects If every chunk of the block added by add_block(block, sz,
+  /// partition_sz) is free, removes the block from the storage.
+  ///
+  /// \returns true if the block was removed; it may then be freed.
+  ///
+  /// \complexity O(B).
+  bool release_block(void *const block, size_type sz, size_type partition_sz)
+  {
+    (void)sz;
+    (void)partition_sz;
+    auto *p = static_cast<char *>(block);
+    auto pos = std::upper_bound(blocks_.begin(), blocks_.end(), p, less_begin);
+    GPCL_ASSERT(pos != blocks_.begin() && (*(pos - 1))->begin == p);
+    block_descriptor *desc = *--pos;
+    if (desc->free != desc->count)
+      return false;
+
+    free_ -= desc->count;
+    blocks_.erase(pos);
+    current_ = 0;
+    return true;
+  }
+
+  /// \effects Forgets all blocks.
+  /// \postconditions this->empty().
+  void clear() noexcept
+  {
+    blocks_.clear();
+    current_ = 0;
+    free_ = 0;
+  }
+
+private:
+  static constexpr size_type align_up(size_type n, size_type alignment)
+  {
+    return (n + alignment - 1) / alignment * alignment;
+  }
+
+  static constexpr size_type words(size_type count)
+  {
+    return (count + word_bits - 1) / word_bits;
+  }
+
+  static bool less_begin(const char *p, const block_descriptor *desc)
+  {
+    return p < desc->begin;
+  }
+
+  block_descriptor *find_block(void *const chunk) const
+  {
+    auto *p = static_cast<const char *>(chunk);
+    auto pos = std::upper_bound(blocks_.begin(), blocks_.end(), p, less_begin);
+    GPCL_ASSERT(pos != blocks_.begin());
+    block_descriptor *desc = *--pos;
+    GPCL_ASSERT(p < desc->begin + desc->count * desc->partition_sz);
+    return desc;
+  }
+
+  static size_type index_of(const block_descriptor *desc, void *const chunk)
+  {
+    auto offset =
+        static_cast<size_type>(static_cast<char *>(chunk) - desc->begin);
+    GPCL_ASSERT(offset % desc->partition_sz == 0);
+    return offset / desc->partition_sz;
+  }
+
+  // Returns the index of the first chunk of the lowest run of n free chunks,
+  // or desc->count if there is none.
+  static size_type find_run(const block_descriptor *desc, size_type n)
+  {
+    size_type run = 0;
+    size_type run_begin = 0;
+
+    for (size_type w = desc->hint; w < words(desc->count); ++w)
+    {
+      const word_type x = desc->bits[w];
+
+      if (x == ~word_type(0))
+      {
+        if (run == 0)
+          run_begin = w * word_bits;
+        run += word_bits;
+        if (run >= n)
+          return run_begin;
+        continue;
+      }
+
+      if (x == 0)
+      {
+        run = 0;
+        continue;
+      }
+
+      // The run reaching into this word from the previous ones.
+      unsigned trailing = detail::count_trailing_zeros(~x);
+      if (run != 0 && run + trailing >= n)
+        return run_begin;
+
+      // A run entirely inside this word: bit i of y is set iff bits
+      // [i, i + n) of x are all set.
+      if (n <= word_bits)
+      {
+        word_type y = x;
+        for (size_type s = 1; s < n && y;)
+        {
+          size_type t = (std::min)(s, n - s);
+          y &= y >> t;
+          s += t;
+        }
+        if (y)
+          return w * word_bits + detail::count_trailing_zeros(y);
+      }
+
+      // The run starting in this word and reaching into the next ones.
+      run = detail::count_leading_zeros(~x);
+      run_begin = (w + 1) * word_bits - run;
+    }
+
+    return desc->count;
+  }
+
+  template <typename F>
+  static void for_each_word(size_type first, size_type n, F f)
+  {
+    while (n != 0)
+    {
+      size_type bit = first % word_bits;
+      size_type len = (std::min)(n, word_bits - bit);
+      word_type mask =
+          len == word_bits ? ~word_type(0) : ((word_type(1) << len) - 1) << bit;
+      f(first / word_bits, mask);
+      first += len;
+      n -= len;
+    }
+  }
+
+  static void set_bits(word_type *bits, size_type first, size_type n)
+  {
+    for_each_word(first, n, [bits](size_type w, word_type mask) {
+      GPCL_ASSERT((bits[w] & mask) == 0);
+      bits[w] |= mask;
+    });
+  }
+
+  static void clear_bits(word_type *bits, size_type first, size_type n)
+  {
+    for_each_word(first, n, [bits](size_type w, word_type mask) {
+      GPCL_ASSERT((bits[w] & mask) == mask);
+      bits[w] &= ~mask;
+    });
+  }
+
+  // Blocks sorted by address.
+  std::vector<block_descriptor *> blocks_;
+
+  // Index of the block malloc() allocates from.
+  size_type current_{};
+
+  // Total number of free chunks.
+  size_type free_{};
+};
+
+} // namespace gpcl
+
+#endif // GPCL_BITMAP_SEGREGATED_STORAGE_HPP
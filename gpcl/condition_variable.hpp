@@ -16,8 +16,10 @@
 #include <gpcl/detail/posix_condition_variable.hpp>
 #include <gpcl/detail/win_condition_variable.hpp>
 #include <gpcl/mutex.hpp>
+#include <gpcl/time.hpp>
 #include <gpcl/unique_lock.hpp>
 #include <type_traits>
+#include <utility>
 
 namespace gpcl {
 
@@ -78,10 +80,21 @@ public:
                        system_time const &timeout_time)
   {
     unique_lock_adaptor lock_adaptor(lock);
-    return static_cast<cv_status>(impl_.wait_for(lock_adaptor.get_impl_lock(),
-                                                 timeout_time.elapsed()));
+    return static_cast<cv_status>(
+        impl_.wait_until(lock_adaptor.get_impl_lock(), timeout_time));
   }
 
+#if defined(GPCL_POSIX)
+  /// Waits until deadline at the latest. Unlike a system_time, an instant is
+  /// not affected by setting the system clock.
+  cv_status wait_until(unique_lock<mutex> &lock, const instant &deadline)
+  {
+    unique_lock_adaptor lock_adaptor(lock);
+    return static_cast<cv_status>(
+        impl_.wait_until(lock_adaptor.get_impl_lock(), deadline));
+  }
+#endif
+
   cv_status wait_for(unique_lock<mutex> &lock,
                      const duration &rel_time)
   {
@@ -104,6 +117,30 @@ public:
     return true;
   }
 
+#if defined(GPCL_POSIX)
+  template <typename Predicate>
+  bool wait_until(unique_lock<mutex> &lock, const instant &deadline,
+                  Predicate pred)
+  {
+    while (!pred())
+    {
+      if (wait_until(lock, deadline) == cv_status::timeout)
+        return pred();
+    }
+    GPCL_VERIFY(lock.owns_lock());
+    return true;
+  }
+
+  /// Waits for pred for at most rel_time in total, however many times the
+  /// thread wakes up in between.
+  template <typename Predicate>
+  bool wait_for(unique_lock<mutex> &lock, duration const &rel_time,
+                Predicate pred)
+  {
+    return wait_until(lock, instant::now().saturating_add(rel_time),
+                      std::move(pred));
+  }
+#elif defined(GPCL_WINDOWS)
   template <typename Predicate>
   bool wait_for(unique_lock<mutex> &lock, duration const &rel_time,
                 Predicate pred)
@@ -116,6 +153,7 @@ public:
     GPCL_VERIFY(lock.owns_lock());
     return true;
   }
+#endif
 
   void notify_one() { impl_.notify_one(); }
 
@@ -0,0 +1,138 @@
+//
+// counting_semaphore.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2020 Zhengyi Fu (tsingyat at outlook dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef GPCL_COUNTING_SEMAPHORE_HPP
+#define GPCL_COUNTING_SEMAPHORE_HPP
+
+#include <gpcl/assert.hpp>
+#include <gpcl/detail/config.hpp>
+#include <gpcl/detail/futex.hpp>
+#include <gpcl/noncopyable.hpp>
+#include <gpcl/time.hpp>
+#include <atomic>
+#include <cerrno>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+
+#ifdef GPCL_POSIX
+
+namespace gpcl {
+
+/// A process-private semaphore whose count is a futex word.
+///
+/// Unlike semaphore, which wraps sem_t, acquiring an available unit and
+/// releasing without waiters are single atomic instructions that make no
+/// call into libc. Threads only sleep on the futex when the count is zero.
+///
+/// \requires 0 <= LeastMaxValue <= INT_MAX.
+template <std::ptrdiff_t LeastMaxValue = INT_MAX>
+class counting_semaphore : noncopyable
+{
+  static_assert(LeastMaxValue >= 0 && LeastMaxValue <= INT_MAX,
+                "the count has to fit a futex word");
+
+public:
+  /// \requires 0 <= desired <= max().
+  explicit counting_semaphore(std::ptrdiff_t desired) noexcept
+      : count_(static_cast<std::uint32_t>(desired))
+  {
+    GPCL_ASSERT(desired >= 0 && desired <= max());
+  }
+
+  /// \requires No thread waits on the semaphore.
+  ~counting_semaphore() { GPCL_ASSERT(waiters_.load() == 0); }
+
+  static constexpr std::ptrdiff_t max() noexcept { return LeastMaxValue; }
+
+  /// \effects Adds update to the count and wakes as many waiters.
+  ///
+  /// \requires 0 <= update and the count does not exceed max().
+  void release(std::ptrdiff_t update = 1) noexcept
+  {
+    GPCL_ASSERT(update >= 0);
+    std::uint32_t old = count_.fetch_add(static_cast<std::uint32_t>(update));
+    GPCL_ASSERT(std::ptrdiff_t(old) + update <= max());
+    (void)old;
+    if (update != 0 && waiters_.load() != 0)
+      detail::futex_wake(count_, static_cast<int>(update), false);
+  }
+
+  /// \effects Decrements the count, blocking while it is zero.
+  void acquire() noexcept
+  {
+    while (!try_acquire())
+      wait(nullptr);
+  }
+
+  /// \effects Decrements the count if it is not zero.
+  ///
+  /// \returns Whether the count was decremented.
+  bool try_acquire() noexcept
+  {
+    std::uint32_t c = count_.load(std::memory_order_relaxed);
+    while (c != 0)
+    {
+      if (count_.compare_exchange_weak(c, c - 1, std::memory_order_acquire,
+                                       std::memory_order_relaxed))
+        return true;
+    }
+    return false;
+  }
+
+  /// \effects Decrements the count, blocking for at most rel_time while it
+  /// is zero.
+  ///
+  /// \returns Whether the count was decremented.
+  bool try_acquire_for(const duration &rel_time) noexcept
+  {
+    return try_acquire_until(instant::now().saturating_add(rel_time));
+  }
+
+  /// \effects Decrements the count, blocking until abs_time at the latest
+  /// while it is zero.
+  ///
+  /// \returns Whether the count was decremented.
+  bool try_acquire_until(const instant &abs_time) noexcept
+  {
+    while (!try_acquire())
+    {
+      if (wait(&abs_time) == ETIMEDOUT)
+        return try_acquire();
+    }
+    return true;
+  }
+
+private:
+  // The waiter count is incremented before the futex rechecks the count,
+  // and release() reads it after incrementing the count, so either the
+  // releaser sees the waiter or the waiter sees the new count.
+  int wait(const instant *deadline) noexcept
+  {
+    waiters_.fetch_add(1);
+    int err = deadline
+                  ? detail::futex_wait_until(count_, 0, *deadline, false)
+                  : detail::futex_wait(count_, 0, nullptr, false);
+    waiters_.fetch_sub(1, std::memory_order_relaxed);
+    return err;
+  }
+
+  detail::futex_word count_;
+  std::atomic<std::uint32_t> waiters_{0};
+};
+
+/// A semaphore whose count is 0 or 1.
+using binary_semaphore = counting_semaphore<1>;
+
+} // namespace gpcl
+
+#endif // GPCL_POSIX
+
+#endif // GPCL_COUNTING_SEMAPHORE_HPP
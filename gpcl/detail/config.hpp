@@ -87,6 +87,12 @@
 # endif
 #endif
 
+// Size assumed for cache lines when separating data written by different
+// threads.
+#ifndef GPCL_CACHELINE_SIZE
+# define GPCL_CACHELINE_SIZE 64
+#endif
+
 #if __cpp_exceptions
 # undef GPCL_NO_EXCEPTIONS
 #else
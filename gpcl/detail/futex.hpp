@@ -0,0 +1,96 @@
+//
+// futex.hpp
+// ~~~~~~~~~
+//
+// Copyright (c) 2020 Zhengyi Fu (tsingyat at outlook dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef GPCL_DETAIL_FUTEX_HPP
+#define GPCL_DETAIL_FUTEX_HPP
+
+#include <gpcl/detail/config.hpp>
+#include <gpcl/detail/posix_clock.hpp>
+#include <gpcl/time.hpp>
+#include <atomic>
+#include <cstdint>
+
+#ifdef GPCL_POSIX
+
+#include <ctime>
+
+namespace gpcl {
+namespace detail {
+
+using futex_word = std::atomic<std::uint32_t>;
+
+static_assert(sizeof(futex_word) == sizeof(std::uint32_t),
+              "a futex is a 32-bit word");
+
+// Sleeps while word holds expected, for at most timeout if it is not null.
+// A process-private futex is cheaper, but only works for waiters and wakers
+// of the same process.
+//
+// \returns 0 if woken, otherwise EAGAIN (word did not hold expected),
+// ETIMEDOUT or EINTR. Spurious wake-ups are possible.
+GPCL_DECL int futex_wait(futex_word &word, std::uint32_t expected,
+                         const struct timespec *timeout = nullptr,
+                         bool process_shared = true) noexcept;
+
+// Sleeps while word holds expected, until deadline, an absolute time of
+// CLOCK_MONOTONIC, if it is not null. Unlike a relative timeout, the deadline
+// does not have to be recomputed after a spurious wake-up.
+//
+// \returns As futex_wait().
+GPCL_DECL int futex_wait_until(futex_word &word, std::uint32_t expected,
+                               const struct timespec *deadline,
+                               bool process_shared = true) noexcept;
+
+inline int futex_wait_until(futex_word &word, std::uint32_t expected,
+                            const instant &deadline,
+                            bool process_shared = true) noexcept
+{
+  timespec ts = to_timespec(deadline);
+  return futex_wait_until(word, expected, &ts, process_shared);
+}
+
+// Wakes at most n threads sleeping on word.
+//
+// \returns The number of threads woken.
+GPCL_DECL int futex_wake(futex_word &word, int n,
+                         bool process_shared = true) noexcept;
+
+// Wakes at most wake threads sleeping on from and moves at most requeue of
+// the others to sleep on to instead, provided from still holds expected.
+// Moving waiters that would only contend on a mutex to sleep on the mutex
+// itself spares them waking up just to go to sleep again.
+//
+// \returns 0 if done, otherwise EAGAIN (from did not hold expected).
+GPCL_DECL int futex_requeue(futex_word &from, std::uint32_t expected,
+                            int wake, int requeue, futex_word &to,
+                            bool process_shared = true) noexcept;
+
+// Tells the processor that the caller is spinning.
+GPCL_DECL_INLINE void cpu_relax() noexcept
+{
+#if defined(__i386__) || defined(__x86_64__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+  asm volatile("yield" ::: "memory");
+#else
+  std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+}
+
+} // namespace detail
+} // namespace gpcl
+
+#endif // GPCL_POSIX
+
+#ifdef GPCL_HEADER_ONLY
+#  include <gpcl/detail/impl/futex.ipp>
+#endif
+
+#endif // GPCL_DETAIL_FUTEX_HPP
@@ -0,0 +1,90 @@
+//
+// futex_mutex.hpp
+// ~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2020 Zhengyi Fu (tsingyat at outlook dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef GPCL_DETAIL_FUTEX_MUTEX_HPP
+#define GPCL_DETAIL_FUTEX_MUTEX_HPP
+
+#include <gpcl/detail/config.hpp>
+#include <gpcl/detail/futex.hpp>
+#include <atomic>
+#include <cstdint>
+
+#ifdef GPCL_POSIX
+
+namespace gpcl {
+namespace detail {
+
+// A process-private mutex on a futex word, after "Futexes Are Tricky" by
+// Ulrich Drepper. The word is 0 when unlocked, 1 when locked and 2 when
+// locked with possible sleepers, so that an uncontended lock and unlock
+// are each a single atomic instruction.
+class futex_mutex
+{
+public:
+  enum : std::uint32_t
+  {
+    unlocked = 0,
+    locked = 1,
+    contended = 2
+  };
+
+  constexpr futex_mutex() noexcept = default;
+
+  futex_mutex(const futex_mutex &) = delete;
+  futex_mutex &operator=(const futex_mutex &) = delete;
+
+  void lock() noexcept
+  {
+    std::uint32_t s = unlocked;
+    if (!word_.compare_exchange_strong(s, locked, std::memory_order_acquire,
+                                       std::memory_order_relaxed))
+      lock_slow();
+  }
+
+  bool try_lock() noexcept
+  {
+    std::uint32_t s = unlocked;
+    return word_.compare_exchange_strong(s, locked, std::memory_order_acquire,
+                                         std::memory_order_relaxed);
+  }
+
+  void unlock() noexcept
+  {
+    if (word_.exchange(unlocked, std::memory_order_release) == contended)
+      futex_wake(word_, 1, false);
+  }
+
+  // Locks the mutex as if there were sleepers. Threads that a condition
+  // variable requeued onto the word lock it this way, so that each unlock
+  // wakes the next of them.
+  GPCL_DECL void lock_contended() noexcept;
+
+  futex_word *native_handle() noexcept { return &word_; }
+
+private:
+  // Spins for a while, then sleeps until the mutex is unlocked.
+  GPCL_DECL void lock_slow() noexcept;
+
+  futex_word word_{unlocked};
+
+  // Running average of the spins that ended in taking the lock.
+  std::atomic<std::int32_t> spins_{0};
+};
+
+} // namespace detail
+} // namespace gpcl
+
+#endif // GPCL_POSIX
+
+#ifdef GPCL_HEADER_ONLY
+#  include <gpcl/detail/impl/futex_mutex.ipp>
+#endif
+
+#endif // GPCL_DETAIL_FUTEX_MUTEX_HPP
@@ -0,0 +1,72 @@
+//
+// futex.ipp
+// ~~~~~~~~~
+//
+// Copyright (c) 2020 Zhengyi Fu (tsingyat at outlook dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef GPCL_DETAIL_IMPL_FUTEX_IPP
+#define GPCL_DETAIL_IMPL_FUTEX_IPP
+
+#include <gpcl/detail/futex.hpp>
+
+#ifdef GPCL_POSIX
+
+#include <cerrno>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace gpcl {
+namespace detail {
+
+int futex_wait(futex_word &word, std::uint32_t expected,
+               const struct timespec *timeout, bool process_shared) noexcept
+{
+  int op = process_shared ? FUTEX_WAIT : FUTEX_WAIT_PRIVATE;
+  if (::syscall(SYS_futex, reinterpret_cast<std::uint32_t *>(&word), op,
+                expected, timeout, nullptr, 0) == -1)
+    return errno;
+  return 0;
+}
+
+int futex_wait_until(futex_word &word, std::uint32_t expected,
+                     const struct timespec *deadline,
+                     bool process_shared) noexcept
+{
+  int op = process_shared ? FUTEX_WAIT_BITSET : FUTEX_WAIT_BITSET_PRIVATE;
+  if (::syscall(SYS_futex, reinterpret_cast<std::uint32_t *>(&word), op,
+                expected, deadline, nullptr, FUTEX_BITSET_MATCH_ANY) == -1)
+    return errno;
+  return 0;
+}
+
+int futex_wake(futex_word &word, int n, bool process_shared) noexcept
+{
+  int op = process_shared ? FUTEX_WAKE : FUTEX_WAKE_PRIVATE;
+  long woken = ::syscall(SYS_futex, reinterpret_cast<std::uint32_t *>(&word),
+                         op, n, nullptr, nullptr, 0);
+  return woken < 0 ? 0 : static_cast<int>(woken);
+}
+
+int futex_requeue(futex_word &from, std::uint32_t expected, int wake,
+                  int requeue, futex_word &to, bool process_shared) noexcept
+{
+  int op = process_shared ? FUTEX_CMP_REQUEUE : FUTEX_CMP_REQUEUE_PRIVATE;
+  // The timeout argument carries the number of threads to requeue.
+  if (::syscall(SYS_futex, reinterpret_cast<std::uint32_t *>(&from), op, wake,
+                reinterpret_cast<void *>(static_cast<long>(requeue)),
+                reinterpret_cast<std::uint32_t *>(&to), expected) == -1)
+    return errno;
+  return 0;
+}
+
+} // namespace detail
+} // namespace gpcl
+
+#endif // GPCL_POSIX
+
+#endif // GPCL_DETAIL_IMPL_FUTEX_IPP
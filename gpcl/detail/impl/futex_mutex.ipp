@@ -0,0 +1,71 @@
+//
+// futex_mutex.ipp
+// ~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2020 Zhengyi Fu (tsingyat at outlook dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef GPCL_DETAIL_IMPL_FUTEX_MUTEX_IPP
+#define GPCL_DETAIL_IMPL_FUTEX_MUTEX_IPP
+
+#include <gpcl/detail/futex_mutex.hpp>
+
+#ifdef GPCL_POSIX
+
+#include <algorithm>
+
+namespace gpcl {
+namespace detail {
+
+namespace futex_detail {
+
+// Bounds of the adaptive spin, in attempts to take the lock.
+constexpr std::int32_t min_spins = 10;
+constexpr std::int32_t max_spins = 100;
+
+} // namespace futex_detail
+
+void futex_mutex::lock_slow() noexcept
+{
+  // Spin only while the owner is likely to unlock soon: up to twice as
+  // long as it took recently, like glibc's adaptive mutexes.
+  std::int32_t avg = spins_.load(std::memory_order_relaxed);
+  std::int32_t limit =
+      (std::min)(futex_detail::max_spins, avg * 2 + futex_detail::min_spins);
+  std::int32_t n = 0;
+  for (; n < limit; ++n)
+  {
+    std::uint32_t s = word_.load(std::memory_order_relaxed);
+    if (s == contended)
+      break; // Others sleep already; do not barge ahead of them.
+    if (s == unlocked &&
+        word_.compare_exchange_weak(s, locked, std::memory_order_acquire,
+                                    std::memory_order_relaxed))
+    {
+      spins_.store(avg + (n - avg) / 8, std::memory_order_relaxed);
+      return;
+    }
+    cpu_relax();
+  }
+  spins_.store(avg + (n - avg) / 8, std::memory_order_relaxed);
+
+  lock_contended();
+}
+
+void futex_mutex::lock_contended() noexcept
+{
+  // Marking the word contended makes the unlock that we wait for wake the
+  // next sleeper as well.
+  while (word_.exchange(contended, std::memory_order_acquire) != unlocked)
+    futex_wait(word_, contended, nullptr, false);
+}
+
+} // namespace detail
+} // namespace gpcl
+
+#endif // GPCL_POSIX
+
+#endif // GPCL_DETAIL_IMPL_FUTEX_MUTEX_IPP
@@ -0,0 +1,125 @@
+//
+// percpu_rwlock.ipp
+// ~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2020 Zhengyi Fu (tsingyat at outlook dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef GPCL_DETAIL_IMPL_PERCPU_RWLOCK_IPP
+#define GPCL_DETAIL_IMPL_PERCPU_RWLOCK_IPP
+
+#include <gpcl/detail/percpu_rwlock.hpp>
+
+#ifdef GPCL_POSIX
+
+#include <climits>
+#include <sched.h>
+#include <unistd.h>
+
+namespace gpcl {
+namespace detail {
+
+namespace percpu_detail {
+
+// Attempts to find the readers drained before sleeping until they are.
+constexpr int drain_spins = 100;
+
+} // namespace percpu_detail
+
+percpu_rwlock::percpu_rwlock(std::size_t slots)
+{
+  if (slots == 0)
+  {
+    long n = ::sysconf(_SC_NPROCESSORS_CONF);
+    slots = n > 0 ? static_cast<std::size_t>(n) : 1;
+  }
+  nslots_ = slots;
+  slots_.reset(new slot[slots]);
+}
+
+void percpu_rwlock::lock() noexcept
+{
+  writers_.lock();
+  writer_.store(writing);
+
+  int spins = 0;
+  while (!drained())
+  {
+    if (spins < percpu_detail::drain_spins)
+    {
+      ++spins;
+      cpu_relax();
+      continue;
+    }
+    std::uint32_t seq = drain_seq_.load();
+    if (drained())
+      break;
+    futex_wait(drain_seq_, seq, nullptr, false);
+  }
+}
+
+bool percpu_rwlock::try_lock() noexcept
+{
+  if (!writers_.try_lock())
+    return false;
+  writer_.store(writing);
+  if (drained())
+    return true;
+  unlock();
+  return false;
+}
+
+void percpu_rwlock::unlock() noexcept
+{
+  if (writer_.exchange(no_writer) == writing_with_waiters)
+    futex_wake(writer_, INT_MAX, false);
+  writers_.unlock();
+}
+
+unsigned percpu_rwlock::current_cpu() noexcept
+{
+  int cpu = ::sched_getcpu();
+  return cpu < 0 ? 0 : static_cast<unsigned>(cpu);
+}
+
+void percpu_rwlock::lock_shared_slow(slot &s) noexcept
+{
+  do
+  {
+    leave(s);
+    std::uint32_t w = writer_.load();
+    while (w != no_writer)
+    {
+      if (w == writing &&
+          !writer_.compare_exchange_weak(w, writing_with_waiters))
+        continue;
+      futex_wait(writer_, writing_with_waiters, nullptr, false);
+      w = writer_.load();
+    }
+    s.readers.fetch_add(1);
+  } while (writer_.load() != no_writer);
+}
+
+void percpu_rwlock::notify_writer() noexcept
+{
+  drain_seq_.fetch_add(1);
+  futex_wake(drain_seq_, 1, false);
+}
+
+bool percpu_rwlock::drained() const noexcept
+{
+  for (std::size_t i = 0; i < nslots_; ++i)
+    if (slots_[i].readers.load() != 0)
+      return false;
+  return true;
+}
+
+} // namespace detail
+} // namespace gpcl
+
+#endif // GPCL_POSIX
+
+#endif // GPCL_DETAIL_IMPL_PERCPU_RWLOCK_IPP
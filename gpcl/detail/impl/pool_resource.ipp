@@ -0,0 +1,158 @@
+//
+// pool_resource.ipp
+// ~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2020 Zhengyi Fu (tsingyat at outlook dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef GPCL_DETAIL_IMPL_POOL_RESOURCE_IPP
+#define GPCL_DETAIL_IMPL_POOL_RESOURCE_IPP
+
+#include <gpcl/detail/pool_resource.hpp>
+#include <gpcl/pmr/memory_resource.hpp>
+#include <algorithm>
+
+namespace gpcl {
+namespace detail {
+
+pmr::pool_options normalize_pool_options(pmr::pool_options opts)
+{
+  if (opts.max_blocks_per_chunk == 0)
+    opts.max_blocks_per_chunk = pool_resource_default_blocks_per_chunk;
+  opts.max_blocks_per_chunk =
+      (std::min)(opts.max_blocks_per_chunk, pool_resource_max_blocks_per_chunk);
+
+  if (opts.largest_required_pool_block == 0)
+    opts.largest_required_pool_block = pool_resource_default_largest_block;
+  opts.largest_required_pool_block =
+      (std::min)(opts.largest_required_pool_block,
+                 pool_resource_max_largest_block);
+
+  std::size_t largest = pool_resource_min_block;
+  while (largest < opts.largest_required_pool_block)
+    largest *= 2;
+  opts.largest_required_pool_block = largest;
+  return opts;
+}
+
+std::size_t pool_size_class_count(const pmr::pool_options &opts)
+{
+  return pool_size_class_index(opts.largest_required_pool_block, 1) + 1;
+}
+
+void pool_size_class::configure(std::size_t block_size,
+                                std::size_t max_blocks_per_chunk)
+{
+  GPCL_ASSERT(chunks_ == nullptr);
+  GPCL_ASSERT(block_size >= pool_resource_min_block);
+  GPCL_ASSERT(max_blocks_per_chunk != 0);
+
+  block_size_ = block_size;
+  max_blocks_ = max_blocks_per_chunk;
+
+  // Start with about a page worth of blocks.
+  next_blocks_ = (std::max)(std::size_t(1), 4096 / block_size);
+  next_blocks_ = (std::min)(next_blocks_, max_blocks_);
+}
+
+std::size_t pool_size_class::allocate_batch(pmr::memory_resource *upstream,
+                                            std::size_t n, void *&first)
+{
+  GPCL_ASSERT(n != 0);
+  if (storage_.empty())
+    replenish(upstream);
+  return storage_.malloc_batch(n, first);
+}
+
+void pool_size_class::release(pmr::memory_resource *upstream) noexcept
+{
+  while (chunks_)
+  {
+    chunk_header *next = chunks_->next;
+    std::size_t blocks = chunks_->blocks;
+    void *chunk = reinterpret_cast<char *>(chunks_) - blocks * block_size_;
+    upstream->deallocate(chunk, blocks * block_size_ + sizeof(chunk_header),
+                         chunk_alignment());
+    chunks_ = next;
+  }
+  storage_.clear();
+}
+
+void pool_size_class::replenish(pmr::memory_resource *upstream)
+{
+  GPCL_ASSERT(block_size_ != 0);
+
+  // The header is placed after the blocks so that the first block keeps the
+  // alignment of the chunk.
+  std::size_t blocks = next_blocks_;
+  char *chunk = static_cast<char *>(upstream->allocate(
+      blocks * block_size_ + sizeof(chunk_header), chunk_alignment()));
+
+  auto *header = reinterpret_cast<chunk_header *>(chunk + blocks * block_size_);
+  header->next = chunks_;
+  header->blocks = blocks;
+  chunks_ = header;
+
+  storage_.add_block(chunk, blocks * block_size_, block_size_);
+  next_blocks_ = (std::min)(next_blocks_ * 2, max_blocks_);
+}
+
+std::size_t pool_size_class::chunk_alignment() const noexcept
+{
+  return (std::max)(alignof(std::max_align_t),
+                    (std::min)(block_size_, pool_resource_max_block_alignment));
+}
+
+void *oversized_list::allocate(pmr::memory_resource *upstream,
+                               std::size_t bytes, std::size_t alignment)
+{
+  alignment = (std::max)(alignment, alignof(header));
+  auto *p = static_cast<char *>(
+      upstream->allocate(header_offset(bytes) + sizeof(header), alignment));
+
+  auto *h = reinterpret_cast<header *>(p + header_offset(bytes));
+  *h = header{nullptr, head_, p, bytes, alignment};
+  if (head_)
+    head_->prev = h;
+  head_ = h;
+  return p;
+}
+
+void oversized_list::deallocate(pmr::memory_resource *upstream, void *p,
+                                std::size_t bytes,
+                                std::size_t alignment) noexcept
+{
+  (void)alignment;
+  auto *h =
+      reinterpret_cast<header *>(static_cast<char *>(p) + header_offset(bytes));
+  GPCL_ASSERT(h->ptr == p && h->bytes == bytes);
+
+  if (h->prev)
+    h->prev->next = h->next;
+  else
+    head_ = h->next;
+  if (h->next)
+    h->next->prev = h->prev;
+
+  upstream->deallocate(p, header_offset(bytes) + sizeof(header),
+                       h->alignment);
+}
+
+void oversized_list::release(pmr::memory_resource *upstream) noexcept
+{
+  while (head_)
+  {
+    header h = *head_;
+    upstream->deallocate(h.ptr, header_offset(h.bytes) + sizeof(header),
+                         h.alignment);
+    head_ = h.next;
+  }
+}
+
+} // namespace detail
+} // namespace gpcl
+
+#endif // GPCL_DETAIL_IMPL_POOL_RESOURCE_IPP
@@ -56,9 +56,27 @@ bool posix_condition_variable::wait_until(gpcl::unique_lock<posix_normal_mutex>
   return false;
 }
 
+bool posix_condition_variable::wait_until(
+    gpcl::unique_lock<posix_normal_mutex> &lock, const instant &deadline) {
+  GPCL_ASSERT(lock.owns_lock());
+  const auto ts = to_timespec(deadline);
+  int err = ::pthread_cond_clockwait(&cond_, lock.mutex().native_handle(),
+                                     CLOCK_MONOTONIC, &ts);
+
+  if (err == ETIMEDOUT)
+    return true;
+
+  if (err)
+    throw_system_error(err, "pthread_cond_clockwait");
+
+  return false;
+}
+
+// Waits on CLOCK_MONOTONIC, so that setting the system clock does not
+// shorten or lengthen the wait.
 bool posix_condition_variable::wait_for(
     gpcl::unique_lock<posix_normal_mutex> &lock, const duration &rel_time) {
-  return wait_until(lock, system_time::now().checked_add(rel_time));
+  return wait_until(lock, instant::now().saturating_add(rel_time));
 }
 
 void posix_condition_variable::notify_one() {
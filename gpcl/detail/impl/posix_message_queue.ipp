@@ -20,14 +20,33 @@ namespace detail {
 
 using namespace std::string_literals;
 
+namespace mq_detail {
+
+GPCL_DECL_INLINE int open_flags(queue_mode mode) {
+  return O_RDWR | (mode == queue_mode::non_blocking ? O_NONBLOCK : 0);
+}
+
+// Translates a monotonic deadline to the system clock, which is the only
+// clock mq_timedsend() and mq_timedreceive() take. Waits are cut into days
+// so that far deadlines do not overflow.
+GPCL_DECL_INLINE system_time realtime_deadline(const instant &deadline) {
+  const duration day = duration::from_secs(24 * 60 * 60);
+  duration left = deadline.saturating_duration_since(instant::now());
+  return system_time::now().checked_add(left < day ? left : day);
+}
+
+} // namespace mq_detail
+
 posix_message_queue::posix_message_queue(create_only_t, czstring<> name,
                                          std::size_t maxmsg,
-                                         std::size_t msgsize) {
+                                         std::size_t msgsize,
+                                         queue_mode mode) {
   mq_attr attr;
   attr.mq_maxmsg = maxmsg;
   attr.mq_msgsize = msgsize;
 
-  this->q_ = mq_open(name, O_RDWR | O_CREAT | O_EXCL, 0666, &attr);
+  this->q_ = mq_open(name, mq_detail::open_flags(mode) | O_CREAT | O_EXCL,
+                     0666, &attr);
   if (this->q_ == -1) {
     throw_system_error(__PRETTY_FUNCTION__);
   }
@@ -35,19 +54,22 @@ posix_message_queue::posix_message_queue(create_only_t, czstring<> name,
 
 posix_message_queue::posix_message_queue(open_or_create_t, czstring<> name,
                                          std::size_t maxmsg,
-                                         std::size_t msgsize) {
+                                         std::size_t msgsize,
+                                         queue_mode mode) {
   mq_attr attr;
   attr.mq_maxmsg = maxmsg;
   attr.mq_msgsize = msgsize;
 
-  this->q_ = mq_open(name, O_RDWR | O_CREAT, 0666, &attr);
+  this->q_ =
+      mq_open(name, mq_detail::open_flags(mode) | O_CREAT, 0666, &attr);
   if (this->q_ == -1) {
     throw_system_error(__PRETTY_FUNCTION__);
   }
 }
 
-posix_message_queue::posix_message_queue(open_only_t, czstring<> name) {
-  this->q_ = mq_open(name, O_RDWR);
+posix_message_queue::posix_message_queue(open_only_t, czstring<> name,
+                                         queue_mode mode) {
+  this->q_ = mq_open(name, mq_detail::open_flags(mode));
   if (this->q_ == -1) {
     throw_system_error(__PRETTY_FUNCTION__);
   }
@@ -79,6 +101,11 @@ void posix_message_queue::send(gpcl::span<const char> msg, unsigned int prio,
 
 std::size_t posix_message_queue::receive(gpcl::span<char> msg,
                                          std::error_code &ec) {
+  return receive_message(msg, ec).size();
+}
+
+received_message posix_message_queue::receive_message(gpcl::span<char> msg,
+                                                      std::error_code &ec) {
   GPCL_ASSERT(q_ != -1);
   unsigned int prio{};
   ssize_t len = mq_receive(q_, msg.data(), msg.size_bytes(), &prio);
@@ -87,7 +114,115 @@ std::size_t posix_message_queue::receive(gpcl::span<char> msg,
     return {};
   }
   ec.clear();
-  return len;
+  return {msg.subspan(0, len), prio};
+}
+
+void posix_message_queue::timed_send(gpcl::span<const char> msg,
+                                     unsigned int prio,
+                                     const system_time &deadline,
+                                     std::error_code &ec) {
+  GPCL_ASSERT(q_ != -1);
+  timespec ts = deadline.duration_since_epoch().to_timespec();
+  if (-1 == mq_timedsend(q_, msg.data(), msg.size_bytes(), prio, &ts)) {
+    return ec.assign(errno, std::system_category());
+  }
+  return ec.clear();
+}
+
+received_message
+posix_message_queue::timed_receive(gpcl::span<char> msg,
+                                   const system_time &deadline,
+                                   std::error_code &ec) {
+  GPCL_ASSERT(q_ != -1);
+  timespec ts = deadline.duration_since_epoch().to_timespec();
+  unsigned int prio{};
+  ssize_t len = mq_timedreceive(q_, msg.data(), msg.size_bytes(), &prio, &ts);
+  if (-1 == len) {
+    ec.assign(errno, std::system_category());
+    return {};
+  }
+  ec.clear();
+  return {msg.subspan(0, len), prio};
+}
+
+// If the system clock jumps ahead, the translated deadline expires early;
+// retry until the monotonic one has passed too.
+void posix_message_queue::timed_send(gpcl::span<const char> msg,
+                                     unsigned int prio,
+                                     const instant &deadline,
+                                     std::error_code &ec) {
+  do {
+    timed_send(msg, prio, mq_detail::realtime_deadline(deadline), ec);
+  } while (ec == std::errc::timed_out && instant::now() < deadline);
+}
+
+received_message
+posix_message_queue::timed_receive(gpcl::span<char> msg,
+                                   const instant &deadline,
+                                   std::error_code &ec) {
+  received_message m;
+  do {
+    m = timed_receive(msg, mq_detail::realtime_deadline(deadline), ec);
+  } while (ec == std::errc::timed_out && instant::now() < deadline);
+  return m;
+}
+
+std::size_t
+posix_message_queue::receive_batch(gpcl::span<const gpcl::span<char>> bufs,
+                                   gpcl::span<received_message> msgs,
+                                   std::error_code &ec) {
+  GPCL_ASSERT(q_ != -1);
+  GPCL_ASSERT(bufs.size() <= msgs.size());
+  if (bufs.empty()) {
+    ec.clear();
+    return 0;
+  }
+
+  msgs[0] = receive_message(bufs[0], ec);
+  if (ec) {
+    return 0;
+  }
+
+  // A deadline in the past makes mq_timedreceive fail with ETIMEDOUT rather
+  // than wait once the queue is empty, whatever the mode of the queue.
+  const timespec past{};
+  std::size_t n = 1;
+  for (; n < bufs.size(); ++n) {
+    unsigned int prio{};
+    ssize_t len = mq_timedreceive(q_, bufs[n].data(), bufs[n].size_bytes(),
+                                  &prio, &past);
+    if (-1 == len) {
+      break;
+    }
+    msgs[n] = {bufs[n].subspan(0, len), prio};
+  }
+  return n;
+}
+
+void posix_message_queue::attributes(mq_attr &attr,
+                                     std::error_code &ec) const {
+  GPCL_ASSERT(q_ != -1);
+  if (-1 == mq_getattr(q_, &attr)) {
+    return ec.assign(errno, std::system_category());
+  }
+  return ec.clear();
+}
+
+queue_mode posix_message_queue::mode(std::error_code &ec) const {
+  mq_attr attr{};
+  attributes(attr, ec);
+  return (attr.mq_flags & O_NONBLOCK) ? queue_mode::non_blocking
+                                      : queue_mode::blocking;
+}
+
+void posix_message_queue::set_mode(queue_mode mode, std::error_code &ec) {
+  GPCL_ASSERT(q_ != -1);
+  mq_attr attr{};
+  attr.mq_flags = mode == queue_mode::non_blocking ? O_NONBLOCK : 0;
+  if (-1 == mq_setattr(q_, &attr, nullptr)) {
+    return ec.assign(errno, std::system_category());
+  }
+  return ec.clear();
 }
 
 } // namespace detail
@@ -0,0 +1,265 @@
+//
+// posix_mpsc_channel.ipp
+// ~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2020 Zhengyi Fu (tsingyat at outlook dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef GPCL_DETAIL_IMPL_POSIX_MPSC_CHANNEL_IPP
+#define GPCL_DETAIL_IMPL_POSIX_MPSC_CHANNEL_IPP
+
+#include <gpcl/detail/posix_mpsc_channel.hpp>
+
+#ifdef GPCL_POSIX
+
+#include <gpcl/assert.hpp>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+
+namespace gpcl {
+namespace detail {
+
+namespace mpsc {
+
+constexpr std::uint32_t magic = 0x67706d63; // "gpmc"
+
+// Smallest capacity; a channel must hold at least one non-empty record.
+constexpr std::size_t min_capacity = 64;
+
+GPCL_DECL_INLINE std::uint64_t round_up(std::uint64_t n, std::uint64_t align)
+{
+  return (n + align - 1) / align * align;
+}
+
+} // namespace mpsc
+
+posix_mpsc_channel::posix_mpsc_channel(create_only_t, czstring<> name,
+                                       std::size_t capacity)
+    : shm_(create_only, name, shm_size(capacity))
+{
+  init();
+}
+
+posix_mpsc_channel::posix_mpsc_channel(open_or_create_t, czstring<> name,
+                                       std::size_t capacity)
+    : shm_(open_or_create, name, shm_size(capacity))
+{
+  init();
+}
+
+posix_mpsc_channel::posix_mpsc_channel(open_only_t, czstring<> name)
+    : shm_(open_only, name)
+{
+  init();
+}
+
+std::size_t posix_mpsc_channel::shm_size(std::size_t capacity) noexcept
+{
+  std::size_t n = mpsc::min_capacity;
+  while (n < capacity)
+    n *= 2;
+  return data_offset + n;
+}
+
+void posix_mpsc_channel::init()
+{
+  channel_header *h = header();
+  if (shm_.created())
+  {
+    // A new shared memory object is zero-filled, and so is the length of
+    // every record header.
+    h->capacity = shm_.size() - data_offset;
+    h->magic.store(mpsc::magic, std::memory_order_release);
+  }
+  else
+  {
+    wait_for_creator(
+        [h] { return h->magic.load(std::memory_order_acquire) == mpsc::magic; },
+        "posix_mpsc_channel: not initialized by creator");
+  }
+
+  GPCL_ASSERT(h->capacity != 0 && (h->capacity & (h->capacity - 1)) == 0);
+  mask_ = h->capacity - 1;
+  cached_read_pos_ = h->read_pos.load(std::memory_order_acquire);
+}
+
+mutable_buffer posix_mpsc_channel::try_reserve(std::size_t size,
+                                               std::error_code &ec)
+{
+  GPCL_ASSERT(!reserved());
+  ec.clear();
+  if (size > max_msg_size())
+  {
+    ec.assign(EMSGSIZE, std::system_category());
+    return {};
+  }
+
+  channel_header *h = header();
+  std::uint64_t length =
+      mpsc::round_up(sizeof(record_header) + size, record_align);
+  std::uint64_t pos = h->write_pos.load(std::memory_order_relaxed);
+  std::uint64_t to_end;
+  for (;;)
+  {
+    to_end = capacity() - (pos & mask_);
+    std::uint64_t needed = length <= to_end ? length : to_end + length;
+    if (pos + needed - cached_read_pos_ > capacity())
+    {
+      cached_read_pos_ = h->read_pos.load(std::memory_order_acquire);
+      if (cached_read_pos_ > pos)
+      {
+        // Other producers and the consumer have moved past pos since it
+        // was read; the distance above wrapped around.
+        pos = h->write_pos.load(std::memory_order_relaxed);
+        continue;
+      }
+      if (pos + needed - cached_read_pos_ > capacity())
+        return {};
+    }
+    if (h->write_pos.compare_exchange_weak(pos, pos + needed,
+                                           std::memory_order_relaxed))
+      break;
+  }
+
+  if (length > to_end)
+  {
+    record_header *pad = record_at(pos);
+    pad->size = padding_record;
+    publish(pad, static_cast<std::uint32_t>(to_end));
+    pos += to_end;
+  }
+
+  reserved_ = record_at(pos);
+  reserved_length_ = static_cast<std::uint32_t>(length);
+  return mutable_buffer(reinterpret_cast<char *>(reserved_ + 1), size);
+}
+
+mutable_buffer posix_mpsc_channel::reserve(std::size_t size,
+                                           std::error_code &ec)
+{
+  for (;;)
+  {
+    mutable_buffer buf = try_reserve(size, ec);
+    if (buf.data() || ec)
+      return buf;
+    wait_for_space();
+  }
+}
+
+void posix_mpsc_channel::commit(std::size_t size) noexcept
+{
+  GPCL_ASSERT(reserved());
+  GPCL_ASSERT(sizeof(record_header) + size <= reserved_length_);
+  reserved_->size = static_cast<std::uint32_t>(size);
+  publish(std::exchange(reserved_, nullptr), reserved_length_);
+}
+
+const_buffer posix_mpsc_channel::try_peek() noexcept
+{
+  channel_header *h = header();
+  std::uint64_t pos = h->read_pos.load(std::memory_order_relaxed);
+  record_header *rec = record_at(pos);
+  std::uint32_t length = rec->length.load(std::memory_order_acquire);
+  if (length == 0)
+    return {};
+
+  peeked_length_ = length;
+  if (rec->size == padding_record)
+  {
+    rec = record_at(pos + length);
+    std::uint32_t next = rec->length.load(std::memory_order_acquire);
+    if (next == 0)
+    {
+      // Skip the padding record now rather than looking at it again.
+      release();
+      return {};
+    }
+    peeked_length_ += next;
+  }
+  return const_buffer(reinterpret_cast<const char *>(rec + 1), rec->size);
+}
+
+const_buffer posix_mpsc_channel::peek() noexcept
+{
+  for (;;)
+  {
+    const_buffer buf = try_peek();
+    if (buf.data())
+      return buf;
+    wait_for_data();
+  }
+}
+
+void posix_mpsc_channel::release() noexcept
+{
+  GPCL_ASSERT(peeked());
+  channel_header *h = header();
+  std::uint64_t pos = h->read_pos.load(std::memory_order_relaxed);
+
+  // The producers rely on the released space being zero-filled. The
+  // padding record and the record after it are never split by the end of
+  // the buffer.
+  std::uint64_t index = pos & mask_;
+  std::uint64_t first = (std::min)(peeked_length_, capacity() - index);
+  std::memset(static_cast<void *>(record_at(pos)), 0, first);
+  if (first != peeked_length_)
+    std::memset(static_cast<void *>(record_at(0)), 0, peeked_length_ - first);
+
+  // Sequentially consistent, so that either a waiting producer sees the
+  // new position or this sees its waiting flag.
+  h->read_pos.store(pos + std::exchange(peeked_length_, 0));
+  if (h->producers_waiting.load() != 0 &&
+      h->producers_waiting.exchange(0) != 0)
+  {
+    h->read_seq.fetch_add(1);
+    futex_wake(h->read_seq, INT_MAX);
+  }
+}
+
+void posix_mpsc_channel::publish(record_header *rec,
+                                 std::uint32_t length) noexcept
+{
+  channel_header *h = header();
+  rec->length.store(length);
+  if (h->consumer_waiting.load() != 0 && h->consumer_waiting.exchange(0) != 0)
+  {
+    h->write_seq.fetch_add(1);
+    futex_wake(h->write_seq, 1);
+  }
+}
+
+void posix_mpsc_channel::wait_for_space() noexcept
+{
+  channel_header *h = header();
+  h->producers_waiting.store(1);
+  std::uint32_t seq = h->read_seq.load();
+  std::uint64_t pos = h->read_pos.load();
+  if (pos != cached_read_pos_)
+  {
+    cached_read_pos_ = pos;
+    return;
+  }
+  futex_wait(h->read_seq, seq);
+}
+
+void posix_mpsc_channel::wait_for_data() noexcept
+{
+  channel_header *h = header();
+  h->consumer_waiting.store(1);
+  std::uint32_t seq = h->write_seq.load();
+  std::uint64_t pos = h->read_pos.load(std::memory_order_relaxed);
+  if (record_at(pos)->length.load() != 0)
+    return;
+  futex_wait(h->write_seq, seq);
+}
+
+} // namespace detail
+} // namespace gpcl
+
+#endif // GPCL_POSIX
+
+#endif // GPCL_DETAIL_IMPL_POSIX_MPSC_CHANNEL_IPP
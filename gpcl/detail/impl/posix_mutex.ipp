@@ -52,7 +52,7 @@ int posix_mutex_attr::priority_ceiling() const noexcept {
 
 void posix_mutex_attr::priority_ceiling(int prio) noexcept {
   int err = ::pthread_mutexattr_setprioceiling(&attr_, prio);
-  GPCL_VERIFY(err);
+  GPCL_VERIFY(!err);
 }
 
 posix_mutex_robust posix_mutex_attr::robust() const noexcept {
@@ -79,6 +79,19 @@ void posix_mutex_attr::type(posix_mutex_type t) noexcept {
   GPCL_VERIFY(!err);
 }
 
+bool posix_mutex_attr::process_shared() const noexcept {
+  int pshared;
+  int err = ::pthread_mutexattr_getpshared(&attr_, &pshared);
+  GPCL_VERIFY(!err);
+  return pshared == PTHREAD_PROCESS_SHARED;
+}
+
+void posix_mutex_attr::process_shared(bool pshared) noexcept {
+  int err = ::pthread_mutexattr_setpshared(
+      &attr_, pshared ? PTHREAD_PROCESS_SHARED : PTHREAD_PROCESS_PRIVATE);
+  GPCL_VERIFY(!err);
+}
+
 posix_mutex_base::posix_mutex_base(const posix_mutex_attr &attr) {
   int err = ::pthread_mutex_init(&mtx_, attr.get());
   if (err)
@@ -113,7 +126,7 @@ bool posix_mutex_base::try_lock() {
 }
 
 bool posix_mutex_base::try_lock_for(realtime_clock::duration dur) {
-  return try_lock_until(realtime_clock::now() + dur);
+  return try_lock_until(deadline_after(dur));
 }
 
 bool posix_mutex_base::try_lock_until(realtime_clock::time_point tp) {
@@ -123,7 +136,40 @@ bool posix_mutex_base::try_lock_until(realtime_clock::time_point tp) {
     return false;
   if (err)
     throw_system_error(err, "pthread_mutex_timedlock");
-  return false;
+  return true;
+}
+
+bool posix_mutex_base::try_lock_until(const instant &deadline) {
+  const auto ts = to_timespec(deadline);
+  int err = pthread_mutex_clocklock(&mtx_, CLOCK_MONOTONIC, &ts);
+  if (err == ETIMEDOUT)
+    return false;
+  if (err)
+    throw_system_error(err, "pthread_mutex_clocklock");
+  return true;
+}
+
+void posix_interprocess_mutex::lock() {
+  int err = pthread_mutex_lock(&mtx_);
+  if (err == EOWNERDEAD) {
+    owner_died_ = true;
+    err = pthread_mutex_consistent(&mtx_);
+  }
+  if (err)
+    throw_system_error(err, "pthread_mutex_lock");
+}
+
+bool posix_interprocess_mutex::try_lock() {
+  int err = pthread_mutex_trylock(&mtx_);
+  if (err == EBUSY || err == EAGAIN)
+    return false;
+  if (err == EOWNERDEAD) {
+    owner_died_ = true;
+    err = pthread_mutex_consistent(&mtx_);
+  }
+  if (err)
+    throw_system_error(err, "pthread_mutex_trylock");
+  return true;
 }
 
 } // namespace detail
@@ -0,0 +1,95 @@
+//
+// posix_numa.ipp
+// ~~~~~~~~~~~~~~
+//
+// Copyright (c) 2020 Zhengyi Fu (tsingyat at outlook dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef GPCL_DETAIL_IMPL_POSIX_NUMA_IPP
+#define GPCL_DETAIL_IMPL_POSIX_NUMA_IPP
+
+#include <gpcl/detail/posix_numa.hpp>
+
+#ifdef GPCL_POSIX
+
+#include <gpcl/assert.hpp>
+#include <cerrno>
+#include <climits>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace gpcl {
+namespace detail {
+
+namespace numa_abi {
+
+// From <linux/mempolicy.h>.
+constexpr int mpol_preferred = 1;
+constexpr int mpol_bind = 2;
+constexpr unsigned long mpol_f_node = 1 << 0;
+constexpr unsigned long mpol_f_addr = 1 << 1;
+constexpr unsigned long mpol_f_mems_allowed = 1 << 2;
+
+constexpr int bits_per_word = sizeof(unsigned long) * CHAR_BIT;
+constexpr int mask_words = numa_max_nodes / bits_per_word;
+
+} // namespace numa_abi
+
+int numa_node_count() noexcept
+{
+  unsigned long mask[numa_abi::mask_words] = {};
+  if (::syscall(SYS_get_mempolicy, nullptr, mask, numa_max_nodes, nullptr,
+                numa_abi::mpol_f_mems_allowed) != 0)
+    return 1;
+
+  for (int word = numa_abi::mask_words - 1; word >= 0; --word)
+  {
+    if (mask[word])
+      return word * numa_abi::bits_per_word +
+             (numa_abi::bits_per_word - __builtin_clzl(mask[word]));
+  }
+  return 1;
+}
+
+int numa_current_node() noexcept
+{
+  unsigned cpu = 0;
+  unsigned node = 0;
+  if (::syscall(SYS_getcpu, &cpu, &node, nullptr) != 0)
+    return 0;
+  return static_cast<int>(node);
+}
+
+int numa_node_of(const void *p) noexcept
+{
+  int node = -1;
+  if (::syscall(SYS_get_mempolicy, &node, nullptr, 0, p,
+                numa_abi::mpol_f_node | numa_abi::mpol_f_addr) != 0)
+    return -1;
+  return node;
+}
+
+int numa_bind(void *p, std::size_t size, int node, bool strict) noexcept
+{
+  GPCL_ASSERT(node >= 0 && node < numa_max_nodes);
+
+  unsigned long mask[numa_abi::mask_words] = {};
+  mask[node / numa_abi::bits_per_word] |= 1UL
+                                          << (node % numa_abi::bits_per_word);
+
+  // The kernel reads one bit less than maxnode.
+  int mode = strict ? numa_abi::mpol_bind : numa_abi::mpol_preferred;
+  if (::syscall(SYS_mbind, p, size, mode, mask, node + 2, 0) != 0)
+    return errno;
+  return 0;
+}
+
+} // namespace detail
+} // namespace gpcl
+
+#endif // GPCL_POSIX
+
+#endif // GPCL_DETAIL_IMPL_POSIX_NUMA_IPP
@@ -10,6 +10,7 @@
 
 #include <gpcl/assert.hpp>
 #include <gpcl/detail/error.hpp>
+#include <gpcl/detail/posix_clock.hpp>
 #include <gpcl/detail/posix_semaphore.hpp>
 
 #ifdef GPCL_POSIX
@@ -54,6 +55,17 @@ bool posix_semaphore::try_wait() {
   return true;
 }
 
+bool posix_semaphore::try_wait_until(const instant &deadline) {
+  const auto ts = to_timespec(deadline);
+  while (-1 == ::sem_clockwait(&sem_, CLOCK_MONOTONIC, &ts)) {
+    if (errno == ETIMEDOUT)
+      return false;
+    if (errno != EINTR)
+      throw_system_error("sem_clockwait");
+  }
+  return true;
+}
+
 } // namespace detail
 } // namespace gpcl
 
@@ -0,0 +1,138 @@
+//
+// posix_shared_memory.ipp
+// ~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2020 Zhengyi Fu (tsingyat at outlook dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef GPCL_DETAIL_IMPL_POSIX_SHARED_MEMORY_IPP
+#define GPCL_DETAIL_IMPL_POSIX_SHARED_MEMORY_IPP
+
+#include <gpcl/detail/posix_shared_memory.hpp>
+
+#ifdef GPCL_POSIX
+
+#include <gpcl/assert.hpp>
+#include <gpcl/detail/unique_file_descriptor.hpp>
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace gpcl {
+namespace detail {
+
+posix_shared_memory::posix_shared_memory(create_only_t, czstring<> name,
+                                         std::size_t size)
+{
+  int fd = ::shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0666);
+  if (fd == -1)
+    throw_system_error("shm_open");
+  create(fd, name, size);
+}
+
+posix_shared_memory::posix_shared_memory(open_or_create_t, czstring<> name,
+                                         std::size_t size)
+{
+  for (;;)
+  {
+    int fd = ::shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0666);
+    if (fd != -1)
+    {
+      create(fd, name, size);
+      return;
+    }
+    if (errno != EEXIST)
+      throw_system_error("shm_open");
+
+    // The object may be unlinked before it is opened; then try again.
+    fd = ::shm_open(name, O_RDWR, 0);
+    if (fd != -1)
+    {
+      open(fd);
+      return;
+    }
+    if (errno != ENOENT)
+      throw_system_error("shm_open");
+  }
+}
+
+posix_shared_memory::posix_shared_memory(open_only_t, czstring<> name)
+{
+  int fd = ::shm_open(name, O_RDWR, 0);
+  if (fd == -1)
+    throw_system_error("shm_open");
+  open(fd);
+}
+
+posix_shared_memory::~posix_shared_memory() noexcept
+{
+  if (addr_)
+    GPCL_VERIFY_0(::munmap(addr_, size_));
+}
+
+void posix_shared_memory::unlink(czstring<> name, std::error_code &ec)
+{
+  GPCL_ASSERT(name != nullptr);
+  if (::shm_unlink(name) == -1)
+    ec.assign(errno, std::system_category());
+  else
+    ec.clear();
+}
+
+void posix_shared_memory::create(int fd, czstring<> name, std::size_t size)
+{
+  GPCL_ASSERT(size != 0);
+  unique_file_descriptor guard(fd);
+  // Nobody could ever format an object left behind here, so remove it.
+  if (::ftruncate(fd, static_cast<off_t>(size)) == -1)
+  {
+    int err = errno;
+    ::shm_unlink(name);
+    throw_system_error(err, "ftruncate");
+  }
+  if (int err = map(fd, size))
+  {
+    ::shm_unlink(name);
+    throw_system_error(err, "mmap");
+  }
+  created_ = true;
+}
+
+void posix_shared_memory::open(int fd)
+{
+  unique_file_descriptor guard(fd);
+
+  // The creator sets the size right after creating the object.
+  struct stat st;
+  wait_for_creator(
+      [fd, &st] {
+        if (::fstat(fd, &st) == -1)
+          throw_system_error("fstat");
+        return st.st_size != 0;
+      },
+      "posix_shared_memory: size not set by creator");
+  if (int err = map(fd, static_cast<std::size_t>(st.st_size)))
+    throw_system_error(err, "mmap");
+}
+
+int posix_shared_memory::map(int fd, std::size_t size) noexcept
+{
+  void *p = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (p == MAP_FAILED)
+    return errno;
+  addr_ = p;
+  size_ = size;
+  return 0;
+}
+
+} // namespace detail
+} // namespace gpcl
+
+#endif // GPCL_POSIX
+
+#endif // GPCL_DETAIL_IMPL_POSIX_SHARED_MEMORY_IPP
@@ -0,0 +1,136 @@
+//
+// posix_shared_mutex.ipp
+// ~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2020 Zhengyi Fu (tsingyat at outlook dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include <gpcl/assert.hpp>
+#include <gpcl/detail/error.hpp>
+#include <gpcl/detail/posix_clock.hpp>
+#include <gpcl/detail/posix_shared_mutex.hpp>
+
+#ifdef GPCL_POSIX
+#include <pthread.h>
+
+namespace gpcl {
+namespace detail {
+
+posix_shared_mutex::posix_shared_mutex() {
+  pthread_rwlockattr_t attr;
+  int err = ::pthread_rwlockattr_init(&attr);
+  if (err)
+    throw_system_error(err, "pthread_rwlockattr_init");
+#ifdef __GLIBC__
+  GPCL_VERIFY_0(::pthread_rwlockattr_setkind_np(
+      &attr, PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP));
+#endif
+  err = ::pthread_rwlock_init(&rwlock_, &attr);
+  GPCL_VERIFY_0(::pthread_rwlockattr_destroy(&attr));
+  if (err)
+    throw_system_error(err, "pthread_rwlock_init");
+}
+
+posix_shared_mutex::~posix_shared_mutex() {
+  int err = ::pthread_rwlock_destroy(&rwlock_);
+  if (err)
+    print_error(err, "pthread_rwlock_destroy");
+}
+
+void posix_shared_mutex::lock() {
+  int err = ::pthread_rwlock_wrlock(&rwlock_);
+  if (err)
+    throw_system_error(err, "pthread_rwlock_wrlock");
+}
+
+void posix_shared_mutex::unlock() {
+  int err = ::pthread_rwlock_unlock(&rwlock_);
+  if (err)
+    throw_system_error(err, "pthread_rwlock_unlock");
+}
+
+bool posix_shared_mutex::try_lock() {
+  int err = ::pthread_rwlock_trywrlock(&rwlock_);
+  if (err == EBUSY)
+    return false;
+  if (err)
+    throw_system_error(err, "pthread_rwlock_trywrlock");
+  return true;
+}
+
+bool posix_shared_mutex::try_lock_for(realtime_clock::duration dur) {
+  return try_lock_until(deadline_after(dur));
+}
+
+bool posix_shared_mutex::try_lock_until(realtime_clock::time_point tp) {
+  const auto ts = to_timespec(tp.time_since_epoch());
+  int err = ::pthread_rwlock_timedwrlock(&rwlock_, &ts);
+  if (err == ETIMEDOUT)
+    return false;
+  if (err)
+    throw_system_error(err, "pthread_rwlock_timedwrlock");
+  return true;
+}
+
+bool posix_shared_mutex::try_lock_until(const instant &deadline) {
+  const auto ts = to_timespec(deadline);
+  int err = ::pthread_rwlock_clockwrlock(&rwlock_, CLOCK_MONOTONIC, &ts);
+  if (err == ETIMEDOUT)
+    return false;
+  if (err)
+    throw_system_error(err, "pthread_rwlock_clockwrlock");
+  return true;
+}
+
+void posix_shared_mutex::lock_shared() {
+  int err = ::pthread_rwlock_rdlock(&rwlock_);
+  if (err)
+    throw_system_error(err, "pthread_rwlock_rdlock");
+}
+
+void posix_shared_mutex::unlock_shared() {
+  int err = ::pthread_rwlock_unlock(&rwlock_);
+  if (err)
+    throw_system_error(err, "pthread_rwlock_unlock");
+}
+
+bool posix_shared_mutex::try_lock_shared() {
+  int err = ::pthread_rwlock_tryrdlock(&rwlock_);
+  if (err == EBUSY || err == EAGAIN)
+    return false;
+  if (err)
+    throw_system_error(err, "pthread_rwlock_tryrdlock");
+  return true;
+}
+
+bool posix_shared_mutex::try_lock_shared_for(realtime_clock::duration dur) {
+  return try_lock_shared_until(deadline_after(dur));
+}
+
+bool posix_shared_mutex::try_lock_shared_until(realtime_clock::time_point tp) {
+  const auto ts = to_timespec(tp.time_since_epoch());
+  int err = ::pthread_rwlock_timedrdlock(&rwlock_, &ts);
+  if (err == ETIMEDOUT)
+    return false;
+  if (err)
+    throw_system_error(err, "pthread_rwlock_timedrdlock");
+  return true;
+}
+
+bool posix_shared_mutex::try_lock_shared_until(const instant &deadline) {
+  const auto ts = to_timespec(deadline);
+  int err = ::pthread_rwlock_clockrdlock(&rwlock_, CLOCK_MONOTONIC, &ts);
+  if (err == ETIMEDOUT)
+    return false;
+  if (err)
+    throw_system_error(err, "pthread_rwlock_clockrdlock");
+  return true;
+}
+
+} // namespace detail
+} // namespace gpcl
+
+#endif
@@ -0,0 +1,257 @@
+//
+// posix_spsc_ring.ipp
+// ~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2020 Zhengyi Fu (tsingyat at outlook dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef GPCL_DETAIL_IMPL_POSIX_SPSC_RING_IPP
+#define GPCL_DETAIL_IMPL_POSIX_SPSC_RING_IPP
+
+#include <gpcl/detail/posix_spsc_ring.hpp>
+
+#ifdef GPCL_POSIX
+
+#include <gpcl/assert.hpp>
+#include <cerrno>
+#include <cstring>
+
+namespace gpcl {
+namespace detail {
+
+namespace spsc {
+
+constexpr std::uint32_t magic = 0x67707372; // "gpsr"
+
+// Smallest capacity; a ring must hold at least one non-empty record.
+constexpr std::size_t min_capacity = 64;
+
+GPCL_DECL_INLINE std::uint64_t round_up(std::uint64_t n, std::uint64_t align)
+{
+  return (n + align - 1) / align * align;
+}
+
+} // namespace spsc
+
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2,
+              "the ring positions are shared between processes");
+
+posix_spsc_ring::posix_spsc_ring(create_only_t, czstring<> name,
+                                 std::size_t capacity)
+    : shm_(create_only, name, shm_size(capacity))
+{
+  init();
+}
+
+posix_spsc_ring::posix_spsc_ring(open_or_create_t, czstring<> name,
+                                 std::size_t capacity)
+    : shm_(open_or_create, name, shm_size(capacity))
+{
+  init();
+}
+
+posix_spsc_ring::posix_spsc_ring(open_only_t, czstring<> name)
+    : shm_(open_only, name)
+{
+  init();
+}
+
+std::size_t posix_spsc_ring::shm_size(std::size_t capacity) noexcept
+{
+  std::size_t n = spsc::min_capacity;
+  while (n < capacity)
+    n *= 2;
+  return data_offset + n;
+}
+
+void posix_spsc_ring::init()
+{
+  ring_header *h = header();
+  if (shm_.created())
+  {
+    // A new shared memory object is zero-filled, so only the capacity needs
+    // to be set.
+    h->capacity = shm_.size() - data_offset;
+    h->magic.store(spsc::magic, std::memory_order_release);
+  }
+  else
+  {
+    wait_for_creator(
+        [h] { return h->magic.load(std::memory_order_acquire) == spsc::magic; },
+        "posix_spsc_ring: not initialized by creator");
+  }
+
+  GPCL_ASSERT(h->capacity != 0 && (h->capacity & (h->capacity - 1)) == 0);
+  mask_ = h->capacity - 1;
+  write_pos_ = h->write_pos.load(std::memory_order_acquire);
+  cached_read_pos_ = h->read_pos.load(std::memory_order_acquire);
+  cached_write_pos_ = write_pos_;
+}
+
+bool posix_spsc_ring::try_write(span<const char> msg, std::error_code &ec)
+{
+  ec.clear();
+  if (msg.size() > max_msg_size())
+  {
+    ec.assign(EMSGSIZE, std::system_category());
+    return false;
+  }
+
+  std::uint64_t size = spsc::round_up(sizeof(record_header) + msg.size(),
+                                      record_align);
+  std::uint64_t index = write_pos_ & mask_;
+  std::uint64_t to_end = capacity() - index;
+  std::uint64_t needed = size <= to_end ? size : to_end + size;
+
+  if (write_pos_ + needed - cached_read_pos_ > capacity())
+  {
+    cached_read_pos_ = header()->read_pos.load(std::memory_order_acquire);
+    if (write_pos_ + needed - cached_read_pos_ > capacity())
+      return false;
+  }
+
+  if (size > to_end)
+  {
+    auto *pad = reinterpret_cast<record_header *>(data() + index);
+    pad->size = 0;
+    pad->flags = padding_record;
+    write_pos_ += to_end;
+    index = 0;
+  }
+
+  auto *rec = reinterpret_cast<record_header *>(data() + index);
+  rec->size = static_cast<std::uint32_t>(msg.size());
+  rec->flags = 0;
+  if (!msg.empty())
+    std::memcpy(rec + 1, msg.data(), msg.size());
+  write_pos_ += size;
+  return true;
+}
+
+void posix_spsc_ring::commit() noexcept
+{
+  ring_header *h = header();
+
+  // Sequentially consistent, so that either the consumer sees the new
+  // position or this sees its waiting flag.
+  h->write_pos.store(write_pos_);
+  if (h->consumer_waiting.load() != 0 && h->consumer_waiting.exchange(0) != 0)
+  {
+    h->write_seq.fetch_add(1);
+    futex_wake(h->write_seq, 1);
+  }
+}
+
+void posix_spsc_ring::send(span<const char> msg, std::error_code &ec)
+{
+  while (!try_write(msg, ec))
+  {
+    if (ec)
+      return;
+
+    // Records of an unfinished batch must be visible, otherwise the
+    // consumer will never make room.
+    commit();
+    wait_for_space();
+  }
+  commit();
+}
+
+bool posix_spsc_ring::try_receive(span<char> msg, std::size_t &len,
+                                  std::error_code &ec)
+{
+  ec.clear();
+  ring_header *h = header();
+  std::uint64_t pos = h->read_pos.load(std::memory_order_relaxed);
+
+  for (;;)
+  {
+    if (pos == cached_write_pos_)
+    {
+      cached_write_pos_ = h->write_pos.load(std::memory_order_acquire);
+      if (pos == cached_write_pos_)
+        return false;
+    }
+
+    std::uint64_t index = pos & mask_;
+    auto *rec = reinterpret_cast<const record_header *>(data() + index);
+    if (rec->flags & padding_record)
+    {
+      pos += capacity() - index;
+      release(pos);
+      continue;
+    }
+
+    if (rec->size > msg.size())
+    {
+      ec.assign(EMSGSIZE, std::system_category());
+      return false;
+    }
+
+    len = rec->size;
+    std::memcpy(msg.data(), rec + 1, len);
+    release(pos + spsc::round_up(sizeof(record_header) + len, record_align));
+    return true;
+  }
+}
+
+std::size_t posix_spsc_ring::receive(span<char> msg, std::error_code &ec)
+{
+  std::size_t len = 0;
+  while (!try_receive(msg, len, ec))
+  {
+    if (ec)
+      return 0;
+    wait_for_data();
+  }
+  return len;
+}
+
+void posix_spsc_ring::release(std::uint64_t pos) noexcept
+{
+  ring_header *h = header();
+  h->read_pos.store(pos);
+  if (h->producer_waiting.load() != 0 && h->producer_waiting.exchange(0) != 0)
+  {
+    h->read_seq.fetch_add(1);
+    futex_wake(h->read_seq, 1);
+  }
+}
+
+void posix_spsc_ring::wait_for_space() noexcept
+{
+  ring_header *h = header();
+  h->producer_waiting.store(1);
+  std::uint32_t seq = h->read_seq.load();
+  std::uint64_t pos = h->read_pos.load();
+  if (pos != cached_read_pos_)
+  {
+    cached_read_pos_ = pos;
+    return;
+  }
+  futex_wait(h->read_seq, seq);
+}
+
+void posix_spsc_ring::wait_for_data() noexcept
+{
+  ring_header *h = header();
+  h->consumer_waiting.store(1);
+  std::uint32_t seq = h->write_seq.load();
+  std::uint64_t pos = h->write_pos.load();
+  if (pos != h->read_pos.load(std::memory_order_relaxed))
+  {
+    cached_write_pos_ = pos;
+    return;
+  }
+  futex_wait(h->write_seq, seq);
+}
+
+} // namespace detail
+} // namespace gpcl
+
+#endif // GPCL_POSIX
+
+#endif // GPCL_DETAIL_IMPL_POSIX_SPSC_RING_IPP
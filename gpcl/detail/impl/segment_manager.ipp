@@ -0,0 +1,320 @@
+//
+// segment_manager.ipp
+// ~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2020 Zhengyi Fu (tsingyat at outlook dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef GPCL_DETAIL_IMPL_SEGMENT_MANAGER_IPP
+#define GPCL_DETAIL_IMPL_SEGMENT_MANAGER_IPP
+
+#include <gpcl/detail/segment_manager.hpp>
+
+#ifdef GPCL_POSIX
+
+#include <gpcl/assert.hpp>
+#include <gpcl/detail/error.hpp>
+#include <gpcl/detail/posix_shared_memory.hpp>
+#include <gpcl/unique_lock.hpp>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+namespace gpcl {
+namespace detail {
+
+namespace segment {
+
+constexpr std::uint32_t magic = 0x67706d73; // "gpms"
+
+// Granularity and minimum alignment of blocks.
+constexpr std::size_t granule = 16;
+
+GPCL_DECL_INLINE std::size_t round_up(std::size_t n, std::size_t align)
+{
+  return (n + align - 1) / align * align;
+}
+
+} // namespace segment
+
+struct segment_manager::free_block
+{
+  std::size_t size;
+  std::size_t next;
+};
+
+// Precedes every allocation.
+struct segment_manager::block_header
+{
+  std::size_t size;
+
+  // Distance from the start of the block to this header.
+  std::size_t adjust;
+};
+
+struct segment_manager::named_entry
+{
+  std::size_t next;
+  std::size_t object;
+  std::size_t size;
+  std::size_t alignment;
+  char name[1];
+};
+
+segment_manager::segment_manager(std::size_t size)
+    : magic_(0),
+      size_(size)
+{
+  std::size_t heap = segment::round_up(sizeof(segment_manager),
+                                       segment::granule);
+  GPCL_ASSERT(size >= heap + 2 * sizeof(free_block));
+
+  std::size_t end = size / segment::granule * segment::granule;
+  auto *b = at<free_block>(heap);
+  b->size = end - heap;
+  b->next = 0;
+  free_list_ = heap;
+  free_bytes_ = b->size;
+
+  magic_.store(segment::magic, std::memory_order_release);
+}
+
+segment_manager *segment_manager::attach(void *segment)
+{
+  auto *m = static_cast<segment_manager *>(segment);
+  wait_for_creator(
+      [m] {
+        return m->magic_.load(std::memory_order_acquire) == segment::magic;
+      },
+      "segment_manager: not formatted by creator");
+  return m;
+}
+
+void *segment_manager::allocate(std::size_t bytes, std::size_t alignment)
+{
+  unique_lock<mutex_type> lock(mtx_);
+  recover();
+  return allocate_unlocked(bytes, alignment);
+}
+
+void segment_manager::deallocate(void *p)
+{
+  unique_lock<mutex_type> lock(mtx_);
+  recover();
+  deallocate_unlocked(p);
+}
+
+std::size_t segment_manager::free_memory() const
+{
+  unique_lock<mutex_type> lock(mtx_);
+  recover();
+  return free_bytes_;
+}
+
+void segment_manager::recover() const
+{
+  if (!mtx_.owner_died())
+    return;
+  if (!consistent())
+    throw_system_error(EOWNERDEAD, "segment_manager::recover");
+  mtx_.clear_owner_died();
+}
+
+bool segment_manager::consistent() const noexcept
+{
+  std::size_t heap = segment::round_up(sizeof(segment_manager),
+                                       segment::granule);
+  std::size_t end = size_ / segment::granule * segment::granule;
+
+  // The free blocks are in address order, apart and inside the heap, and
+  // add up to free_bytes_.
+  std::size_t free_bytes = 0;
+  std::size_t prev_end = heap;
+  for (std::size_t b = free_list_; b; b = at<free_block>(b)->next)
+  {
+    if (b < prev_end || b % segment::granule != 0 ||
+        end - b < sizeof(free_block))
+      return false;
+    std::size_t size = at<free_block>(b)->size;
+    if (size < sizeof(free_block) || size > end - b)
+      return false;
+    prev_end = b + size;
+    free_bytes += size;
+  }
+  if (free_bytes != free_bytes_)
+    return false;
+
+  // The entries are inside the heap, their names terminated inside the
+  // segment, and the list is not longer than the heap can hold.
+  std::size_t entries = (end - heap) / sizeof(named_entry);
+  for (std::size_t e = directory_; e; e = at<named_entry>(e)->next)
+  {
+    if (entries-- == 0 || e < heap || e > end - sizeof(named_entry))
+      return false;
+    const named_entry *entry = at<named_entry>(e);
+    if (entry->object >= size_ ||
+        !std::memchr(entry->name, 0, size_ - offset_of(entry->name)))
+      return false;
+  }
+  return true;
+}
+
+void *segment_manager::allocate_unlocked(std::size_t bytes,
+                                         std::size_t alignment) noexcept
+{
+  GPCL_ASSERT(alignment != 0 && (alignment & (alignment - 1)) == 0);
+  alignment = (std::max)(alignment, segment::granule);
+  if (bytes > size_ || alignment > size_)
+    return nullptr;
+
+  // Room for the header and enough slack to align the memory after it.
+  std::size_t need = segment::round_up((std::max)(bytes, std::size_t(1)),
+                                       segment::granule) +
+                     alignment;
+
+  std::size_t *link = &free_list_;
+  while (*link && at<free_block>(*link)->size < need)
+    link = &at<free_block>(*link)->next;
+  if (!*link)
+    return nullptr;
+
+  std::size_t start = *link;
+  auto *b = at<free_block>(start);
+  std::size_t size = b->size;
+  if (size - need >= sizeof(free_block))
+  {
+    auto *rest = at<free_block>(start + need);
+    rest->size = size - need;
+    rest->next = b->next;
+    *link = start + need;
+    size = need;
+  }
+  else
+  {
+    *link = b->next;
+  }
+  free_bytes_ -= size;
+
+  auto base = reinterpret_cast<std::uintptr_t>(b);
+  auto user = segment::round_up(base + sizeof(block_header), alignment);
+  auto *h = reinterpret_cast<block_header *>(user - sizeof(block_header));
+  h->size = size;
+  h->adjust = user - sizeof(block_header) - base;
+  return reinterpret_cast<void *>(user);
+}
+
+void segment_manager::deallocate_unlocked(void *p) noexcept
+{
+  if (!p)
+    return;
+
+  auto *h = reinterpret_cast<block_header *>(static_cast<char *>(p) -
+                                             sizeof(block_header));
+  std::size_t start = offset_of(h) - h->adjust;
+  std::size_t size = h->size;
+  GPCL_ASSERT(start + size <= size_);
+  free_bytes_ += size;
+
+  // Insert in address order and merge with the neighbours.
+  std::size_t prev = 0;
+  std::size_t *link = &free_list_;
+  while (*link && *link < start)
+  {
+    prev = *link;
+    link = &at<free_block>(*link)->next;
+  }
+  GPCL_ASSERT(*link != start && "double free");
+
+  auto *b = at<free_block>(start);
+  b->size = size;
+  b->next = *link;
+  if (b->next && start + b->size == b->next)
+  {
+    auto *next = at<free_block>(b->next);
+    b->size += next->size;
+    b->next = next->next;
+  }
+
+  if (prev && prev + at<free_block>(prev)->size == start)
+  {
+    auto *pb = at<free_block>(prev);
+    pb->size += b->size;
+    pb->next = b->next;
+  }
+  else
+  {
+    *link = start;
+  }
+}
+
+segment_manager::named_entry *
+segment_manager::find_entry(const char *name) const noexcept
+{
+  for (std::size_t e = directory_; e; e = at<named_entry>(e)->next)
+  {
+    auto *entry = at<named_entry>(e);
+    if (std::strcmp(entry->name, name) == 0)
+      return entry;
+  }
+  return nullptr;
+}
+
+void *segment_manager::find_named(const char *name, std::size_t size,
+                                  std::size_t alignment) const noexcept
+{
+  named_entry *e = find_entry(name);
+  if (!e)
+    return nullptr;
+  GPCL_ASSERT(e->size == size && e->alignment == alignment &&
+              "named object has a different type");
+  (void)size;
+  (void)alignment;
+  return at<void>(e->object);
+}
+
+bool segment_manager::insert_named(const char *name, void *object,
+                                   std::size_t size,
+                                   std::size_t alignment) noexcept
+{
+  GPCL_ASSERT(!find_entry(name));
+  std::size_t len = std::strlen(name);
+  auto *e = static_cast<named_entry *>(allocate_unlocked(
+      offsetof(named_entry, name) + len + 1, alignof(named_entry)));
+  if (!e)
+    return false;
+
+  e->object = offset_of(object);
+  e->size = size;
+  e->alignment = alignment;
+  std::memcpy(e->name, name, len + 1);
+  e->next = directory_;
+  directory_ = offset_of(e);
+  return true;
+}
+
+void *segment_manager::erase_named(const char *name) noexcept
+{
+  for (std::size_t *link = &directory_; *link;
+       link = &at<named_entry>(*link)->next)
+  {
+    auto *e = at<named_entry>(*link);
+    if (std::strcmp(e->name, name) == 0)
+    {
+      void *object = at<void>(e->object);
+      *link = e->next;
+      deallocate_unlocked(e);
+      return object;
+    }
+  }
+  return nullptr;
+}
+
+} // namespace detail
+} // namespace gpcl
+
+#endif // GPCL_POSIX
+
+#endif // GPCL_DETAIL_IMPL_SEGMENT_MANAGER_IPP
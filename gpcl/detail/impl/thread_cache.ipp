@@ -0,0 +1,182 @@
+//
+// thread_cache.ipp
+// ~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2020 Zhengyi Fu (tsingyat at outlook dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef GPCL_DETAIL_IMPL_THREAD_CACHE_IPP
+#define GPCL_DETAIL_IMPL_THREAD_CACHE_IPP
+
+#include <gpcl/assert.hpp>
+#include <gpcl/detail/thread_cache.hpp>
+#include <gpcl/mutex.hpp>
+#include <gpcl/unique_lock.hpp>
+#include <vector>
+
+namespace gpcl {
+namespace detail {
+
+// Process-wide bookkeeping of owner slots.
+struct thread_cache_registry
+{
+  mutex mtx;
+  std::vector<std::size_t> free_slots;
+  std::size_t next_slot = 0;
+  std::uint64_t next_id = 1;
+};
+
+GPCL_DECL thread_cache_registry &get_thread_cache_registry()
+{
+  static thread_cache_registry instance;
+  return instance;
+}
+
+thread_cache_table::~thread_cache_table()
+{
+  auto &registry = get_thread_cache_registry();
+  unique_lock<mutex> lock(registry.mtx);
+
+  for (thread_cache_magazine *m : slots)
+  {
+    if (!m)
+      continue;
+
+    if (thread_cache_owner *owner = m->owner)
+    {
+      owner->drain(m, m->count);
+
+      if (m->prev)
+        m->prev->next = m->next;
+      else
+        owner->magazines_ = m->next;
+      if (m->next)
+        m->next->prev = m->prev;
+    }
+
+    delete m;
+  }
+}
+
+thread_cache_owner::thread_cache_owner(std::size_t batch_size,
+                                       std::size_t max_cached,
+                                       drain_function drain, void *context)
+    : batch_size_(batch_size),
+      max_cached_(max_cached),
+      drain_(drain),
+      context_(context)
+{
+  GPCL_ASSERT(batch_size != 0);
+  GPCL_ASSERT(max_cached >= batch_size);
+  GPCL_ASSERT(drain);
+
+  auto &registry = get_thread_cache_registry();
+  unique_lock<mutex> lock(registry.mtx);
+
+  if (registry.free_slots.empty())
+  {
+    slot_ = registry.next_slot++;
+  }
+  else
+  {
+    slot_ = registry.free_slots.back();
+    registry.free_slots.pop_back();
+  }
+  id_ = registry.next_id++;
+}
+
+thread_cache_owner::~thread_cache_owner()
+{
+  auto &registry = get_thread_cache_registry();
+  unique_lock<mutex> lock(registry.mtx);
+
+  for (thread_cache_magazine *m = magazines_; m; m = m->next)
+  {
+    m->owner = nullptr;
+    m->head = nullptr;
+    m->count = 0;
+  }
+  magazines_ = nullptr;
+
+  registry.free_slots.push_back(slot_);
+}
+
+void *thread_cache_owner::refill(void *first, std::size_t n)
+{
+  GPCL_ASSERT(first && n != 0);
+  thread_cache_magazine *m = local_magazine();
+
+  void *ret = first;
+  void *rest = *static_cast<void **>(first);
+  if (--n == 0)
+    return ret;
+
+  if (m->head)
+  {
+    void *last = rest;
+    while (*static_cast<void **>(last))
+      last = *static_cast<void **>(last);
+    *static_cast<void **>(last) = m->head;
+  }
+  m->head = rest;
+  m->count += n;
+
+  if (m->count > max_cached_)
+    drain(m, m->count - max_cached_);
+
+  return ret;
+}
+
+void thread_cache_owner::flush()
+{
+  thread_cache_magazine *m = local_magazine();
+  drain(m, m->count);
+}
+
+thread_cache_magazine *thread_cache_owner::attach(thread_cache_table &table)
+{
+  auto &registry = get_thread_cache_registry();
+  unique_lock<mutex> lock(registry.mtx);
+
+  if (table.slots.size() <= slot_)
+    table.slots.resize(slot_ + 1);
+
+  // The slot may still hold the magazine of a destroyed owner.
+  thread_cache_magazine *&slot = table.slots[slot_];
+  if (slot)
+  {
+    GPCL_ASSERT(slot->owner == nullptr);
+    delete slot;
+  }
+
+  slot = new thread_cache_magazine{nullptr, 0, this, id_, nullptr, magazines_};
+  if (magazines_)
+    magazines_->prev = slot;
+  magazines_ = slot;
+  return slot;
+}
+
+void thread_cache_owner::drain(thread_cache_magazine *m, std::size_t n) noexcept
+{
+  GPCL_ASSERT(n <= m->count);
+  if (n == 0)
+    return;
+
+  void *first = m->head;
+  void *last = first;
+  for (std::size_t i = 1; i < n; ++i)
+    last = *static_cast<void **>(last);
+
+  m->head = *static_cast<void **>(last);
+  m->count -= n;
+  *static_cast<void **>(last) = nullptr;
+  drain_(context_, first, last);
+}
+
+} // namespace detail
+} // namespace gpcl
+
+#endif // GPCL_DETAIL_IMPL_THREAD_CACHE_IPP
@@ -0,0 +1,220 @@
+//
+// thread_pool.ipp
+// ~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2020 Zhengyi Fu (tsingyat at outlook dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef GPCL_DETAIL_IMPL_THREAD_POOL_IPP
+#define GPCL_DETAIL_IMPL_THREAD_POOL_IPP
+
+#include <gpcl/thread_pool.hpp>
+
+#ifdef GPCL_POSIX
+
+#include <gpcl/assert.hpp>
+#include <climits>
+#include <unistd.h>
+
+namespace gpcl {
+
+namespace thread_pool_detail {
+
+inline std::size_t online_cpus() noexcept
+{
+  long n = ::sysconf(_SC_NPROCESSORS_ONLN);
+  return n > 0 ? static_cast<std::size_t>(n) : 1;
+}
+
+} // namespace thread_pool_detail
+
+thread_pool::thread_pool(std::size_t threads, const thread_attributes &attr)
+    : size_(threads != 0 ? threads : thread_pool_detail::online_cpus()),
+      workers_(new worker[size_])
+{
+  GPCL_TRY
+  {
+    for (std::size_t i = 0; i < size_; ++i)
+    {
+      worker &w = workers_[i];
+      w.pool = this;
+      w.index = i;
+      w.thread = gpcl::thread(attr, [this, &w] { run(w); });
+    }
+  }
+  GPCL_CATCH(...)
+  {
+    shutdown();
+    GPCL_RETHROW
+  }
+  GPCL_CATCH_END
+}
+
+thread_pool::~thread_pool() { shutdown(); }
+
+void thread_pool::wait_idle()
+{
+  GPCL_ASSERT(!current_worker() || current_worker()->pool != this);
+  for (;;)
+  {
+    if (pending_.load() == 0)
+      return;
+    idle_waiters_.fetch_add(1);
+    // Read again after registering, so that the last task either sees this
+    // waiter or finished before this read.
+    std::uint32_t n = pending_.load();
+    if (n != 0)
+      detail::futex_wait(pending_, n, nullptr, false);
+    idle_waiters_.fetch_sub(1, std::memory_order_relaxed);
+  }
+}
+
+void thread_pool::shutdown()
+{
+  GPCL_ASSERT(!current_worker() || current_worker()->pool != this);
+  stopping_.store(true);
+  work_seq_.fetch_add(1);
+  detail::futex_wake(work_seq_, INT_MAX, false);
+  for (std::size_t i = 0; i < size_; ++i)
+  {
+    if (workers_[i].thread.joinable())
+      workers_[i].thread.join();
+  }
+}
+
+thread_pool::worker *&thread_pool::current_worker() noexcept
+{
+  static thread_local worker *current = nullptr;
+  return current;
+}
+
+void thread_pool::submit(task *t) noexcept
+{
+  pending_.fetch_add(1);
+  worker *w = current_worker();
+  if (w && w->pool == this)
+  {
+    GPCL_TRY { w->deque.push(t); }
+    GPCL_CATCH(...)
+    {
+      // The deque could not grow.
+      inject(t);
+    }
+    GPCL_CATCH_END
+  }
+  else
+  {
+    inject(t);
+  }
+
+  // Sequentially consistent with the sleepers' registration and their
+  // has_work(), so that either a sleeper sees the task or it is woken.
+  if (sleepers_.load() != 0)
+  {
+    work_seq_.fetch_add(1);
+    detail::futex_wake(work_seq_, 1, false);
+  }
+}
+
+void thread_pool::inject(task *t) noexcept
+{
+  t->next = nullptr;
+  injection_mutex_.lock();
+  if (injection_tail_)
+    injection_tail_->next = t;
+  else
+    injection_head_ = t;
+  injection_tail_ = t;
+  injected_.fetch_add(1);
+  injection_mutex_.unlock();
+}
+
+thread_pool::task *thread_pool::find_task(worker &w) noexcept
+{
+  if (task *t = w.deque.pop())
+    return t;
+
+  if (injected_.load() != 0)
+  {
+    injection_mutex_.lock();
+    task *t = injection_head_;
+    if (t)
+    {
+      injection_head_ = t->next;
+      if (!injection_head_)
+        injection_tail_ = nullptr;
+      injected_.fetch_sub(1, std::memory_order_relaxed);
+    }
+    injection_mutex_.unlock();
+    if (t)
+      return t;
+  }
+
+  // Start from the next worker, so that thieves spread over the victims.
+  for (std::size_t i = 1; i < size_; ++i)
+  {
+    if (task *t = workers_[(w.index + i) % size_].deque.steal())
+      return t;
+  }
+  return nullptr;
+}
+
+bool thread_pool::has_work() const noexcept
+{
+  if (injected_.load() != 0)
+    return true;
+  for (std::size_t i = 0; i < size_; ++i)
+  {
+    if (!workers_[i].deque.empty())
+      return true;
+  }
+  return false;
+}
+
+void thread_pool::execute(task *t) noexcept
+{
+  // Being noexcept, this terminates if the task throws.
+  t->invoke(t);
+  tasks_.free(t);
+
+  if (pending_.fetch_sub(1) != 1)
+    return;
+  if (idle_waiters_.load() != 0)
+    detail::futex_wake(pending_, INT_MAX, false);
+  if (stopping_.load())
+  {
+    work_seq_.fetch_add(1);
+    detail::futex_wake(work_seq_, INT_MAX, false);
+  }
+}
+
+void thread_pool::run(worker &w) noexcept
+{
+  current_worker() = &w;
+  for (;;)
+  {
+    if (task *t = find_task(w))
+    {
+      execute(t);
+      continue;
+    }
+    if (stopping_.load() && pending_.load() == 0)
+      break;
+
+    sleepers_.fetch_add(1);
+    std::uint32_t seq = work_seq_.load();
+    if (!has_work() && !(stopping_.load() && pending_.load() == 0))
+      detail::futex_wait(work_seq_, seq, nullptr, false);
+    sleepers_.fetch_sub(1, std::memory_order_relaxed);
+  }
+  current_worker() = nullptr;
+}
+
+} // namespace gpcl
+
+#endif // GPCL_POSIX
+
+#endif // GPCL_DETAIL_IMPL_THREAD_POOL_IPP
@@ -0,0 +1,132 @@
+//
+// percpu_rwlock.hpp
+// ~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2020 Zhengyi Fu (tsingyat at outlook dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef GPCL_DETAIL_PERCPU_RWLOCK_HPP
+#define GPCL_DETAIL_PERCPU_RWLOCK_HPP
+
+#include <gpcl/detail/config.hpp>
+#include <gpcl/detail/futex.hpp>
+#include <gpcl/detail/futex_mutex.hpp>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#ifdef GPCL_POSIX
+
+namespace gpcl {
+namespace detail {
+
+// A process-private reader-writer lock whose readers count themselves in
+// one of several cache-line-sized slots, chosen by the CPU a thread first
+// ran on, so that readers on different CPUs never write to the same line.
+//
+// A writer serializes with other writers on a futex_mutex, announces itself
+// in writer_ and waits for every slot to drain. A reader that finds writer_
+// set backs out of its slot and sleeps until the writer is done, so writers
+// are not starved.
+class percpu_rwlock
+{
+public:
+  enum : std::uint32_t
+  {
+    no_writer = 0,
+    writing = 1,
+    writing_with_waiters = 2
+  };
+
+  // Makes one slot per configured CPU if slots is 0.
+  GPCL_DECL explicit percpu_rwlock(std::size_t slots = 0);
+
+  percpu_rwlock(const percpu_rwlock &) = delete;
+  percpu_rwlock &operator=(const percpu_rwlock &) = delete;
+
+  void lock_shared() noexcept
+  {
+    slot &s = my_slot();
+    s.readers.fetch_add(1);
+    if (writer_.load() != no_writer)
+      lock_shared_slow(s);
+  }
+
+  bool try_lock_shared() noexcept
+  {
+    slot &s = my_slot();
+    s.readers.fetch_add(1);
+    if (writer_.load() == no_writer)
+      return true;
+    leave(s);
+    return false;
+  }
+
+  void unlock_shared() noexcept { leave(my_slot()); }
+
+  GPCL_DECL void lock() noexcept;
+
+  GPCL_DECL bool try_lock() noexcept;
+
+  GPCL_DECL void unlock() noexcept;
+
+  std::size_t slots() const noexcept { return nslots_; }
+
+private:
+  struct alignas(GPCL_CACHELINE_SIZE) slot
+  {
+    std::atomic<std::uint32_t> readers{0};
+  };
+
+  // The slot of the calling thread; it does not change for the life of the
+  // thread, even if the thread migrates.
+  slot &my_slot() noexcept
+  {
+    static thread_local const unsigned cpu = current_cpu();
+    return slots_[cpu % nslots_];
+  }
+
+  // Leaves s and, if a writer is waiting for the readers to drain, tells it.
+  // The seq_cst operations pair with those in lock(): either the writer
+  // sees the decrement or the reader sees writer_.
+  void leave(slot &s) noexcept
+  {
+    s.readers.fetch_sub(1);
+    if (writer_.load() != no_writer)
+      notify_writer();
+  }
+
+  GPCL_DECL static unsigned current_cpu() noexcept;
+
+  // Backs out of s, waits for the writer and enters s again.
+  GPCL_DECL void lock_shared_slow(slot &s) noexcept;
+
+  GPCL_DECL void notify_writer() noexcept;
+
+  // Whether every slot is empty.
+  GPCL_DECL bool drained() const noexcept;
+
+  std::size_t nslots_;
+  std::unique_ptr<slot[]> slots_;
+
+  alignas(GPCL_CACHELINE_SIZE) futex_word writer_{no_writer};
+  futex_mutex writers_;
+
+  // Bumped by readers leaving while a writer waits for them.
+  alignas(GPCL_CACHELINE_SIZE) futex_word drain_seq_{0};
+};
+
+} // namespace detail
+} // namespace gpcl
+
+#endif // GPCL_POSIX
+
+#ifdef GPCL_HEADER_ONLY
+#  include <gpcl/detail/impl/percpu_rwlock.ipp>
+#endif
+
+#endif // GPCL_DETAIL_PERCPU_RWLOCK_HPP
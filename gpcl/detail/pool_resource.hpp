@@ -0,0 +1,166 @@
+//
+// pool_resource.hpp
+// ~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2020 Zhengyi Fu (tsingyat at outlook dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef GPCL_DETAIL_POOL_RESOURCE_HPP
+#define GPCL_DETAIL_POOL_RESOURCE_HPP
+
+#include <gpcl/assert.hpp>
+#include <gpcl/detail/config.hpp>
+#include <gpcl/noncopyable.hpp>
+#include <gpcl/pmr/pool_options.hpp>
+#include <gpcl/simple_segregated_storage.hpp>
+#include <cstddef>
+
+namespace gpcl {
+namespace pmr {
+class memory_resource;
+} // namespace pmr
+
+namespace detail {
+
+// The smallest pool block; every block holds a free list link.
+constexpr std::size_t pool_resource_min_block = sizeof(void *);
+
+// Blocks are aligned to their size up to this value. Allocations with a
+// larger alignment bypass the pools.
+constexpr std::size_t pool_resource_max_block_alignment = 4096;
+
+// Limits applied to pool_options.
+constexpr std::size_t pool_resource_default_largest_block = 4096;
+constexpr std::size_t pool_resource_max_largest_block = std::size_t(1) << 20;
+constexpr std::size_t pool_resource_default_blocks_per_chunk = 1024;
+constexpr std::size_t pool_resource_max_blocks_per_chunk = 1 << 16;
+
+// Replaces zero and out-of-range values by the defaults and limits, and
+// rounds largest_required_pool_block up to a power of two.
+GPCL_DECL pmr::pool_options normalize_pool_options(pmr::pool_options opts);
+
+// Returns the number of size classes for normalized options.
+GPCL_DECL std::size_t pool_size_class_count(const pmr::pool_options &opts);
+
+// Returns the index of the size class serving (bytes, alignment); the caller
+// checks the result against pool_size_class_count().
+GPCL_DECL_INLINE std::size_t pool_size_class_index(std::size_t bytes,
+                                                   std::size_t alignment)
+{
+  std::size_t sz = bytes < alignment ? alignment : bytes;
+  if (sz <= pool_resource_min_block)
+    return 0;
+#ifdef __GNUC__
+  std::size_t log2 = sizeof(unsigned long) * 8 - __builtin_clzl(sz - 1);
+#else
+  std::size_t log2 = 0;
+  while ((std::size_t(1) << log2) < sz)
+    ++log2;
+#endif
+  std::size_t min_log2 = sizeof(void *) == 8 ? 3 : 2;
+  return log2 - min_log2;
+}
+
+// Blocks of one size carved from chunks obtained from an upstream resource.
+// The chunks are kept until release().
+class pool_size_class : noncopyable
+{
+public:
+  pool_size_class() = default;
+
+  ~pool_size_class() { GPCL_ASSERT(chunks_ == nullptr); }
+
+  // Sets the block size; the pool must be empty.
+  GPCL_DECL void configure(std::size_t block_size,
+                           std::size_t max_blocks_per_chunk);
+
+  std::size_t block_size() const noexcept { return block_size_; }
+
+  GPCL_DECL_INLINE void *allocate(pmr::memory_resource *upstream)
+  {
+    if (storage_.empty())
+      replenish(upstream);
+    return storage_.malloc(block_size_);
+  }
+
+  GPCL_DECL_INLINE void deallocate(void *p) noexcept { storage_.free(p); }
+
+  // Allocates up to n blocks linked through their first word, at least one.
+  GPCL_DECL std::size_t allocate_batch(pmr::memory_resource *upstream,
+                                       std::size_t n, void *&first);
+
+  void deallocate_batch(void *first, void *last) noexcept
+  {
+    storage_.free_batch(first, last);
+  }
+
+  // Returns all chunks to upstream.
+  GPCL_DECL void release(pmr::memory_resource *upstream) noexcept;
+
+private:
+  struct chunk_header
+  {
+    chunk_header *next;
+    std::size_t blocks;
+  };
+
+  // Obtains a chunk from upstream, each one twice as large as the previous
+  // up to max_blocks_per_chunk blocks.
+  GPCL_DECL void replenish(pmr::memory_resource *upstream);
+
+  GPCL_DECL std::size_t chunk_alignment() const noexcept;
+
+  simple_segregated_storage<std::size_t> storage_;
+  std::size_t block_size_{};
+  std::size_t next_blocks_{};
+  std::size_t max_blocks_{};
+  chunk_header *chunks_{};
+};
+
+// Allocations served by upstream directly, tracked so that release() can
+// return them.
+class oversized_list : noncopyable
+{
+public:
+  oversized_list() = default;
+
+  ~oversized_list() { GPCL_ASSERT(head_ == nullptr); }
+
+  GPCL_DECL void *allocate(pmr::memory_resource *upstream, std::size_t bytes,
+                           std::size_t alignment);
+
+  GPCL_DECL void deallocate(pmr::memory_resource *upstream, void *p,
+                            std::size_t bytes, std::size_t alignment) noexcept;
+
+  GPCL_DECL void release(pmr::memory_resource *upstream) noexcept;
+
+private:
+  // Placed after the user bytes.
+  struct header
+  {
+    header *prev;
+    header *next;
+    void *ptr;
+    std::size_t bytes;
+    std::size_t alignment;
+  };
+
+  static std::size_t header_offset(std::size_t bytes) noexcept
+  {
+    return (bytes + alignof(header) - 1) / alignof(header) * alignof(header);
+  }
+
+  header *head_{};
+};
+
+} // namespace detail
+} // namespace gpcl
+
+#if defined(GPCL_HEADER_ONLY)
+#  include <gpcl/detail/impl/pool_resource.ipp>
+#endif
+
+#endif // GPCL_DETAIL_POOL_RESOURCE_HPP
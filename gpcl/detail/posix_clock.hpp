@@ -14,10 +14,12 @@
 #include <gpcl/assert.hpp>
 #include <gpcl/detail/chrono.hpp>
 #include <gpcl/detail/config.hpp>
+#include <gpcl/time.hpp>
 
 #ifdef GPCL_POSIX
 
 #include <ctime>
+#include <limits>
 
 namespace gpcl {
 namespace detail {
@@ -39,6 +41,31 @@ inline struct timespec to_timespec(
   return ts;
 }
 
+// Converts a deadline to an absolute time of CLOCK_MONOTONIC, as taken by
+// the clock-selecting waits. Deadlines too far away to be represented are
+// clamped.
+inline struct timespec to_timespec(const instant &deadline) noexcept {
+  const duration d = deadline.duration_since_startup();
+  constexpr auto max_secs = (std::numeric_limits<time_t>::max)();
+  if (d.as_secs() > static_cast<u64>(max_secs)) {
+    auto ts = timespec{};
+    ts.tv_sec = max_secs;
+    ts.tv_nsec = 999999999;
+    return ts;
+  }
+  return d.to_timespec();
+}
+
+// Converts a timeout to the deadline it expires at, measured on
+// CLOCK_MONOTONIC so that setting the system clock does not move it.
+inline instant deadline_after(chrono::nanoseconds dur) {
+  const auto now = instant::now();
+  if (dur.count() <= 0)
+    return now;
+  return now.saturating_add(
+      duration::from_nanos(static_cast<u64>(dur.count())));
+}
+
 struct monotonic_clock {
   monotonic_clock() = delete;
 
@@ -62,7 +89,7 @@ struct realtime_clock {
   const static bool is_steady{false};
   static GPCL_DECL time_point now() noexcept;
 
-  static const ::clockid_t clock_id{CLOCK_MONOTONIC};
+  static const ::clockid_t clock_id{CLOCK_REALTIME};
 };
 
 } // namespace detail
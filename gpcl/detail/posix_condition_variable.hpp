@@ -35,6 +35,9 @@ public:
   GPCL_DECL bool wait_until(gpcl::unique_lock<posix_normal_mutex> &lock,
       const system_time &timeout_time);
 
+  GPCL_DECL bool wait_until(gpcl::unique_lock<posix_normal_mutex> &lock,
+      const instant &deadline);
+
   GPCL_DECL bool wait_for(
       gpcl::unique_lock<posix_normal_mutex> &lock, const duration &rel_time);
 
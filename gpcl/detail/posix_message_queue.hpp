@@ -16,15 +16,39 @@
 #include <gpcl/expected_fwd.hpp>
 #include <gpcl/noncopyable.hpp>
 #include <gpcl/span.hpp>
+#include <gpcl/time.hpp>
 #include <gpcl/zstring.hpp>
 #include <cstdint>
 #include <memory>
 #include <system_error>
+#include <utility>
 
 #ifdef GPCL_POSIX
 #  include <mqueue.h>
 
 namespace gpcl {
+
+/// Whether the operations on a message queue wait while it is full or
+/// empty. Operations that would wait on a non-blocking queue fail with
+/// EAGAIN instead.
+enum class queue_mode
+{
+  blocking,
+  non_blocking
+};
+
+/// A message received from a message queue.
+struct received_message
+{
+  /// The message, at the front of the receive buffer.
+  span<char> data;
+
+  /// Priority the message was sent with.
+  unsigned int priority;
+
+  std::size_t size() const noexcept { return data.size(); }
+};
+
 namespace detail {
 
 class posix_message_queue
@@ -35,10 +59,13 @@ public:
   using size_type = std::size_t;
 
   GPCL_DECL posix_message_queue(create_only_t, czstring<> name,
-                                std::size_t maxmsg, std::size_t msgsize);
+                                std::size_t maxmsg, std::size_t msgsize,
+                                queue_mode mode = queue_mode::blocking);
   GPCL_DECL posix_message_queue(open_or_create_t, czstring<> name,
-                                std::size_t maxmsg, std::size_t msgsize);
-  GPCL_DECL posix_message_queue(open_only_t, czstring<> name);
+                                std::size_t maxmsg, std::size_t msgsize,
+                                queue_mode mode = queue_mode::blocking);
+  GPCL_DECL posix_message_queue(open_only_t, czstring<> name,
+                                queue_mode mode = queue_mode::blocking);
 
   GPCL_DECL_INLINE posix_message_queue() : q_(-1) {}
 
@@ -80,6 +107,9 @@ public:
 
   GPCL_DECL std::size_t receive(gpcl::span<char> msg, std::error_code &ec);
 
+  GPCL_DECL received_message receive_message(gpcl::span<char> msg,
+                                             std::error_code &ec);
+
   std::size_t receive(gpcl::span<char> msg)
   {
     std::error_code ec;
@@ -89,6 +119,38 @@ public:
     return ret;
   }
 
+  // Fails with ETIMEDOUT once deadline has passed.
+  GPCL_DECL void timed_send(gpcl::span<const char> msg, unsigned int prio,
+                            const system_time &deadline, std::error_code &ec);
+
+  GPCL_DECL received_message timed_receive(gpcl::span<char> msg,
+                                           const system_time &deadline,
+                                           std::error_code &ec);
+
+  // As above, but on CLOCK_MONOTONIC: setting the system clock forward does
+  // not make them time out early.
+  GPCL_DECL void timed_send(gpcl::span<const char> msg, unsigned int prio,
+                            const instant &deadline, std::error_code &ec);
+
+  GPCL_DECL received_message timed_receive(gpcl::span<char> msg,
+                                           const instant &deadline,
+                                           std::error_code &ec);
+
+  // Receives into bufs[0] as receive() does, then into the following
+  // buffers for as long as messages are queued. An error after the first
+  // message ends the batch and is left for the next call.
+  GPCL_DECL std::size_t receive_batch(gpcl::span<const gpcl::span<char>> bufs,
+                                      gpcl::span<received_message> msgs,
+                                      std::error_code &ec);
+
+  GPCL_DECL void attributes(mq_attr &attr, std::error_code &ec) const;
+
+  GPCL_DECL queue_mode mode(std::error_code &ec) const;
+
+  GPCL_DECL void set_mode(queue_mode mode, std::error_code &ec);
+
+  mqd_t native_handle() const noexcept { return q_; }
+
 private:
   mqd_t q_;
 };
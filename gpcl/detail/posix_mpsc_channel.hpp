@@ -0,0 +1,170 @@
+//
+// posix_mpsc_channel.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2020 Zhengyi Fu (tsingyat at outlook dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef GPCL_DETAIL_POSIX_MPSC_CHANNEL_HPP
+#define GPCL_DETAIL_POSIX_MPSC_CHANNEL_HPP
+
+#include <gpcl/buffer.hpp>
+#include <gpcl/creation_tag.hpp>
+#include <gpcl/detail/config.hpp>
+#include <gpcl/detail/futex.hpp>
+#include <gpcl/detail/posix_shared_memory.hpp>
+#include <gpcl/zstring.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <system_error>
+
+#ifdef GPCL_POSIX
+
+namespace gpcl {
+namespace detail {
+
+// A multi-producer/single-consumer ring of variable-length records in a
+// shared memory object.
+//
+// Producers reserve records by advancing write_pos with a CAS and commit
+// them by storing the record length into its header, so records may be
+// committed out of order; the consumer stops at the first uncommitted one.
+// The consumer zeroes every record it releases, which keeps the length of
+// every header that has not been committed zero.
+//
+// As in posix_spsc_ring, a record never wraps around.
+class posix_mpsc_channel
+{
+public:
+  using size_type = std::size_t;
+
+  GPCL_DECL posix_mpsc_channel(create_only_t, czstring<> name,
+                               std::size_t capacity);
+  GPCL_DECL posix_mpsc_channel(open_or_create_t, czstring<> name,
+                               std::size_t capacity);
+  GPCL_DECL posix_mpsc_channel(open_only_t, czstring<> name);
+
+  posix_mpsc_channel(posix_mpsc_channel &&) noexcept = default;
+
+  static void unlink(czstring<> name, std::error_code &ec)
+  {
+    posix_shared_memory::unlink(name, ec);
+  }
+
+  static void unlink(czstring<> name) { posix_shared_memory::unlink(name); }
+
+  std::size_t capacity() const noexcept { return mask_ + 1; }
+
+  std::size_t max_msg_size() const noexcept
+  {
+    return (std::min)(capacity() / 2, std::size_t(INT32_MAX)) -
+           sizeof(record_header);
+  }
+
+  // Returns a buffer with a null data() if there is no room.
+  GPCL_DECL mutable_buffer try_reserve(std::size_t size, std::error_code &ec);
+
+  GPCL_DECL mutable_buffer reserve(std::size_t size, std::error_code &ec);
+
+  // Commits the first size bytes of the reserved record.
+  GPCL_DECL void commit(std::size_t size) noexcept;
+
+  bool reserved() const noexcept { return reserved_ != nullptr; }
+
+  // Returns a buffer with a null data() if the next record is not
+  // committed yet.
+  GPCL_DECL const_buffer try_peek() noexcept;
+
+  GPCL_DECL const_buffer peek() noexcept;
+
+  // Releases the peeked record.
+  GPCL_DECL void release() noexcept;
+
+  bool peeked() const noexcept { return peeked_length_ != 0; }
+
+private:
+  struct record_header
+  {
+    // Length of the whole record; zero until the record is committed.
+    std::atomic<std::uint32_t> length;
+    std::uint32_t size;
+  };
+
+  static constexpr std::size_t record_align = sizeof(record_header);
+  static constexpr std::uint32_t padding_record = UINT32_MAX;
+
+  struct channel_header
+  {
+    std::atomic<std::uint32_t> magic;
+    std::uint32_t reserved;
+    std::uint64_t capacity;
+
+    // Written by the producers.
+    alignas(GPCL_CACHELINE_SIZE) std::atomic<std::uint64_t> write_pos;
+    futex_word write_seq;
+    futex_word consumer_waiting;
+
+    // Written by the consumer.
+    alignas(GPCL_CACHELINE_SIZE) std::atomic<std::uint64_t> read_pos;
+    futex_word read_seq;
+    futex_word producers_waiting;
+  };
+
+  static constexpr std::size_t data_offset =
+      (sizeof(channel_header) + GPCL_CACHELINE_SIZE - 1) /
+      GPCL_CACHELINE_SIZE * GPCL_CACHELINE_SIZE;
+
+  // Size of the shared memory object of a channel of at least capacity
+  // bytes.
+  GPCL_DECL static std::size_t shm_size(std::size_t capacity) noexcept;
+
+  // Formats the channel if this object created it, otherwise waits until
+  // the creator has.
+  GPCL_DECL void init();
+
+  // Stores length into h, which makes the record visible to the consumer.
+  GPCL_DECL void publish(record_header *h, std::uint32_t length) noexcept;
+
+  // Sleep until the other side has made progress, or spuriously.
+  GPCL_DECL void wait_for_space() noexcept;
+
+  GPCL_DECL void wait_for_data() noexcept;
+
+  channel_header *header() const noexcept
+  {
+    return static_cast<channel_header *>(shm_.address());
+  }
+
+  record_header *record_at(std::uint64_t pos) const noexcept
+  {
+    return reinterpret_cast<record_header *>(
+        static_cast<char *>(shm_.address()) + data_offset + (pos & mask_));
+  }
+
+  posix_shared_memory shm_;
+  std::uint64_t mask_{};
+
+  // Producer: the last read_pos seen, and the reserved record.
+  std::uint64_t cached_read_pos_{};
+  record_header *reserved_{};
+  std::uint32_t reserved_length_{};
+
+  // Consumer: length of the peeked record, including the padding record
+  // before it.
+  std::uint64_t peeked_length_{};
+};
+
+} // namespace detail
+} // namespace gpcl
+
+#endif // GPCL_POSIX
+
+#ifdef GPCL_HEADER_ONLY
+#  include <gpcl/detail/impl/posix_mpsc_channel.ipp>
+#endif
+
+#endif // GPCL_DETAIL_POSIX_MPSC_CHANNEL_HPP
@@ -61,6 +61,9 @@ public:
   [[nodiscard]] GPCL_DECL posix_mutex_type type() const noexcept;
   GPCL_DECL void type(posix_mutex_type t) noexcept;
 
+  [[nodiscard]] GPCL_DECL bool process_shared() const noexcept;
+  GPCL_DECL void process_shared(bool pshared) noexcept;
+
   [[nodiscard]] const pthread_mutexattr_t *get() const { return &attr_; }
 
 private:
@@ -86,9 +89,11 @@ public:
 
   GPCL_DECL bool try_lock_until(realtime_clock::time_point tp);
 
+  GPCL_DECL bool try_lock_until(const instant &deadline);
+
   native_handle_type native_handle() noexcept { return &mtx_; }
 
-private:
+protected:
   pthread_mutex_t mtx_{};
 };
 
@@ -116,6 +121,37 @@ public:
   posix_recursive_mutex() : posix_mutex_base(init_attr()) {}
 };
 
+// A recursive, robust mutex that may be placed in memory shared between
+// processes. If its owner dies, the next lock() takes it over, marks it
+// consistent again and sets owner_died(): the data it protects may have
+// been left half updated.
+class posix_interprocess_mutex : public posix_mutex_base {
+  static auto init_attr(posix_mutex_attr &&attr = posix_mutex_attr())
+      -> posix_mutex_attr && {
+    attr.type(posix_mutex_type::recursive);
+    attr.robust(posix_mutex_robust::robust);
+    attr.process_shared(true);
+    return detail::move(attr);
+  }
+
+public:
+  posix_interprocess_mutex() : posix_mutex_base(init_attr()) {}
+
+  GPCL_DECL void lock();
+
+  GPCL_DECL bool try_lock();
+
+  // Whether a previous owner died holding the mutex. Only meaningful while
+  // the mutex is held; it stays set until clear_owner_died(), so that
+  // every later owner learns about it until someone checks the data.
+  bool owner_died() const noexcept { return owner_died_; }
+
+  void clear_owner_died() noexcept { owner_died_ = false; }
+
+private:
+  bool owner_died_ = false;
+};
+
 } // namespace detail
 } // namespace gpcl
 
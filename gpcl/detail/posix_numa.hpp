@@ -0,0 +1,54 @@
+//
+// posix_numa.hpp
+// ~~~~~~~~~~~~~~
+//
+// Copyright (c) 2020 Zhengyi Fu (tsingyat at outlook dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef GPCL_DETAIL_POSIX_NUMA_HPP
+#define GPCL_DETAIL_POSIX_NUMA_HPP
+
+#include <gpcl/detail/config.hpp>
+#include <cstddef>
+
+#ifdef GPCL_POSIX
+
+namespace gpcl {
+namespace detail {
+
+// Thin wrappers of the NUMA system calls, so that libnuma is not needed.
+
+// The largest number of nodes supported.
+constexpr int numa_max_nodes = 1024;
+
+// \returns The number of memory nodes the calling process may use, 1 if
+// the kernel has no NUMA support.
+GPCL_DECL int numa_node_count() noexcept;
+
+// \returns The node of the CPU the calling thread runs on.
+GPCL_DECL int numa_current_node() noexcept;
+
+// \returns The node holding the page at p, or -1 if p is not mapped or the
+// kernel has no NUMA support.
+GPCL_DECL int numa_node_of(const void *p) noexcept;
+
+// Sets the memory policy of the pages in [p, p + size) to node. p must be
+// page aligned.
+//
+// \returns 0 on success, otherwise an errno value.
+GPCL_DECL int numa_bind(void *p, std::size_t size, int node,
+                        bool strict) noexcept;
+
+} // namespace detail
+} // namespace gpcl
+
+#endif // GPCL_POSIX
+
+#ifdef GPCL_HEADER_ONLY
+#  include <gpcl/detail/impl/posix_numa.ipp>
+#endif
+
+#endif // GPCL_DETAIL_POSIX_NUMA_HPP
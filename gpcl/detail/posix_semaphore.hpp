@@ -12,6 +12,7 @@
 #define GPCL_DETAIL_POSIX_SEMAPHORE_HPP
 
 #include <gpcl/detail/config.hpp>
+#include <gpcl/time.hpp>
 
 #if defined(GPCL_POSIX)
 #include <semaphore.h>
@@ -35,6 +36,8 @@ public:
 
   GPCL_DECL bool try_wait();
 
+  GPCL_DECL bool try_wait_until(const instant &deadline);
+
   using native_handle_type = sem_t *;
   auto native_handle() -> native_handle_type { return &sem_; }
 
@@ -0,0 +1,128 @@
+//
+// posix_shared_memory.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2020 Zhengyi Fu (tsingyat at outlook dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef GPCL_DETAIL_POSIX_SHARED_MEMORY_HPP
+#define GPCL_DETAIL_POSIX_SHARED_MEMORY_HPP
+
+#include <gpcl/creation_tag.hpp>
+#include <gpcl/detail/config.hpp>
+#include <gpcl/detail/error.hpp>
+#include <gpcl/time.hpp>
+#include <gpcl/zstring.hpp>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <system_error>
+#include <utility>
+
+#ifdef GPCL_POSIX
+#  include <sched.h>
+
+namespace gpcl {
+namespace detail {
+
+// A POSIX shared memory object (shm_open) mapped into the address space.
+class posix_shared_memory
+{
+public:
+  GPCL_DECL posix_shared_memory(create_only_t, czstring<> name,
+                                std::size_t size);
+
+  // Opens the object if it exists, otherwise creates it with the given size.
+  GPCL_DECL posix_shared_memory(open_or_create_t, czstring<> name,
+                                std::size_t size);
+
+  // Waits until the creator has set the size of the object, for at most
+  // shm_creator_timeout_millis.
+  GPCL_DECL posix_shared_memory(open_only_t, czstring<> name);
+
+  posix_shared_memory(posix_shared_memory &&other) noexcept
+      : addr_(std::exchange(other.addr_, nullptr)),
+        size_(std::exchange(other.size_, 0)),
+        created_(other.created_)
+  {
+  }
+
+  posix_shared_memory &operator=(posix_shared_memory &&other) noexcept
+  {
+    std::swap(addr_, other.addr_);
+    std::swap(size_, other.size_);
+    std::swap(created_, other.created_);
+    return *this;
+  }
+
+  GPCL_DECL ~posix_shared_memory() noexcept;
+
+  GPCL_DECL static void unlink(czstring<> name, std::error_code &ec);
+
+  static void unlink(czstring<> name)
+  {
+    std::error_code ec;
+    posix_shared_memory::unlink(name, ec);
+    if (ec)
+      GPCL_THROW(std::system_error(ec, __PRETTY_FUNCTION__));
+  }
+
+  void *address() const noexcept { return addr_; }
+
+  std::size_t size() const noexcept { return size_; }
+
+  // Whether this object created the shared memory object.
+  bool created() const noexcept { return created_; }
+
+private:
+  // These take ownership of fd.
+  GPCL_DECL void create(int fd, czstring<> name, std::size_t size);
+
+  GPCL_DECL void open(int fd);
+
+  // Returns 0 or the errno of mmap().
+  GPCL_DECL int map(int fd, std::size_t size) noexcept;
+
+  void *addr_{};
+  std::size_t size_{};
+  bool created_{};
+};
+
+// How long opening a shared object waits for its creator to size and set
+// it up. A creator that takes longer has most likely died half way.
+constexpr std::uint64_t shm_creator_timeout_millis = 5000;
+
+// Yields until ready() holds, which the process that created a shared
+// object makes true once the object is set up.
+//
+// \throws std::system_error with ETIMEDOUT, naming what, if ready() does
+// not hold within timeout.
+template <typename Predicate>
+void wait_for_creator(
+    Predicate ready, const char *what,
+    duration timeout = duration::from_millis(shm_creator_timeout_millis))
+{
+  if (ready())
+    return;
+  instant deadline = instant::now().saturating_add(timeout);
+  while (!ready())
+  {
+    if (!(instant::now() < deadline))
+      throw_system_error(ETIMEDOUT, what);
+    ::sched_yield();
+  }
+}
+
+} // namespace detail
+} // namespace gpcl
+
+#endif // GPCL_POSIX
+
+#ifdef GPCL_HEADER_ONLY
+#  include <gpcl/detail/impl/posix_shared_memory.ipp>
+#endif
+
+#endif // GPCL_DETAIL_POSIX_SHARED_MEMORY_HPP
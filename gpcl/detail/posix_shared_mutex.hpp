@@ -0,0 +1,75 @@
+//
+// posix_shared_mutex.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2020 Zhengyi Fu (tsingyat at outlook dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef GPCL_DETAIL_POSIX_SHARED_MUTEX_HPP
+#define GPCL_DETAIL_POSIX_SHARED_MUTEX_HPP
+
+#include <gpcl/detail/config.hpp>
+#include <gpcl/detail/posix_clock.hpp>
+
+#ifdef GPCL_POSIX
+#include <pthread.h>
+
+namespace gpcl {
+namespace detail {
+
+// A pthread read-write lock that prefers writers, so that a steady stream
+// of readers cannot starve them.
+class posix_shared_mutex {
+public:
+  using native_handle_type = pthread_rwlock_t *;
+
+  GPCL_DECL posix_shared_mutex();
+
+  posix_shared_mutex(const posix_shared_mutex &) = delete;
+  posix_shared_mutex &operator=(const posix_shared_mutex &) = delete;
+
+  GPCL_DECL ~posix_shared_mutex();
+
+  GPCL_DECL void lock();
+
+  GPCL_DECL void unlock();
+
+  GPCL_DECL bool try_lock();
+
+  GPCL_DECL bool try_lock_for(realtime_clock::duration dur);
+
+  GPCL_DECL bool try_lock_until(realtime_clock::time_point tp);
+
+  GPCL_DECL bool try_lock_until(const instant &deadline);
+
+  GPCL_DECL void lock_shared();
+
+  GPCL_DECL void unlock_shared();
+
+  GPCL_DECL bool try_lock_shared();
+
+  GPCL_DECL bool try_lock_shared_for(realtime_clock::duration dur);
+
+  GPCL_DECL bool try_lock_shared_until(realtime_clock::time_point tp);
+
+  GPCL_DECL bool try_lock_shared_until(const instant &deadline);
+
+  native_handle_type native_handle() noexcept { return &rwlock_; }
+
+private:
+  pthread_rwlock_t rwlock_{};
+};
+
+} // namespace detail
+} // namespace gpcl
+
+#endif
+
+#if defined(GPCL_HEADER_ONLY)
+#include <gpcl/detail/impl/posix_shared_mutex.ipp>
+#endif
+
+#endif
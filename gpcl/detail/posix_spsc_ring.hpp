@@ -0,0 +1,161 @@
+//
+// posix_spsc_ring.hpp
+// ~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2020 Zhengyi Fu (tsingyat at outlook dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef GPCL_DETAIL_POSIX_SPSC_RING_HPP
+#define GPCL_DETAIL_POSIX_SPSC_RING_HPP
+
+#include <gpcl/creation_tag.hpp>
+#include <gpcl/detail/config.hpp>
+#include <gpcl/detail/futex.hpp>
+#include <gpcl/detail/posix_shared_memory.hpp>
+#include <gpcl/span.hpp>
+#include <gpcl/zstring.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <system_error>
+
+#ifdef GPCL_POSIX
+
+namespace gpcl {
+namespace detail {
+
+// A single-producer/single-consumer ring of variable-length records in a
+// shared memory object.
+//
+// Positions grow monotonically and are reduced modulo the capacity, which
+// is a power of two. Every record starts with a record_header and is padded
+// to record_align bytes; a record never wraps around, the producer fills
+// the rest of the buffer with a padding record instead.
+class posix_spsc_ring
+{
+public:
+  using size_type = std::size_t;
+
+  GPCL_DECL posix_spsc_ring(create_only_t, czstring<> name,
+                            std::size_t capacity);
+  GPCL_DECL posix_spsc_ring(open_or_create_t, czstring<> name,
+                            std::size_t capacity);
+  GPCL_DECL posix_spsc_ring(open_only_t, czstring<> name);
+
+  posix_spsc_ring(posix_spsc_ring &&) noexcept = default;
+
+  static void unlink(czstring<> name, std::error_code &ec)
+  {
+    posix_shared_memory::unlink(name, ec);
+  }
+
+  static void unlink(czstring<> name) { posix_shared_memory::unlink(name); }
+
+  std::size_t capacity() const noexcept { return mask_ + 1; }
+
+  // A message and its padding never take more than half of the ring, so
+  // that a record fits after a padding record.
+  std::size_t max_msg_size() const noexcept
+  {
+    return (std::min)(capacity() / 2, std::size_t(UINT32_MAX)) -
+           sizeof(record_header);
+  }
+
+  // Copies msg into the ring without making it visible to the consumer.
+  // Returns false if there is no room.
+  GPCL_DECL bool try_write(span<const char> msg, std::error_code &ec);
+
+  // Makes the records written since the last commit visible.
+  GPCL_DECL void commit() noexcept;
+
+  GPCL_DECL void send(span<const char> msg, std::error_code &ec);
+
+  // Returns false if the ring is empty. Fails with EMSGSIZE, leaving the
+  // record in the ring, if msg is too small for it.
+  GPCL_DECL bool try_receive(span<char> msg, std::size_t &len,
+                             std::error_code &ec);
+
+  GPCL_DECL std::size_t receive(span<char> msg, std::error_code &ec);
+
+private:
+  struct record_header
+  {
+    std::uint32_t size;
+    std::uint32_t flags;
+  };
+
+  static constexpr std::size_t record_align = sizeof(record_header);
+  static constexpr std::uint32_t padding_record = 1;
+
+  // The two halves are written by different processes, so keep them on
+  // separate cache lines.
+  struct ring_header
+  {
+    std::atomic<std::uint32_t> magic;
+    std::uint32_t reserved;
+    std::uint64_t capacity;
+
+    // Written by the producer.
+    alignas(GPCL_CACHELINE_SIZE) std::atomic<std::uint64_t> write_pos;
+    futex_word write_seq;
+    futex_word consumer_waiting;
+
+    // Written by the consumer.
+    alignas(GPCL_CACHELINE_SIZE) std::atomic<std::uint64_t> read_pos;
+    futex_word read_seq;
+    futex_word producer_waiting;
+  };
+
+  static constexpr std::size_t data_offset =
+      (sizeof(ring_header) + GPCL_CACHELINE_SIZE - 1) / GPCL_CACHELINE_SIZE *
+      GPCL_CACHELINE_SIZE;
+
+  // Size of the shared memory object of a ring of at least capacity bytes.
+  GPCL_DECL static std::size_t shm_size(std::size_t capacity) noexcept;
+
+  // Formats the ring if this object created it, otherwise waits until the
+  // creator has.
+  GPCL_DECL void init();
+
+  // Publishes the consumer position pos and wakes a waiting producer.
+  GPCL_DECL void release(std::uint64_t pos) noexcept;
+
+  // Sleep until the other side has made progress, or spuriously.
+  GPCL_DECL void wait_for_space() noexcept;
+
+  GPCL_DECL void wait_for_data() noexcept;
+
+  ring_header *header() const noexcept
+  {
+    return static_cast<ring_header *>(shm_.address());
+  }
+
+  char *data() const noexcept
+  {
+    return static_cast<char *>(shm_.address()) + data_offset;
+  }
+
+  posix_shared_memory shm_;
+  std::uint64_t mask_{};
+
+  // Producer: position of the next record, and the last read_pos seen.
+  std::uint64_t write_pos_{};
+  std::uint64_t cached_read_pos_{};
+
+  // Consumer: the last write_pos seen.
+  std::uint64_t cached_write_pos_{};
+};
+
+} // namespace detail
+} // namespace gpcl
+
+#endif // GPCL_POSIX
+
+#ifdef GPCL_HEADER_ONLY
+#  include <gpcl/detail/impl/posix_spsc_ring.ipp>
+#endif
+
+#endif // GPCL_DETAIL_POSIX_SPSC_RING_HPP
@@ -0,0 +1,127 @@
+//
+// segment_manager.hpp
+// ~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2020 Zhengyi Fu (tsingyat at outlook dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef GPCL_DETAIL_SEGMENT_MANAGER_HPP
+#define GPCL_DETAIL_SEGMENT_MANAGER_HPP
+
+#include <gpcl/detail/config.hpp>
+#include <gpcl/detail/posix_mutex.hpp>
+#include <gpcl/noncopyable.hpp>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#ifdef GPCL_POSIX
+
+namespace gpcl {
+namespace detail {
+
+// The bookkeeping of a managed shared memory segment, placed at its start.
+//
+// Every link is an offset from the manager, so the segment may be mapped at
+// different addresses in different processes. Free memory is an
+// address-ordered first-fit list whose neighbouring blocks are coalesced.
+// Named objects are kept in a singly linked list.
+class segment_manager : noncopyable
+{
+public:
+  using mutex_type = posix_interprocess_mutex;
+
+  // Formats a segment of size bytes that starts at this.
+  GPCL_DECL explicit segment_manager(std::size_t size);
+
+  // \returns The manager of a segment formatted by another process, once
+  // the formatting is complete.
+  //
+  // \throws std::system_error with ETIMEDOUT if the segment is still not
+  // formatted after shm_creator_timeout_millis.
+  GPCL_DECL static segment_manager *attach(void *segment);
+
+  // \returns Memory for bytes bytes aligned to alignment, or null.
+  GPCL_DECL void *allocate(std::size_t bytes, std::size_t alignment);
+
+  GPCL_DECL void deallocate(void *p);
+
+  std::size_t size() const noexcept { return size_; }
+
+  // The number of free bytes, block headers included.
+  GPCL_DECL std::size_t free_memory() const;
+
+  // The functions below require the mutex to be held.
+
+  // Checks the free list and the directory if a process died holding the
+  // mutex, and accepts them again if they are intact.
+  //
+  // \throws std::system_error with EOWNERDEAD if they are damaged; the
+  // segment is then refused from now on.
+  GPCL_DECL void recover() const;
+
+  GPCL_DECL void *find_named(const char *name, std::size_t size,
+                             std::size_t alignment) const noexcept;
+
+  // \returns false if out of memory.
+  GPCL_DECL bool insert_named(const char *name, void *object,
+                              std::size_t size,
+                              std::size_t alignment) noexcept;
+
+  // \returns The object, or null if there is none named name.
+  GPCL_DECL void *erase_named(const char *name) noexcept;
+
+  mutex_type &mutex() noexcept { return mtx_; }
+
+private:
+  struct free_block;
+  struct block_header;
+  struct named_entry;
+
+  template <typename T>
+  T *at(std::size_t offset) const noexcept
+  {
+    return reinterpret_cast<T *>(
+        reinterpret_cast<std::uintptr_t>(this) + offset);
+  }
+
+  std::size_t offset_of(const void *p) const noexcept
+  {
+    return reinterpret_cast<std::uintptr_t>(p) -
+           reinterpret_cast<std::uintptr_t>(this);
+  }
+
+  GPCL_DECL void *allocate_unlocked(std::size_t bytes,
+                                    std::size_t alignment) noexcept;
+
+  GPCL_DECL void deallocate_unlocked(void *p) noexcept;
+
+  GPCL_DECL named_entry *find_entry(const char *name) const noexcept;
+
+  GPCL_DECL bool consistent() const noexcept;
+
+  // Set last while formatting; attach() waits for it.
+  std::atomic<std::uint32_t> magic_;
+
+  mutable mutex_type mtx_;
+  std::size_t size_;
+  std::size_t free_bytes_;
+
+  // Offsets of the first free block and the first named entry, 0 for none.
+  std::size_t free_list_{};
+  std::size_t directory_{};
+};
+
+} // namespace detail
+} // namespace gpcl
+
+#endif // GPCL_POSIX
+
+#ifdef GPCL_HEADER_ONLY
+#  include <gpcl/detail/impl/segment_manager.ipp>
+#endif
+
+#endif // GPCL_DETAIL_SEGMENT_MANAGER_HPP
@@ -0,0 +1,156 @@
+//
+// tagged_free_list.hpp
+// ~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2020 Zhengyi Fu (tsingyat at outlook dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef GPCL_DETAIL_TAGGED_FREE_LIST_HPP
+#define GPCL_DETAIL_TAGGED_FREE_LIST_HPP
+
+#include <gpcl/assert.hpp>
+#include <gpcl/detail/config.hpp>
+#include <gpcl/noncopyable.hpp>
+#include <atomic>
+#include <cstdint>
+
+#if !defined(GPCL_TAGGED_PTR_DOUBLE_WIDTH)
+#  if !(defined(__x86_64__) || defined(__aarch64__))
+#    define GPCL_TAGGED_PTR_DOUBLE_WIDTH 1
+#  endif
+#endif
+
+namespace gpcl {
+namespace detail {
+
+#if !defined(GPCL_TAGGED_PTR_DOUBLE_WIDTH)
+
+// Pointer and version counter packed in one word. User space addresses fit in
+// the lower 48 bits, the upper 16 bits hold the counter.
+class tagged_ptr
+{
+public:
+  using tag_type = std::uint16_t;
+
+  tagged_ptr() = default;
+
+  tagged_ptr(void *ptr, tag_type tag) noexcept
+      : value_(reinterpret_cast<std::uint64_t>(ptr) |
+               (std::uint64_t(tag) << 48))
+  {
+    GPCL_ASSERT((reinterpret_cast<std::uint64_t>(ptr) >> 48) == 0);
+  }
+
+  void *ptr() const noexcept
+  {
+    return reinterpret_cast<void *>(value_ & ((std::uint64_t(1) << 48) - 1));
+  }
+
+  tag_type tag() const noexcept { return tag_type(value_ >> 48); }
+
+private:
+  std::uint64_t value_{};
+};
+
+#else
+
+// Pointer and version counter updated with a double-width CAS.
+class alignas(2 * sizeof(void *)) tagged_ptr
+{
+public:
+  using tag_type = std::uintptr_t;
+
+  tagged_ptr() = default;
+
+  tagged_ptr(void *ptr, tag_type tag) noexcept : ptr_(ptr), tag_(tag) {}
+
+  void *ptr() const noexcept { return ptr_; }
+
+  tag_type tag() const noexcept { return tag_; }
+
+private:
+  void *ptr_{};
+  tag_type tag_{};
+};
+
+#endif
+
+// Treiber stack of chunks linked through their first word.
+//
+// Every successful update bumps the version counter of the head, so a pop
+// whose head was popped and pushed again in the meantime fails its CAS
+// instead of installing a stale next pointer (the ABA problem).
+//
+// Popping reads the first word of a chunk that another thread may already
+// have taken. The chunks must therefore stay mapped for the lifetime of the
+// list, which holds for pool blocks.
+class tagged_free_list : noncopyable
+{
+public:
+  tagged_free_list() = default;
+
+  // \returns true if the head can be updated without a lock.
+  bool is_lock_free() const noexcept { return head_.is_lock_free(); }
+
+  void push(void *chunk) noexcept { push_chain(chunk, chunk); }
+
+  // Pushes the chunks [first, last] linked through their first word.
+  void push_chain(void *first, void *last) noexcept
+  {
+    GPCL_ASSERT(first && last);
+    tagged_ptr old_head = head_.load(std::memory_order_relaxed);
+    tagged_ptr new_head;
+    do
+    {
+      store_next(last, old_head.ptr());
+      new_head = tagged_ptr(first, tagged_ptr::tag_type(old_head.tag() + 1));
+    } while (!head_.compare_exchange_weak(old_head, new_head,
+                                          std::memory_order_release,
+                                          std::memory_order_relaxed));
+  }
+
+  // \returns null if the list is empty.
+  void *pop() noexcept
+  {
+    tagged_ptr old_head = head_.load(std::memory_order_acquire);
+    while (void *chunk = old_head.ptr())
+    {
+      tagged_ptr new_head(load_next(chunk),
+                          tagged_ptr::tag_type(old_head.tag() + 1));
+      if (head_.compare_exchange_weak(old_head, new_head,
+                                      std::memory_order_acquire,
+                                      std::memory_order_acquire))
+        return chunk;
+    }
+    return nullptr;
+  }
+
+private:
+  static void *load_next(void *chunk) noexcept
+  {
+#ifdef __GNUC__
+    return __atomic_load_n(static_cast<void **>(chunk), __ATOMIC_RELAXED);
+#else
+    return *static_cast<void *volatile *>(chunk);
+#endif
+  }
+
+  static void store_next(void *chunk, void *next) noexcept
+  {
+#ifdef __GNUC__
+    __atomic_store_n(static_cast<void **>(chunk), next, __ATOMIC_RELAXED);
+#else
+    *static_cast<void *volatile *>(chunk) = next;
+#endif
+  }
+
+  std::atomic<tagged_ptr> head_{};
+};
+
+} // namespace detail
+} // namespace gpcl
+
+#endif // GPCL_DETAIL_TAGGED_FREE_LIST_HPP
@@ -0,0 +1,159 @@
+//
+// thread_cache.hpp
+// ~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2020 Zhengyi Fu (tsingyat at outlook dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef GPCL_DETAIL_THREAD_CACHE_HPP
+#define GPCL_DETAIL_THREAD_CACHE_HPP
+
+#include <gpcl/assert.hpp>
+#include <gpcl/detail/config.hpp>
+#include <gpcl/noncopyable.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace gpcl {
+namespace detail {
+
+class thread_cache_owner;
+
+// Free chunks cached by one thread on behalf of one owner. The chunks are
+// linked through their first word.
+struct thread_cache_magazine
+{
+  void *head;
+  std::size_t count;
+
+  // Null once the owner has been destroyed.
+  thread_cache_owner *owner;
+  std::uint64_t owner_id;
+
+  // Links in the owner's list of magazines.
+  thread_cache_magazine *prev;
+  thread_cache_magazine *next;
+};
+
+// Per-thread table of magazines, indexed by owner slot.
+struct thread_cache_table : noncopyable
+{
+  thread_cache_table() = default;
+
+  // Returns every cached chunk to its owner.
+  GPCL_DECL ~thread_cache_table();
+
+  std::vector<thread_cache_magazine *> slots;
+};
+
+inline thread_cache_table &this_thread_cache_table() noexcept
+{
+  static thread_local thread_cache_table table;
+  return table;
+}
+
+// Shared storage fronted by per-thread magazines.
+//
+// Each thread owns one magazine per owner. Allocation and deallocation touch
+// only the calling thread's magazine; the shared storage is reached through
+// the refill and drain callbacks, one batch of chunks at a time. A magazine
+// never holds more than max_cached chunks.
+//
+// Magazines are attached, detached and orphaned under a process-wide mutex,
+// which is never taken on the fast path.
+class thread_cache_owner : noncopyable
+{
+public:
+  // Returns the chunks in [first, last] to the shared storage.
+  using drain_function = void (*)(void *context, void *first, void *last);
+
+  GPCL_DECL thread_cache_owner(std::size_t batch_size, std::size_t max_cached,
+                               drain_function drain, void *context);
+
+  // Orphans the magazines of all threads. Their chunks are dropped; the
+  // shared storage is expected to reclaim the memory.
+  GPCL_DECL ~thread_cache_owner();
+
+  std::size_t batch_size() const noexcept { return batch_size_; }
+
+  std::size_t max_cached() const noexcept { return max_cached_; }
+
+  // Pops a chunk from the calling thread's magazine.
+  //
+  // \returns null if the magazine is empty.
+  GPCL_DECL_INLINE void *try_pop()
+  {
+    thread_cache_magazine *m = local_magazine();
+    void *chunk = m->head;
+    if (chunk)
+    {
+      m->head = *static_cast<void **>(chunk);
+      --m->count;
+    }
+    return chunk;
+  }
+
+  // Pushes a chunk to the calling thread's magazine, draining a batch back to
+  // the shared storage if the magazine grows beyond max_cached chunks.
+  GPCL_DECL_INLINE void push(void *chunk)
+  {
+    GPCL_ASSERT(chunk);
+    thread_cache_magazine *m = local_magazine();
+    *static_cast<void **>(chunk) = m->head;
+    m->head = chunk;
+    if (++m->count > max_cached_)
+      drain(m, batch_size_);
+  }
+
+  // Stores a list of n chunks obtained from the shared storage in the calling
+  // thread's magazine and pops the first one.
+  GPCL_DECL void *refill(void *first, std::size_t n);
+
+  // Returns all chunks cached by the calling thread to the shared storage.
+  GPCL_DECL void flush();
+
+private:
+  friend struct thread_cache_table;
+
+  GPCL_DECL_INLINE thread_cache_magazine *local_magazine()
+  {
+    thread_cache_table &table = this_thread_cache_table();
+    if (slot_ < table.slots.size())
+    {
+      thread_cache_magazine *m = table.slots[slot_];
+      if (m && m->owner_id == id_)
+        return m;
+    }
+    return attach(table);
+  }
+
+  // Creates the calling thread's magazine.
+  GPCL_DECL thread_cache_magazine *attach(thread_cache_table &table);
+
+  // Returns up to n chunks from the front of m to the shared storage.
+  GPCL_DECL void drain(thread_cache_magazine *m, std::size_t n) noexcept;
+
+  const std::size_t batch_size_;
+  const std::size_t max_cached_;
+  const drain_function drain_;
+  void *const context_;
+
+  std::size_t slot_;
+  std::uint64_t id_;
+
+  // Magazines of all threads, guarded by the process-wide mutex.
+  thread_cache_magazine *magazines_{};
+};
+
+} // namespace detail
+} // namespace gpcl
+
+#if defined(GPCL_HEADER_ONLY)
+#  include <gpcl/detail/impl/thread_cache.ipp>
+#endif
+
+#endif // GPCL_DETAIL_THREAD_CACHE_HPP
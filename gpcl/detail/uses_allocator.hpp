@@ -0,0 +1,155 @@
+//
+// uses_allocator.hpp
+// ~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2020 Zhengyi Fu (tsingyat at outlook dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef GPCL_DETAIL_USES_ALLOCATOR_HPP
+#define GPCL_DETAIL_USES_ALLOCATOR_HPP
+
+#include <gpcl/detail/config.hpp>
+#include <memory>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace gpcl {
+namespace detail {
+
+// Uses-allocator construction as specified by C++20
+// [allocator.uses.construction], which C++17 does not provide.
+
+template <typename T>
+struct is_pair : std::false_type
+{
+};
+
+template <typename T1, typename T2>
+struct is_pair<std::pair<T1, T2>> : std::true_type
+{
+};
+
+/// \returns The arguments that construct a T from args using the allocator
+/// alloc, as a tuple of references.
+template <typename T, typename Alloc, typename... Args,
+          std::enable_if_t<!is_pair<T>::value, int> = 0>
+auto uses_allocator_construction_args(const Alloc &alloc, Args &&... args)
+{
+  if constexpr (!std::uses_allocator<T, Alloc>::value)
+  {
+    (void)alloc;
+    return std::forward_as_tuple(std::forward<Args>(args)...);
+  }
+  else if constexpr (std::is_constructible<T, std::allocator_arg_t,
+                                           const Alloc &, Args...>::value)
+  {
+    return std::tuple<std::allocator_arg_t, const Alloc &, Args &&...>(
+        std::allocator_arg, alloc, std::forward<Args>(args)...);
+  }
+  else
+  {
+    static_assert(std::is_constructible<T, Args..., const Alloc &>::value,
+                  "T uses the allocator but cannot be constructed with it");
+    return std::forward_as_tuple(std::forward<Args>(args)..., alloc);
+  }
+}
+
+template <typename T, typename Alloc, typename Tuple1, typename Tuple2,
+          std::enable_if_t<is_pair<T>::value, int> = 0>
+auto uses_allocator_construction_args(const Alloc &alloc,
+                                      std::piecewise_construct_t, Tuple1 &&x,
+                                      Tuple2 &&y)
+{
+  using T1 = typename T::first_type;
+  using T2 = typename T::second_type;
+  return std::make_tuple(
+      std::piecewise_construct,
+      std::apply(
+          [&alloc](auto &&... xs) {
+            return uses_allocator_construction_args<T1>(
+                alloc, std::forward<decltype(xs)>(xs)...);
+          },
+          std::forward<Tuple1>(x)),
+      std::apply(
+          [&alloc](auto &&... ys) {
+            return uses_allocator_construction_args<T2>(
+                alloc, std::forward<decltype(ys)>(ys)...);
+          },
+          std::forward<Tuple2>(y)));
+}
+
+template <typename T, typename Alloc,
+          std::enable_if_t<is_pair<T>::value, int> = 0>
+auto uses_allocator_construction_args(const Alloc &alloc)
+{
+  return uses_allocator_construction_args<T>(alloc, std::piecewise_construct,
+                                             std::tuple<>(), std::tuple<>());
+}
+
+template <typename T, typename Alloc, typename U, typename V,
+          std::enable_if_t<is_pair<T>::value, int> = 0>
+auto uses_allocator_construction_args(const Alloc &alloc, U &&u, V &&v)
+{
+  return uses_allocator_construction_args<T>(
+      alloc, std::piecewise_construct,
+      std::forward_as_tuple(std::forward<U>(u)),
+      std::forward_as_tuple(std::forward<V>(v)));
+}
+
+template <typename T, typename Alloc, typename U, typename V,
+          std::enable_if_t<is_pair<T>::value, int> = 0>
+auto uses_allocator_construction_args(const Alloc &alloc,
+                                      const std::pair<U, V> &pr)
+{
+  return uses_allocator_construction_args<T>(
+      alloc, std::piecewise_construct, std::forward_as_tuple(pr.first),
+      std::forward_as_tuple(pr.second));
+}
+
+template <typename T, typename Alloc, typename U, typename V,
+          std::enable_if_t<is_pair<T>::value, int> = 0>
+auto uses_allocator_construction_args(const Alloc &alloc, std::pair<U, V> &&pr)
+{
+  return uses_allocator_construction_args<T>(
+      alloc, std::piecewise_construct,
+      std::forward_as_tuple(std::get<0>(std::move(pr))),
+      std::forward_as_tuple(std::get<1>(std::move(pr))));
+}
+
+// A non-const lvalue pair would otherwise pick the (U &&, V &&) overload.
+template <typename T, typename Alloc, typename U, typename V,
+          std::enable_if_t<is_pair<T>::value, int> = 0>
+auto uses_allocator_construction_args(const Alloc &alloc, std::pair<U, V> &pr)
+{
+  return uses_allocator_construction_args<T>(
+      alloc, static_cast<const std::pair<U, V> &>(pr));
+}
+
+template <typename T, typename Tuple, std::size_t... I>
+T *construct_from_tuple(T *p, Tuple &&args, std::index_sequence<I...>)
+{
+  return ::new (static_cast<void *>(p))
+      T(std::get<I>(std::forward<Tuple>(args))...);
+}
+
+/// \effects Constructs a T at p from args using the allocator alloc.
+template <typename T, typename Alloc, typename... Args>
+T *uninitialized_construct_using_allocator(T *p, const Alloc &alloc,
+                                           Args &&... args)
+{
+  auto t = uses_allocator_construction_args<T>(alloc,
+                                               std::forward<Args>(args)...);
+  return construct_from_tuple(
+      p, std::move(t),
+      std::make_index_sequence<std::tuple_size<decltype(t)>::value>());
+}
+
+} // namespace detail
+} // namespace gpcl
+
+#endif // GPCL_DETAIL_USES_ALLOCATOR_HPP
@@ -0,0 +1,151 @@
+//
+// work_stealing_deque.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2020 Zhengyi Fu (tsingyat at outlook dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef GPCL_DETAIL_WORK_STEALING_DEQUE_HPP
+#define GPCL_DETAIL_WORK_STEALING_DEQUE_HPP
+
+#include <gpcl/assert.hpp>
+#include <gpcl/detail/config.hpp>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace gpcl {
+namespace detail {
+
+// The Chase-Lev deque of pointers, after "Correct and Efficient Work-Stealing
+// for Weak Memory Models" by Lê, Pop, Cohen and Zappa Nardelli. Its owner
+// pushes and pops at the bottom, like a stack; any other thread may steal
+// from the top. Only a steal racing for the last element costs a CAS.
+//
+// The array grows when full. Thieves may still read an old array, so old
+// arrays are kept until the deque is destroyed.
+//
+// The accesses to top_ and bottom_ are sequentially consistent rather than
+// fenced as in the paper, which costs the same on x86 and is understood by
+// ThreadSanitizer.
+template <typename T>
+class work_stealing_deque
+{
+public:
+  explicit work_stealing_deque(std::size_t capacity = 256)
+  {
+    std::size_t n = 2;
+    while (n < capacity)
+      n *= 2;
+    arrays_.emplace_back(new array(n));
+    array_.store(arrays_.back().get(), std::memory_order_relaxed);
+  }
+
+  work_stealing_deque(const work_stealing_deque &) = delete;
+  work_stealing_deque &operator=(const work_stealing_deque &) = delete;
+
+  // Pushes p at the bottom. Only the owner may call it.
+  void push(T *p)
+  {
+    std::int64_t b = bottom_.load(std::memory_order_relaxed);
+    std::int64_t t = top_.load(std::memory_order_acquire);
+    array *a = array_.load(std::memory_order_relaxed);
+    if (b - t > static_cast<std::int64_t>(a->mask))
+      a = grow(a, t, b);
+    a->put(b, p);
+    bottom_.store(b + 1);
+  }
+
+  // Pops the bottom element. Only the owner may call it.
+  //
+  // Returns null if the deque is empty.
+  T *pop() noexcept
+  {
+    std::int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+    array *a = array_.load(std::memory_order_relaxed);
+    bottom_.store(b);
+    std::int64_t t = top_.load();
+    if (t > b)
+    {
+      bottom_.store(b + 1, std::memory_order_relaxed);
+      return nullptr;
+    }
+    T *p = a->get(b);
+    if (t == b)
+    {
+      // The last element: race the thieves for it.
+      if (!top_.compare_exchange_strong(t, t + 1))
+        p = nullptr;
+      bottom_.store(b + 1, std::memory_order_relaxed);
+    }
+    return p;
+  }
+
+  // Steals the top element. Any thread may call it.
+  //
+  // Returns null if the deque is empty or another thread won the element.
+  T *steal() noexcept
+  {
+    std::int64_t t = top_.load();
+    std::int64_t b = bottom_.load();
+    if (t >= b)
+      return nullptr;
+    T *p = array_.load(std::memory_order_acquire)->get(t);
+    if (!top_.compare_exchange_strong(t, t + 1))
+      return nullptr;
+    return p;
+  }
+
+  // Whether the deque looked empty.
+  bool empty() const noexcept { return top_.load() >= bottom_.load(); }
+
+private:
+  struct array
+  {
+    explicit array(std::size_t n) : mask(n - 1), slots(new std::atomic<T *>[n])
+    {
+    }
+
+    T *get(std::int64_t i) const noexcept
+    {
+      return slots[static_cast<std::size_t>(i) & mask].load(
+          std::memory_order_relaxed);
+    }
+
+    void put(std::int64_t i, T *p) noexcept
+    {
+      slots[static_cast<std::size_t>(i) & mask].store(
+          p, std::memory_order_relaxed);
+    }
+
+    const std::size_t mask;
+    std::unique_ptr<std::atomic<T *>[]> slots;
+  };
+
+  array *grow(array *a, std::int64_t t, std::int64_t b)
+  {
+    arrays_.emplace_back(new array((a->mask + 1) * 2));
+    array *bigger = arrays_.back().get();
+    for (std::int64_t i = t; i < b; ++i)
+      bigger->put(i, a->get(i));
+    array_.store(bigger, std::memory_order_release);
+    return bigger;
+  }
+
+  alignas(GPCL_CACHELINE_SIZE) std::atomic<std::int64_t> top_{0};
+  alignas(GPCL_CACHELINE_SIZE) std::atomic<std::int64_t> bottom_{0};
+  std::atomic<array *> array_;
+
+  // Every array allocated so far, the current one last.
+  std::vector<std::unique_ptr<array>> arrays_;
+};
+
+} // namespace detail
+} // namespace gpcl
+
+#endif // GPCL_DETAIL_WORK_STEALING_DEQUE_HPP
@@ -13,14 +13,19 @@
 
 #include <gpcl/condition_variable.hpp>
 #include <gpcl/detail/config.hpp>
+#include <gpcl/detail/chrono.hpp>
 #include <gpcl/mutex.hpp>
 #include <gpcl/noncopyable.hpp>
+#include <gpcl/time.hpp>
 #include <gpcl/unique_lock.hpp>
 #include <gpcl/assert.hpp>
 
 namespace gpcl {
 
 /// A never-spurious-wakeup condition variable.
+///
+/// All waiters woken by signal_all() take the same mutex again; fast_event
+/// has no mutex and avoids that.
 class event : noncopyable {
 public:
 
@@ -117,35 +122,63 @@ public:
     }
   }
 
-  /// Wait for signaling.
-  template <typename Rep, typename Clock>
-  bool wait_for(
-      unique_lock<mutex> &lock,
-      chrono::duration<Rep, Clock> const &timeout)
+#if defined(GPCL_POSIX)
+  /// Wait for signaling until deadline at the latest.
+  ///
+  /// \returns Whether the event is signaled.
+  bool wait_until(unique_lock<mutex> &lock, const instant &deadline)
   {
     GPCL_ASSERT(lock.owns_lock());
-    if (!signaled_)
+    while (!signaled_)
     {
       waiter w(this);
-      cond_.wait_for(lock, timeout);
+      if (cond_.wait_until(lock, deadline) == cv_status::timeout)
+        break;
     }
     return signaled_;
   }
 
-  /// Wait for signaling.
-  template <typename Duration, typename Clock>
-  bool wait_until(
-      unique_lock<mutex> &lock,
-      chrono::time_point<Clock, Duration> const& timeout)
+  /// Wait for signaling for at most timeout.
+  ///
+  /// \returns Whether the event is signaled.
+  bool wait_for(unique_lock<mutex> &lock, const duration &timeout)
+  {
+    return wait_until(lock, instant::now().saturating_add(timeout));
+  }
+#elif defined(GPCL_WINDOWS)
+  /// Wait for signaling for at most timeout.
+  ///
+  /// \returns Whether the event is signaled.
+  bool wait_for(unique_lock<mutex> &lock, const duration &timeout)
   {
     GPCL_ASSERT(lock.owns_lock());
     if (!signaled_)
     {
       waiter w(this);
-      cond_.wait_until(lock, timeout);
+      cond_.wait_for(lock, timeout);
     }
     return signaled_;
   }
+#endif
+
+  /// Wait for signaling.
+  template <typename Rep, typename Period>
+  bool wait_for(
+      unique_lock<mutex> &lock,
+      chrono::duration<Rep, Period> const &timeout)
+  {
+    auto ns = chrono::duration_cast<chrono::nanoseconds>(timeout).count();
+    return wait_for(lock, duration::from_nanos(ns > 0 ? u64(ns) : 0));
+  }
+
+  /// Wait for signaling.
+  template <typename Clock, typename Duration>
+  bool wait_until(
+      unique_lock<mutex> &lock,
+      chrono::time_point<Clock, Duration> const& timeout)
+  {
+    return wait_for(lock, timeout - Clock::now());
+  }
 
 private:
   // RAII helper that automatically modifies the waiter count.
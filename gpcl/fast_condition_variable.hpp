@@ -0,0 +1,153 @@
+//
+// fast_condition_variable.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2020 Zhengyi Fu (tsingyat at outlook dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef GPCL_FAST_CONDITION_VARIABLE_HPP
+#define GPCL_FAST_CONDITION_VARIABLE_HPP
+
+#include <gpcl/assert.hpp>
+#include <gpcl/condition_variable.hpp>
+#include <gpcl/detail/config.hpp>
+#include <gpcl/detail/futex.hpp>
+#include <gpcl/fast_mutex.hpp>
+#include <gpcl/noncopyable.hpp>
+#include <gpcl/thread_annotations.hpp>
+#include <gpcl/time.hpp>
+#include <gpcl/unique_lock.hpp>
+#include <atomic>
+#include <cerrno>
+#include <climits>
+#include <cstdint>
+#include <utility>
+
+#ifdef GPCL_POSIX
+
+namespace gpcl {
+
+/// A condition variable for fast_mutex and checked_fast_mutex.
+///
+/// Waiters sleep on a futex holding a sequence number that every
+/// notification increments; notifying a condition variable without waiters
+/// makes no system call.
+///
+/// notify_all() wakes a single waiter and moves the others to sleep on the
+/// mutex, so that they are woken one by one as it is unlocked instead of
+/// all at once only to contend for it.
+///
+/// \requires All threads waiting at the same time use the same mutex.
+class fast_condition_variable : noncopyable
+{
+public:
+  constexpr fast_condition_variable() noexcept = default;
+
+  /// \requires No thread waits on the condition variable.
+  ~fast_condition_variable() { GPCL_ASSERT(waiters_.load() == 0); }
+
+  template <typename Mutex>
+  void wait(unique_lock<Mutex> &lock)
+  {
+    wait_impl(lock, nullptr);
+  }
+
+  template <typename Mutex, typename Predicate>
+  void wait(unique_lock<Mutex> &lock, Predicate pred)
+  {
+    while (!pred())
+      wait(lock);
+  }
+
+  template <typename Mutex>
+  cv_status wait_until(unique_lock<Mutex> &lock, const instant &deadline)
+  {
+    timespec ts = detail::to_timespec(deadline);
+    return wait_impl(lock, &ts);
+  }
+
+  template <typename Mutex, typename Predicate>
+  bool wait_until(unique_lock<Mutex> &lock, const instant &deadline,
+                  Predicate pred)
+  {
+    while (!pred())
+    {
+      if (wait_until(lock, deadline) == cv_status::timeout)
+        return pred();
+    }
+    return true;
+  }
+
+  template <typename Mutex>
+  cv_status wait_for(unique_lock<Mutex> &lock, const duration &rel_time)
+  {
+    return wait_until(lock, instant::now().saturating_add(rel_time));
+  }
+
+  template <typename Mutex, typename Predicate>
+  bool wait_for(unique_lock<Mutex> &lock, const duration &rel_time,
+                Predicate pred)
+  {
+    return wait_until(lock, instant::now().saturating_add(rel_time),
+                      std::move(pred));
+  }
+
+  void notify_one() noexcept
+  {
+    seq_.fetch_add(1);
+    if (waiters_.load() != 0)
+      detail::futex_wake(seq_, 1, false);
+  }
+
+  void notify_all() noexcept
+  {
+    std::uint32_t seq = seq_.fetch_add(1) + 1;
+    if (waiters_.load() == 0)
+      return;
+    // The woken waiter locks the mutex as contended, so its unlock wakes
+    // the next requeued one. If another notification overtook us, every
+    // waiter we could requeue has been woken already.
+    detail::futex_word *m = mutex_.load(std::memory_order_relaxed);
+    if (detail::futex_requeue(seq_, seq, 1, INT_MAX, *m, false) != 0)
+      detail::futex_wake(seq_, INT_MAX, false);
+  }
+
+private:
+  // Waits until deadline, an absolute time of CLOCK_MONOTONIC, if it is not
+  // null.
+  template <typename Mutex>
+  cv_status wait_impl(unique_lock<Mutex> &lock, const timespec *deadline)
+      GPCL_NO_THREAD_SAFETY_ANALYSIS
+  {
+    GPCL_ASSERT(lock.owns_lock());
+
+    // Registering and reading the sequence number under the mutex means a
+    // notification that follows a change made under the mutex is seen.
+    // The mutex is published before the waiter is counted, so a notifier
+    // that sees the waiter sees its mutex too.
+    mutex_.store(lock.mutex().native_handle(), std::memory_order_relaxed);
+    waiters_.fetch_add(1);
+    std::uint32_t seq = seq_.load();
+    lock.mutex().unlock();
+    int err = detail::futex_wait_until(seq_, seq, deadline, false);
+    // We may have been requeued onto the mutex, behind others.
+    lock.mutex().lock_requeued();
+    waiters_.fetch_sub(1, std::memory_order_relaxed);
+    return err == ETIMEDOUT ? cv_status::timeout : cv_status::no_timeout;
+  }
+
+  detail::futex_word seq_{0};
+  std::atomic<std::uint32_t> waiters_{0};
+
+  // Futex of the mutex the waiters use.
+  std::atomic<detail::futex_word *> mutex_{nullptr};
+};
+
+} // namespace gpcl
+
+#endif // GPCL_POSIX
+
+#endif // GPCL_FAST_CONDITION_VARIABLE_HPP
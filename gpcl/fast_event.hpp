@@ -0,0 +1,114 @@
+//
+// fast_event.hpp
+// ~~~~~~~~~~~~~~
+//
+// Copyright (c) 2020 Zhengyi Fu (tsingyat at outlook dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef GPCL_FAST_EVENT_HPP
+#define GPCL_FAST_EVENT_HPP
+
+#include <gpcl/detail/config.hpp>
+#include <gpcl/detail/futex.hpp>
+#include <gpcl/noncopyable.hpp>
+#include <gpcl/time.hpp>
+#include <atomic>
+#include <cerrno>
+#include <climits>
+#include <cstdint>
+
+#ifdef GPCL_POSIX
+
+namespace gpcl {
+
+/// A manual-reset event that needs no mutex.
+///
+/// The whole event is a futex word, so set() and reset() are single atomic
+/// instructions, and set() only makes a system call if threads are waiting.
+/// Woken waiters do not contend for anything, unlike waiters of event, which
+/// all have to take the same mutex again.
+class fast_event : noncopyable
+{
+public:
+  constexpr fast_event() noexcept = default;
+
+  explicit fast_event(bool initially_set) noexcept
+      : state_(initially_set ? signaled : clear)
+  {
+  }
+
+  /// \effects Sets the event and wakes all waiters.
+  void set() noexcept
+  {
+    if (state_.exchange(signaled) == clear_with_waiters)
+      detail::futex_wake(state_, INT_MAX, false);
+  }
+
+  /// \effects Clears the event, if it is set.
+  void reset() noexcept
+  {
+    std::uint32_t s = signaled;
+    state_.compare_exchange_strong(s, clear);
+  }
+
+  /// \returns Whether the event is set.
+  bool is_set() const noexcept { return state_.load() == signaled; }
+
+  /// \effects Blocks until the event is set.
+  void wait() noexcept
+  {
+    while (!prepare_wait())
+      detail::futex_wait(state_, clear_with_waiters, nullptr, false);
+  }
+
+  /// \effects Blocks for at most timeout until the event is set.
+  ///
+  /// \returns Whether the event is set.
+  bool wait_for(duration timeout) noexcept
+  {
+    return wait_until(instant::now().saturating_add(timeout));
+  }
+
+  /// \effects Blocks until deadline at the latest until the event is set.
+  ///
+  /// \returns Whether the event is set.
+  bool wait_until(const instant &deadline) noexcept
+  {
+    while (!prepare_wait())
+    {
+      if (detail::futex_wait_until(state_, clear_with_waiters, deadline,
+                                   false) == ETIMEDOUT)
+        return is_set();
+    }
+    return true;
+  }
+
+private:
+  enum : std::uint32_t
+  {
+    clear = 0,
+    signaled = 1,
+    clear_with_waiters = 2
+  };
+
+  // Returns true if the event is set; otherwise marks it as waited for, so
+  // that set() knows to wake us.
+  bool prepare_wait() noexcept
+  {
+    std::uint32_t s = clear;
+    if (state_.compare_exchange_strong(s, clear_with_waiters))
+      return false;
+    return s == signaled;
+  }
+
+  detail::futex_word state_{clear};
+};
+
+} // namespace gpcl
+
+#endif // GPCL_POSIX
+
+#endif // GPCL_FAST_EVENT_HPP
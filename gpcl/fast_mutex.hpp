@@ -0,0 +1,141 @@
+//
+// fast_mutex.hpp
+// ~~~~~~~~~~~~~~
+//
+// Copyright (c) 2020 Zhengyi Fu (tsingyat at outlook dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef GPCL_FAST_MUTEX_HPP
+#define GPCL_FAST_MUTEX_HPP
+
+#include <gpcl/detail/config.hpp>
+#include <gpcl/detail/error.hpp>
+#include <gpcl/detail/futex_mutex.hpp>
+#include <gpcl/noncopyable.hpp>
+#include <gpcl/thread_annotations.hpp>
+#include <atomic>
+#include <cerrno>
+#include <pthread.h>
+
+#ifdef GPCL_POSIX
+
+namespace gpcl {
+
+class fast_condition_variable;
+
+/// A mutex that is as cheap as an atomic instruction when uncontended.
+///
+/// Unlike mutex, which is an error-checking robust pthread mutex, fast_mutex
+/// does not check its use: locking it twice from one thread deadlocks, and
+/// unlocking it from another thread is undefined. Contended lockers spin
+/// briefly, then sleep on a futex. Use checked_fast_mutex while debugging.
+///
+/// fast_mutex works with fast_condition_variable.
+class GPCL_CAPABILITY("mutex") fast_mutex : noncopyable
+{
+public:
+  using impl_type = detail::futex_mutex;
+  using native_handle_type = detail::futex_word *;
+
+  constexpr fast_mutex() noexcept = default;
+
+  GPCL_ACQUIRE() auto lock() noexcept -> void { impl_.lock(); }
+  GPCL_RELEASE() auto unlock() noexcept -> void { impl_.unlock(); }
+  GPCL_TRY_ACQUIRE(true) auto try_lock() noexcept -> bool
+  {
+    return impl_.try_lock();
+  }
+
+  auto native_handle() noexcept -> native_handle_type
+  {
+    return impl_.native_handle();
+  }
+
+private:
+  friend class fast_condition_variable;
+
+  auto lock_requeued() noexcept -> void { impl_.lock_contended(); }
+
+  impl_type impl_;
+};
+
+/// A fast_mutex that checks that it is used correctly, at the cost of
+/// recording its owner.
+///
+/// \throws std::system_error with EDEADLK from lock() and try_lock() if the
+/// calling thread owns the mutex already, and with EPERM from unlock() if
+/// it does not.
+class GPCL_CAPABILITY("mutex") checked_fast_mutex : noncopyable
+{
+public:
+  using impl_type = detail::futex_mutex;
+  using native_handle_type = detail::futex_word *;
+
+  checked_fast_mutex() noexcept = default;
+
+  GPCL_ACQUIRE() auto lock() -> void
+  {
+    check_not_owner();
+    impl_.lock();
+    owner_.store(::pthread_self(), std::memory_order_relaxed);
+  }
+
+  GPCL_RELEASE() auto unlock() -> void
+  {
+    if (!owned())
+      detail::throw_system_error(EPERM, "checked_fast_mutex::unlock");
+    owner_.store(pthread_t(), std::memory_order_relaxed);
+    impl_.unlock();
+  }
+
+  GPCL_TRY_ACQUIRE(true) auto try_lock() -> bool
+  {
+    check_not_owner();
+    if (!impl_.try_lock())
+      return false;
+    owner_.store(::pthread_self(), std::memory_order_relaxed);
+    return true;
+  }
+
+  /// \returns Whether the calling thread owns the mutex.
+  auto owned() const noexcept -> bool
+  {
+    return ::pthread_equal(owner_.load(std::memory_order_relaxed),
+                           ::pthread_self()) != 0;
+  }
+
+  auto native_handle() noexcept -> native_handle_type
+  {
+    return impl_.native_handle();
+  }
+
+private:
+  friend class fast_condition_variable;
+
+  auto lock_requeued() noexcept -> void
+  {
+    impl_.lock_contended();
+    owner_.store(::pthread_self(), std::memory_order_relaxed);
+  }
+
+  void check_not_owner() const
+  {
+    if (owned())
+      detail::throw_system_error(EDEADLK, "checked_fast_mutex::lock");
+  }
+
+  impl_type impl_;
+
+  // A thread can only find its own id here if it has stored it itself, so
+  // relaxed accesses are enough.
+  std::atomic<pthread_t> owner_{};
+};
+
+} // namespace gpcl
+
+#endif // GPCL_POSIX
+
+#endif // GPCL_FAST_MUTEX_HPP
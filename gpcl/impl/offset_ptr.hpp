@@ -130,7 +130,9 @@ template <typename U,
                                 !detail::is_unbounded_array<U>::value,
         int>::type>
 offset_ptr<T> &offset_ptr<T>::operator+=(offset_ptr::difference_type diff) {
-  GPCL_ASSERT(_real_ptr() != 0);
+  GPCL_ASSERT(_real_ptr() != 0 || diff == 0);
+  if (diff == 0)
+    return *this;
 
   offset_ += diff_to_offset(diff);
   return *this;
@@ -142,7 +144,9 @@ template <typename U,
                                 !detail::is_unbounded_array<U>::value,
         int>::type>
 offset_ptr<T> &offset_ptr<T>::operator-=(offset_ptr::difference_type diff) {
-  GPCL_ASSERT(_real_ptr() != 0);
+  GPCL_ASSERT(_real_ptr() != 0 || diff == 0);
+  if (diff == 0)
+    return *this;
 
   offset_ -= diff_to_offset(diff);
   return *this;
@@ -155,8 +159,8 @@ template <typename U,
         int>::type>
 typename offset_ptr<T>::difference_type offset_ptr<T>::operator-(
     const offset_ptr &other) const {
-  GPCL_ASSERT(_real_ptr() != 0);
-  GPCL_ASSERT(other._real_ptr() != 0);
+  // Like raw pointers, two null pointers have a difference of 0.
+  GPCL_ASSERT((_real_ptr() != 0) == (other._real_ptr() != 0));
 
   return _real_ptr() - other._real_ptr();
 }
@@ -167,7 +171,7 @@ template <typename U,
                                 !detail::is_unbounded_array<U>::value,
         int>::type>
 offset_ptr<T> offset_ptr<T>::operator+(offset_ptr::difference_type diff) const {
-  GPCL_ASSERT(_real_ptr() != 0);
+  GPCL_ASSERT(_real_ptr() != 0 || diff == 0);
 
   offset_ptr ret = *this;
   ret += diff;
@@ -179,7 +183,7 @@ template <typename U,
                                 !detail::is_unbounded_array<U>::value,
         int>::type>
 offset_ptr<T> offset_ptr<T>::operator-(offset_ptr::difference_type diff) const {
-  GPCL_ASSERT(_real_ptr() != 0);
+  GPCL_ASSERT(_real_ptr() != 0 || diff == 0);
 
   offset_ptr ret = *this;
   ret -= diff;
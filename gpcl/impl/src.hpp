@@ -16,14 +16,35 @@
 
 #include <gpcl/detail/config.hpp>
 #include <gpcl/detail/impl/error.ipp>
+#include <gpcl/detail/impl/pool_resource.ipp>
+#include <gpcl/detail/impl/thread_cache.ipp>
 #include <gpcl/detail/impl/unreachable.ipp>
+#include <gpcl/pmr/impl/default_resource.ipp>
+#include <gpcl/pmr/impl/mmap_resource.ipp>
+#include <gpcl/pmr/impl/monotonic_buffer_resource.ipp>
+#include <gpcl/pmr/impl/new_delete_resource.ipp>
+#include <gpcl/pmr/impl/null_memory_resource.ipp>
+#include <gpcl/pmr/impl/numa_resource.ipp>
+#include <gpcl/pmr/impl/synchronized_pool_resource.ipp>
+#include <gpcl/pmr/impl/unsynchronized_pool_resource.ipp>
 
 #ifdef GPCL_POSIX
+#include <gpcl/detail/impl/futex.ipp>
+#include <gpcl/detail/impl/futex_mutex.ipp>
+#include <gpcl/detail/impl/percpu_rwlock.ipp>
 #include <gpcl/detail/impl/posix_clock.ipp>
 #include <gpcl/detail/impl/posix_condition_variable.ipp>
+#include <gpcl/detail/impl/posix_message_queue.ipp>
+#include <gpcl/detail/impl/posix_mpsc_channel.ipp>
 #include <gpcl/detail/impl/posix_mutex.ipp>
+#include <gpcl/detail/impl/posix_numa.ipp>
 #include <gpcl/detail/impl/posix_semaphore.ipp>
+#include <gpcl/detail/impl/posix_shared_memory.ipp>
+#include <gpcl/detail/impl/posix_shared_mutex.ipp>
+#include <gpcl/detail/impl/posix_spsc_ring.ipp>
 #include <gpcl/detail/impl/posix_thread.ipp>
+#include <gpcl/detail/impl/thread_pool.ipp>
+#include <gpcl/detail/impl/segment_manager.ipp>
 #include <gpcl/detail/impl/posix_timer.ipp>
 #include <gpcl/detail/impl/unique_file_descriptor.ipp>
 #endif
@@ -0,0 +1,129 @@
+//
+// latch.hpp
+// ~~~~~~~~~
+//
+// Copyright (c) 2020 Zhengyi Fu (tsingyat at outlook dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef GPCL_LATCH_HPP
+#define GPCL_LATCH_HPP
+
+#include <gpcl/assert.hpp>
+#include <gpcl/detail/config.hpp>
+#include <gpcl/detail/futex.hpp>
+#include <gpcl/noncopyable.hpp>
+#include <gpcl/time.hpp>
+#include <atomic>
+#include <cerrno>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+
+#ifdef GPCL_POSIX
+
+namespace gpcl {
+
+/// A single-use countdown: threads wait until the counter reaches zero.
+///
+/// The counter is a futex word, so counting down and checking the latch are
+/// atomic instructions; only the last count_down() with waiters makes a
+/// system call, to wake them all.
+class latch : noncopyable
+{
+public:
+  /// \requires 0 <= expected <= max().
+  explicit latch(std::ptrdiff_t expected) noexcept
+      : count_(static_cast<std::uint32_t>(expected))
+  {
+    GPCL_ASSERT(expected >= 0 && expected <= max());
+  }
+
+  /// \requires No thread waits on the latch.
+  ~latch() { GPCL_ASSERT(waiters_.load() == 0); }
+
+  static constexpr std::ptrdiff_t max() noexcept { return INT_MAX; }
+
+  /// \effects Decrements the counter by update, and wakes the waiters if it
+  /// reaches zero.
+  ///
+  /// \requires 0 <= update <= the counter.
+  void count_down(std::ptrdiff_t update = 1) noexcept
+  {
+    GPCL_ASSERT(update >= 0);
+    std::uint32_t n = static_cast<std::uint32_t>(update);
+    std::uint32_t old = count_.fetch_sub(n, std::memory_order_release);
+    GPCL_ASSERT(old >= n);
+    if (old == n && n != 0 && waiters_.load() != 0)
+      detail::futex_wake(count_, INT_MAX, false);
+  }
+
+  /// \returns Whether the counter reached zero.
+  bool try_wait() const noexcept
+  {
+    return count_.load(std::memory_order_acquire) == 0;
+  }
+
+  /// \effects Blocks until the counter reaches zero.
+  void wait() const noexcept
+  {
+    while (!try_wait())
+      sleep(nullptr);
+  }
+
+  /// \effects Blocks for at most rel_time until the counter reaches zero.
+  ///
+  /// \returns Whether the counter reached zero.
+  bool wait_for(const duration &rel_time) const noexcept
+  {
+    return wait_until(instant::now().saturating_add(rel_time));
+  }
+
+  /// \effects Blocks until abs_time at the latest until the counter reaches
+  /// zero.
+  ///
+  /// \returns Whether the counter reached zero.
+  bool wait_until(const instant &abs_time) const noexcept
+  {
+    while (!try_wait())
+    {
+      if (sleep(&abs_time) == ETIMEDOUT)
+        return try_wait();
+    }
+    return true;
+  }
+
+  /// \effects Counts down by update, then waits for the counter to reach
+  /// zero.
+  void arrive_and_wait(std::ptrdiff_t update = 1) noexcept
+  {
+    count_down(update);
+    wait();
+  }
+
+private:
+  int sleep(const instant *deadline) const noexcept
+  {
+    std::uint32_t c = count_.load();
+    if (c == 0)
+      return 0;
+    waiters_.fetch_add(1);
+    int err = deadline ? detail::futex_wait_until(count_, c, *deadline, false)
+                       : detail::futex_wait(count_, c, nullptr, false);
+    waiters_.fetch_sub(1, std::memory_order_relaxed);
+    return err;
+  }
+
+  // The waiting members are const, as in std::latch, but sleep on the
+  // counter.
+  mutable detail::futex_word count_;
+  mutable std::atomic<std::uint32_t> waiters_{0};
+};
+
+} // namespace gpcl
+
+#endif // GPCL_POSIX
+
+#endif // GPCL_LATCH_HPP
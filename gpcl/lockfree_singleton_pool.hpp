@@ -0,0 +1,112 @@
+//
+// lockfree_singleton_pool.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2020 Zhengyi Fu (tsingyat at outlook dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef GPCL_LOCKFREE_SINGLETON_POOL_HPP
+#define GPCL_LOCKFREE_SINGLETON_POOL_HPP
+
+#include <gpcl/detail/config.hpp>
+#include <gpcl/detail/tagged_free_list.hpp>
+#include <gpcl/pool.hpp>
+
+namespace gpcl {
+
+/// A singleton pool whose single-chunk free list is lock-free.
+///
+/// malloc() and free() pop and push a Treiber stack with a version-counted
+/// head. On x86-64 and AArch64 the counter is packed in the unused upper
+/// bits of the pointer; elsewhere, or if GPCL_TAGGED_PTR_DOUBLE_WIDTH is
+/// defined, the head is updated with a double-width CAS (which may require
+/// linking libatomic).
+///
+/// The chunks come from a mutex-protected pool, 32 at a time. Arrays
+/// (ordered_malloc(n) and ordered_free(ptr, n)) are served by that pool
+/// directly.
+///
+/// \notes The lock-free free list is not ordered; ordered_malloc() and
+/// ordered_free() for single chunks behave like malloc() and free().
+template <typename Tag, unsigned RequestedSize,
+          typename UserAllocator = default_malloc_free_user_allocator>
+class lockfree_singleton_pool
+{
+  using pool_type = pool<UserAllocator>;
+
+public:
+  using tag = Tag;
+  using user_allocator = UserAllocator;
+  using size_type = typename pool_type::size_type;
+  using difference_type = typename pool_type::difference_type;
+
+  const static unsigned requested_size = RequestedSize;
+
+  /// Number of chunks taken from the backing pool at a time.
+  const static unsigned batch_size = 32;
+
+  static void *malloc()
+  {
+    auto &s = get_state();
+    if (void *chunk = s.free_list.pop())
+      return chunk;
+    return refill(s);
+  }
+
+  static void *ordered_malloc() { return malloc(); }
+
+  static void *ordered_malloc(size_type n)
+  {
+    return get_state().backing_pool.ordered_malloc(n);
+  }
+
+  static void free(void *ptr) { get_state().free_list.push(ptr); }
+
+  static void ordered_free(void *ptr) { free(ptr); }
+
+  static void ordered_free(void *ptr, size_type n)
+  {
+    get_state().backing_pool.ordered_free(ptr, n);
+  }
+
+  /// \returns true if the free list is updated without a lock.
+  static bool is_lock_free() { return get_state().free_list.is_lock_free(); }
+
+private:
+  struct state
+  {
+    pool_type backing_pool{RequestedSize};
+    detail::tagged_free_list free_list;
+  };
+
+  static state &get_state()
+  {
+    static state instance;
+    return instance;
+  }
+
+  // Takes a batch from the backing pool, publishes all chunks but the first
+  // one and returns the first one.
+  static void *refill(state &s)
+  {
+    void *first;
+    if (s.backing_pool.malloc_batch(batch_size, first) == 0)
+      return nullptr;
+
+    if (void *rest = *static_cast<void **>(first))
+    {
+      void *last = rest;
+      while (*static_cast<void **>(last))
+        last = *static_cast<void **>(last);
+      s.free_list.push_chain(rest, last);
+    }
+    return first;
+  }
+};
+
+} // namespace gpcl
+
+#endif // GPCL_LOCKFREE_SINGLETON_POOL_HPP
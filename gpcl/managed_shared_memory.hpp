@@ -0,0 +1,329 @@
+//
+// managed_shared_memory.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2020 Zhengyi Fu (tsingyat at outlook dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef GPCL_MANAGED_SHARED_MEMORY_HPP
+#define GPCL_MANAGED_SHARED_MEMORY_HPP
+
+#include <gpcl/creation_tag.hpp>
+#include <gpcl/detail/config.hpp>
+#include <gpcl/detail/error.hpp>
+#include <gpcl/detail/posix_shared_memory.hpp>
+#include <gpcl/detail/segment_manager.hpp>
+#include <gpcl/noncopyable.hpp>
+#include <gpcl/offset_ptr.hpp>
+#include <gpcl/pmr/memory_resource.hpp>
+#include <gpcl/unique_lock.hpp>
+#include <gpcl/zstring.hpp>
+#include <limits>
+#include <new>
+#include <utility>
+
+#ifdef GPCL_POSIX
+
+namespace gpcl {
+
+/// A named shared memory segment with an allocator and a directory of named
+/// objects inside it.
+///
+/// The segment may be mapped at a different address in every process, so
+/// the objects placed in it must not hold raw pointers into it: use
+/// offset_ptr, and segment_allocator for containers. The allocator and the
+/// directory are protected by a robust process-shared mutex. If a process
+/// dies holding it, the next operation checks them; operations on a segment
+/// found damaged throw std::system_error with EOWNERDEAD.
+///
+/// \notes A segment_allocator stores the location of the segment, so
+/// containers using one may be shared between processes; polymorphic
+/// allocators store a pointer to a process-local resource and may not.
+class managed_shared_memory : noncopyable
+{
+public:
+  /// Creates and formats a segment of size bytes.
+  ///
+  /// \throws std::system_error if the segment exists or cannot be created.
+  managed_shared_memory(create_only_t, czstring<> name, std::size_t size)
+      : shm_(create_only, name, size),
+        mgr_(new (shm_.address()) detail::segment_manager(shm_.size()))
+  {
+  }
+
+  /// Opens the segment if it exists, otherwise creates it with size bytes.
+  managed_shared_memory(open_or_create_t, czstring<> name, std::size_t size)
+      : shm_(open_or_create, name, size),
+        mgr_(shm_.created()
+                 ? new (shm_.address()) detail::segment_manager(shm_.size())
+                 : detail::segment_manager::attach(shm_.address()))
+  {
+  }
+
+  /// Opens an existing segment, waiting until its creator has formatted it.
+  ///
+  /// \throws std::system_error with ETIMEDOUT if the creator has not
+  /// formatted it within a few seconds, having most likely died.
+  managed_shared_memory(open_only_t, czstring<> name)
+      : shm_(open_only, name),
+        mgr_(detail::segment_manager::attach(shm_.address()))
+  {
+  }
+
+  /// Removes the name of the segment. The segment is freed once every
+  /// process has unmapped it.
+  static void remove(czstring<> name) { impl_type::unlink(name); }
+
+  static void remove(czstring<> name, std::error_code &ec)
+  {
+    impl_type::unlink(name, ec);
+  }
+
+  void *address() const noexcept { return shm_.address(); }
+
+  std::size_t size() const noexcept { return shm_.size(); }
+
+  /// \returns The number of free bytes, including bookkeeping.
+  std::size_t free_memory() const { return mgr_->free_memory(); }
+
+  /// \returns Whether p points into the segment.
+  bool contains(const void *p) const noexcept
+  {
+    auto *c = static_cast<const char *>(p);
+    auto *base = static_cast<const char *>(address());
+    return c >= base && c < base + size();
+  }
+
+  /// \returns Memory for bytes bytes in the segment.
+  ///
+  /// \throws std::bad_alloc if the segment is full.
+  void *allocate(std::size_t bytes,
+                 std::size_t alignment = alignof(std::max_align_t))
+  {
+    void *p = mgr_->allocate(bytes, alignment);
+    if (!p)
+      GPCL_THROW(std::bad_alloc());
+    return p;
+  }
+
+  void deallocate(void *p) { mgr_->deallocate(p); }
+
+  /// \returns A memory resource that allocates from the segment.
+  ///
+  /// \notes The resource itself lives in this process; store a
+  /// segment_allocator, not the resource, in shared data structures.
+  pmr::memory_resource *resource() noexcept { return &resource_; }
+
+  /// Constructs a T named name in the segment from args.
+  ///
+  /// \returns The new object, or null if an object named name exists.
+  /// \throws std::bad_alloc if the segment is full, or whatever the
+  /// constructor of T throws.
+  template <typename T, typename... Args>
+  T *construct(czstring<> name, Args &&... args)
+  {
+    unique_lock<mutex_type> lock(mgr_->mutex());
+    mgr_->recover();
+    if (mgr_->find_named(name, sizeof(T), alignof(T)))
+      return nullptr;
+    return construct_unlocked<T>(name, std::forward<Args>(args)...);
+  }
+
+  /// \returns The object named name, constructing it from args if there is
+  /// none.
+  template <typename T, typename... Args>
+  T *find_or_construct(czstring<> name, Args &&... args)
+  {
+    unique_lock<mutex_type> lock(mgr_->mutex());
+    mgr_->recover();
+    if (void *p = mgr_->find_named(name, sizeof(T), alignof(T)))
+      return static_cast<T *>(p);
+    return construct_unlocked<T>(name, std::forward<Args>(args)...);
+  }
+
+  /// \returns The object named name, or null.
+  template <typename T>
+  T *find(czstring<> name) const
+  {
+    unique_lock<mutex_type> lock(mgr_->mutex());
+    mgr_->recover();
+    return static_cast<T *>(mgr_->find_named(name, sizeof(T), alignof(T)));
+  }
+
+  /// Destroys the object named name and frees its memory.
+  ///
+  /// \returns false if there is no object named name.
+  template <typename T>
+  bool destroy(czstring<> name)
+  {
+    unique_lock<mutex_type> lock(mgr_->mutex());
+    mgr_->recover();
+    if (!mgr_->find_named(name, sizeof(T), alignof(T)))
+      return false;
+    auto *p = static_cast<T *>(mgr_->erase_named(name));
+    p->~T();
+    mgr_->deallocate(p);
+    return true;
+  }
+
+  detail::segment_manager *segment_manager() const noexcept { return mgr_; }
+
+private:
+  using impl_type = detail::posix_shared_memory;
+  using mutex_type = detail::segment_manager::mutex_type;
+
+  class segment_resource : public pmr::memory_resource
+  {
+  public:
+    explicit segment_resource(managed_shared_memory &segment) noexcept
+        : segment_(segment)
+    {
+    }
+
+  private:
+    void *do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+      return segment_.allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void *p, std::size_t bytes,
+                       std::size_t alignment) override
+    {
+      (void)bytes;
+      (void)alignment;
+      segment_.deallocate(p);
+    }
+
+    bool do_is_equal(const memory_resource &other) const noexcept override
+    {
+      auto *r = dynamic_cast<const segment_resource *>(&other);
+      return r && r->segment_.address() == segment_.address();
+    }
+
+    managed_shared_memory &segment_;
+  };
+
+  // Requires the mutex to be held.
+  template <typename T, typename... Args>
+  T *construct_unlocked(czstring<> name, Args &&... args)
+  {
+    void *p = allocate(sizeof(T), alignof(T));
+    T *object = nullptr;
+    GPCL_TRY
+    {
+      object = new (p) T(std::forward<Args>(args)...);
+    }
+    GPCL_CATCH (...)
+    {
+      mgr_->deallocate(p);
+      GPCL_RETHROW
+    }
+    GPCL_CATCH_END
+
+    if (!mgr_->insert_named(name, object, sizeof(T), alignof(T)))
+    {
+      object->~T();
+      mgr_->deallocate(p);
+      GPCL_THROW(std::bad_alloc());
+    }
+    return object;
+  }
+
+  impl_type shm_;
+  detail::segment_manager *mgr_;
+  segment_resource resource_{*this};
+};
+
+/// An allocator that allocates from a managed_shared_memory segment.
+///
+/// It refers to the segment by an offset_ptr, and its pointer type is
+/// offset_ptr<T>, so a container using it may itself live in the segment
+/// and be used by every process that maps the segment.
+template <typename T>
+class segment_allocator
+{
+public:
+  using value_type = T;
+  using pointer = offset_ptr<T>;
+  using const_pointer = offset_ptr<const T>;
+  using void_pointer = offset_ptr<void>;
+  using const_void_pointer = offset_ptr<const void>;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+
+  template <typename U>
+  struct rebind
+  {
+    using other = segment_allocator<U>;
+  };
+
+  explicit segment_allocator(managed_shared_memory &segment) noexcept
+      : mgr_(segment.segment_manager())
+  {
+  }
+
+  segment_allocator(const segment_allocator &other) noexcept
+      : mgr_(other.manager())
+  {
+  }
+
+  template <typename U>
+  segment_allocator(const segment_allocator<U> &other) noexcept
+      : mgr_(other.manager())
+  {
+  }
+
+  segment_allocator &operator=(const segment_allocator &other) noexcept
+  {
+    mgr_ = other.manager();
+    return *this;
+  }
+
+  /// \throws std::bad_alloc if the segment is full.
+  pointer allocate(size_type n)
+  {
+    if (n > std::numeric_limits<size_type>::max() / sizeof(T))
+      GPCL_THROW(std::bad_array_new_length());
+    void *p = manager()->allocate(n * sizeof(T), alignof(T));
+    if (!p)
+      GPCL_THROW(std::bad_alloc());
+    return pointer(static_cast<T *>(p));
+  }
+
+  void deallocate(pointer p, size_type n) noexcept
+  {
+    (void)n;
+    manager()->deallocate(static_cast<T *>(p));
+  }
+
+  detail::segment_manager *manager() const noexcept
+  {
+    return static_cast<detail::segment_manager *>(mgr_);
+  }
+
+  template <typename U>
+  friend bool operator==(const segment_allocator &x,
+                         const segment_allocator<U> &y) noexcept
+  {
+    return x.manager() == y.manager();
+  }
+
+  template <typename U>
+  friend bool operator!=(const segment_allocator &x,
+                         const segment_allocator<U> &y) noexcept
+  {
+    return !(x == y);
+  }
+
+private:
+  offset_ptr<detail::segment_manager> mgr_;
+};
+
+} // namespace gpcl
+
+#endif // GPCL_POSIX
+
+#endif // GPCL_MANAGED_SHARED_MEMORY_HPP
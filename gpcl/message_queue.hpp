@@ -29,15 +29,19 @@ class message_queue {
   impl_type impl_;
 
 public:
-  message_queue(open_only_t, czstring<> name) : impl_(open_only, name) {}
+  using native_handle_type = mqd_t;
+
+  message_queue(open_only_t, czstring<> name,
+                queue_mode mode = queue_mode::blocking)
+      : impl_(open_only, name, mode) {}
 
   message_queue(open_or_create_t, czstring<> name, std::size_t maxmsg,
-                std::size_t msgsize)
-      : impl_(open_or_create, name, maxmsg, msgsize) {}
+                std::size_t msgsize, queue_mode mode = queue_mode::blocking)
+      : impl_(open_or_create, name, maxmsg, msgsize, mode) {}
 
   message_queue(create_only_t, czstring<> name, std::size_t maxmsg,
-                std::size_t msgsize)
-      : impl_(create_only, name, maxmsg, msgsize) {}
+                std::size_t msgsize, queue_mode mode = queue_mode::blocking)
+      : impl_(create_only, name, maxmsg, msgsize, mode) {}
 
   static void unlink(czstring<> name) { impl_type ::unlink(name); }
 
@@ -85,6 +89,190 @@ public:
       return gpcl::make_unexpected(ec);
     return msg.subspan(0, len);
   }
+
+  /// Receives a message into msg, like receive(), and reports its
+  /// priority as well.
+  received_message receive_message(span<char> msg) {
+    std::error_code ec;
+    received_message m = impl_.receive_message(msg, ec);
+    if (ec)
+      GPCL_THROW(std::system_error(ec, __PRETTY_FUNCTION__));
+    return m;
+  }
+
+  received_message receive_message(span<char> msg, std::error_code &ec) {
+    return impl_.receive_message(msg, ec);
+  }
+
+  gpcl::expected<received_message, std::error_code>
+  receive_message(use_expected_t, span<char> msg) {
+    std::error_code ec;
+    received_message m = impl_.receive_message(msg, ec);
+    if (ec)
+      return gpcl::make_unexpected(ec);
+    return m;
+  }
+
+  /// Sends msg, waiting until deadline at the latest while the queue is
+  /// full.
+  ///
+  /// \returns Whether msg was sent before deadline.
+  bool timed_send(span<const char> msg, unsigned int prio,
+                  const system_time &deadline) {
+    std::error_code ec;
+    impl_.timed_send(msg, prio, deadline, ec);
+    if (ec == std::errc::timed_out)
+      return false;
+    if (ec)
+      GPCL_THROW(std::system_error(ec, __PRETTY_FUNCTION__));
+    return true;
+  }
+
+  void timed_send(span<const char> msg, unsigned int prio,
+                  const system_time &deadline, std::error_code &ec) {
+    impl_.timed_send(msg, prio, deadline, ec);
+  }
+
+  /// Sends msg, waiting until deadline at the latest while the queue is
+  /// full. Setting the system clock forward does not end the wait early.
+  ///
+  /// \returns Whether msg was sent before deadline.
+  bool timed_send(span<const char> msg, unsigned int prio,
+                  const instant &deadline) {
+    std::error_code ec;
+    impl_.timed_send(msg, prio, deadline, ec);
+    if (ec == std::errc::timed_out)
+      return false;
+    if (ec)
+      GPCL_THROW(std::system_error(ec, __PRETTY_FUNCTION__));
+    return true;
+  }
+
+  void timed_send(span<const char> msg, unsigned int prio,
+                  const instant &deadline, std::error_code &ec) {
+    impl_.timed_send(msg, prio, deadline, ec);
+  }
+
+  /// Receives a message into msg, waiting until deadline at the latest
+  /// while the queue is empty.
+  ///
+  /// \returns Whether a message was received; its size is stored in len.
+  bool timed_receive(span<char> msg, std::size_t &len,
+                     const system_time &deadline) {
+    received_message m;
+    bool received = timed_receive(msg, m, deadline);
+    len = m.size();
+    return received;
+  }
+
+  bool timed_receive(span<char> msg, received_message &m,
+                     const system_time &deadline) {
+    std::error_code ec;
+    m = impl_.timed_receive(msg, deadline, ec);
+    if (ec == std::errc::timed_out)
+      return false;
+    if (ec)
+      GPCL_THROW(std::system_error(ec, __PRETTY_FUNCTION__));
+    return true;
+  }
+
+  received_message timed_receive(span<char> msg, const system_time &deadline,
+                                 std::error_code &ec) {
+    return impl_.timed_receive(msg, deadline, ec);
+  }
+
+  /// Receives a message into m, waiting until deadline at the latest while
+  /// the queue is empty. Setting the system clock forward does not end the
+  /// wait early.
+  ///
+  /// \returns Whether a message was received.
+  bool timed_receive(span<char> msg, received_message &m,
+                     const instant &deadline) {
+    std::error_code ec;
+    m = impl_.timed_receive(msg, deadline, ec);
+    if (ec == std::errc::timed_out)
+      return false;
+    if (ec)
+      GPCL_THROW(std::system_error(ec, __PRETTY_FUNCTION__));
+    return true;
+  }
+
+  received_message timed_receive(span<char> msg, const instant &deadline,
+                                 std::error_code &ec) {
+    return impl_.timed_receive(msg, deadline, ec);
+  }
+
+  /// Receives up to bufs.size() messages: the first one as receive() does,
+  /// the following ones only if they are already queued. The message in
+  /// bufs[i] is described by msgs[i].
+  ///
+  /// An error after the first message ends the batch without being
+  /// reported; the next call reports it.
+  ///
+  /// \returns The number of messages received.
+  std::size_t receive_batch(span<const span<char>> bufs,
+                            span<received_message> msgs) {
+    std::error_code ec;
+    std::size_t n = impl_.receive_batch(bufs, msgs, ec);
+    if (ec)
+      GPCL_THROW(std::system_error(ec, __PRETTY_FUNCTION__));
+    return n;
+  }
+
+  std::size_t receive_batch(span<const span<char>> bufs,
+                            span<received_message> msgs,
+                            std::error_code &ec) {
+    return impl_.receive_batch(bufs, msgs, ec);
+  }
+
+  /// \returns The number of messages in the queue.
+  std::size_t size() const {
+    return static_cast<std::size_t>(attributes().mq_curmsgs);
+  }
+
+  /// \returns The maximum number of messages in the queue.
+  std::size_t capacity() const {
+    return static_cast<std::size_t>(attributes().mq_maxmsg);
+  }
+
+  /// \returns The maximum size of a message.
+  std::size_t max_msg_size() const {
+    return static_cast<std::size_t>(attributes().mq_msgsize);
+  }
+
+  queue_mode mode() const {
+    std::error_code ec;
+    queue_mode m = impl_.mode(ec);
+    if (ec)
+      GPCL_THROW(std::system_error(ec, __PRETTY_FUNCTION__));
+    return m;
+  }
+
+  /// Switches between blocking and non-blocking operations, for example
+  /// to service the queue from an event loop.
+  void set_mode(queue_mode mode) {
+    std::error_code ec;
+    impl_.set_mode(mode, ec);
+    if (ec)
+      GPCL_THROW(std::system_error(ec, __PRETTY_FUNCTION__));
+  }
+
+  /// \returns The message queue descriptor, which on Linux is a file
+  /// descriptor that can be registered with epoll or poll; it is readable
+  /// while the queue is not empty and writable while it is not full.
+  native_handle_type native_handle() const noexcept {
+    return impl_.native_handle();
+  }
+
+private:
+  mq_attr attributes() const {
+    mq_attr attr{};
+    std::error_code ec;
+    impl_.attributes(attr, ec);
+    if (ec)
+      GPCL_THROW(std::system_error(ec, __PRETTY_FUNCTION__));
+    return attr;
+  }
 };
 
 #endif
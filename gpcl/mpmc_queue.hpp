@@ -0,0 +1,332 @@
+//
+// mpmc_queue.hpp
+// ~~~~~~~~~~~~~~
+//
+// Copyright (c) 2020 Zhengyi Fu (tsingyat at outlook dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef GPCL_MPMC_QUEUE_HPP
+#define GPCL_MPMC_QUEUE_HPP
+
+#include <gpcl/assert.hpp>
+#include <gpcl/detail/config.hpp>
+#include <gpcl/detail/futex.hpp>
+#include <gpcl/noncopyable.hpp>
+#include <gpcl/time.hpp>
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#ifdef GPCL_POSIX
+
+namespace gpcl {
+
+/// A bounded lock-free queue for any number of producer and consumer
+/// threads.
+///
+/// This is Dmitry Vyukov's array queue: every slot holds a sequence number
+/// that tells whether it is free or full for the current lap, so producers
+/// and consumers only contend on their own position. Threads only sleep, on
+/// a futex, when the queue is full or empty.
+///
+/// \requires T is nothrow move constructible and nothrow move assignable.
+template <typename T>
+class mpmc_queue : noncopyable
+{
+  static_assert(std::is_nothrow_move_constructible<T>::value &&
+                    std::is_nothrow_move_assignable<T>::value,
+                "a claimed slot must always be filled and emptied");
+
+public:
+  using value_type = T;
+  using size_type = std::size_t;
+
+  /// Constructs an empty queue of at least capacity elements, rounded up to
+  /// a power of two.
+  explicit mpmc_queue(size_type capacity)
+  {
+    size_type n = 2;
+    while (n < capacity)
+      n *= 2;
+    mask_ = n - 1;
+    slots_.reset(new slot[n]);
+    for (size_type i = 0; i < n; ++i)
+      slots_[i].seq.store(i, std::memory_order_relaxed);
+  }
+
+  /// \effects Destroys the elements left in the queue.
+  ~mpmc_queue()
+  {
+    size_type tail = tail_.pos.load(std::memory_order_relaxed);
+    for (size_type pos = head_.pos.load(std::memory_order_relaxed);
+         pos != tail; ++pos)
+      reinterpret_cast<T *>(&slots_[pos & mask_].storage)->~T();
+  }
+
+  size_type capacity() const noexcept { return mask_ + 1; }
+
+  /// \returns An estimate of the number of elements.
+  size_type size_approx() const noexcept
+  {
+    size_type tail = tail_.pos.load(std::memory_order_relaxed);
+    size_type head = head_.pos.load(std::memory_order_relaxed);
+    return tail > head ? (std::min)(tail - head, capacity()) : 0;
+  }
+
+  /// \effects Pushes v if the queue is not full.
+  ///
+  /// \returns Whether v was pushed.
+  bool try_push(T &&v) noexcept { return try_push_n(&v, 1) == 1; }
+
+  bool try_push(const T &v)
+  {
+    T copy(v);
+    return try_push(std::move(copy));
+  }
+
+  /// \effects Pushes v, blocking while the queue is full.
+  void push(T &&v) noexcept
+  {
+    while (!try_push(std::move(v)))
+      wait(not_full_, push_waiters_, [this] { return !full(); }, nullptr);
+  }
+
+  void push(const T &v)
+  {
+    T copy(v);
+    push(std::move(copy));
+  }
+
+  /// \effects Pops the first element into v if the queue is not empty.
+  ///
+  /// \returns Whether an element was popped.
+  bool try_pop(T &v) noexcept { return try_pop_n(&v, 1) == 1; }
+
+  /// \effects Pops the first element into v, blocking while the queue is
+  /// empty.
+  void pop(T &v) noexcept
+  {
+    while (!try_pop(v))
+      wait(not_empty_, pop_waiters_, [this] { return !empty(); }, nullptr);
+  }
+
+  /// \effects Pops the first element into v, blocking for at most timeout
+  /// while the queue is empty.
+  ///
+  /// \returns Whether an element was popped.
+  bool pop_for(T &v, duration timeout) noexcept
+  {
+    instant start = instant::now();
+    while (!try_pop(v))
+    {
+      duration left = timeout.saturating_sub(start.elapsed());
+      if (left.is_zero())
+        return false;
+      timespec ts = left.to_timespec();
+      wait(not_empty_, pop_waiters_, [this] { return !empty(); }, &ts);
+    }
+    return true;
+  }
+
+  /// \effects Moves up to n elements from first into the queue, in one
+  /// claim of consecutive slots.
+  ///
+  /// \returns The number of elements pushed, which are the first ones.
+  template <typename ForwardIt>
+  size_type try_push_n(ForwardIt first, size_type n) noexcept
+  {
+    size_type pos = tail_.pos.load(std::memory_order_relaxed);
+    size_type count;
+    for (;;)
+    {
+      // Count the free slots after pos.
+      for (count = 0; count < n; ++count)
+      {
+        size_type seq =
+            slots_[(pos + count) & mask_].seq.load(std::memory_order_acquire);
+        if (seq != pos + count)
+          break;
+      }
+      if (count == 0)
+      {
+        size_type seq = slots_[pos & mask_].seq.load(std::memory_order_acquire);
+        if (static_cast<std::ptrdiff_t>(seq - pos) < 0)
+          return 0; // full
+        pos = tail_.pos.load(std::memory_order_relaxed);
+        continue;
+      }
+      if (tail_.pos.compare_exchange_weak(pos, pos + count,
+                                          std::memory_order_relaxed))
+        break;
+    }
+
+    for (size_type i = 0; i < count; ++i, ++first)
+    {
+      slot &s = slots_[(pos + i) & mask_];
+      ::new (static_cast<void *>(&s.storage)) T(std::move(*first));
+      s.seq.store(pos + i + 1, std::memory_order_release);
+    }
+    notify(not_empty_, pop_waiters_, count);
+    return count;
+  }
+
+  /// \effects Moves the n elements from first into the queue, blocking
+  /// while the queue is full.
+  template <typename ForwardIt>
+  void push_n(ForwardIt first, size_type n) noexcept
+  {
+    while (n != 0)
+    {
+      size_type pushed = try_push_n(first, n);
+      if (pushed == 0)
+      {
+        wait(not_full_, push_waiters_, [this] { return !full(); }, nullptr);
+        continue;
+      }
+      std::advance(first, pushed);
+      n -= pushed;
+    }
+  }
+
+  /// \effects Pops up to n elements into out, in one claim of consecutive
+  /// slots.
+  ///
+  /// \returns The number of elements popped.
+  ///
+  /// \requires Assigning to *out does not throw.
+  template <typename OutputIt>
+  size_type try_pop_n(OutputIt out, size_type n) noexcept
+  {
+    size_type pos = head_.pos.load(std::memory_order_relaxed);
+    size_type count;
+    for (;;)
+    {
+      // Count the full slots after pos.
+      for (count = 0; count < n; ++count)
+      {
+        size_type seq =
+            slots_[(pos + count) & mask_].seq.load(std::memory_order_acquire);
+        if (seq != pos + count + 1)
+          break;
+      }
+      if (count == 0)
+      {
+        size_type seq = slots_[pos & mask_].seq.load(std::memory_order_acquire);
+        if (static_cast<std::ptrdiff_t>(seq - (pos + 1)) < 0)
+          return 0; // empty
+        pos = head_.pos.load(std::memory_order_relaxed);
+        continue;
+      }
+      if (head_.pos.compare_exchange_weak(pos, pos + count,
+                                          std::memory_order_relaxed))
+        break;
+    }
+
+    for (size_type i = 0; i < count; ++i, ++out)
+    {
+      slot &s = slots_[(pos + i) & mask_];
+      T *p = reinterpret_cast<T *>(&s.storage);
+      *out = std::move(*p);
+      p->~T();
+      s.seq.store(pos + i + capacity(), std::memory_order_release);
+    }
+    notify(not_full_, push_waiters_, count);
+    return count;
+  }
+
+  /// \effects Pops between one and n elements into out, blocking while the
+  /// queue is empty.
+  ///
+  /// \returns The number of elements popped.
+  template <typename OutputIt>
+  size_type pop_n(OutputIt out, size_type n) noexcept
+  {
+    GPCL_ASSERT(n != 0);
+    for (;;)
+    {
+      if (size_type popped = try_pop_n(out, n))
+        return popped;
+      wait(not_empty_, pop_waiters_, [this] { return !empty(); }, nullptr);
+    }
+  }
+
+private:
+  struct slot
+  {
+    std::atomic<size_type> seq;
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+  };
+
+  struct alignas(GPCL_CACHELINE_SIZE) position
+  {
+    std::atomic<size_type> pos{0};
+  };
+
+  bool full() const noexcept
+  {
+    size_type pos = tail_.pos.load(std::memory_order_relaxed);
+    size_type seq = slots_[pos & mask_].seq.load(std::memory_order_acquire);
+    return static_cast<std::ptrdiff_t>(seq - pos) < 0;
+  }
+
+  bool empty() const noexcept
+  {
+    size_type pos = head_.pos.load(std::memory_order_relaxed);
+    size_type seq = slots_[pos & mask_].seq.load(std::memory_order_acquire);
+    return static_cast<std::ptrdiff_t>(seq - (pos + 1)) < 0;
+  }
+
+  // Sleeps on word unless ready() holds after registering as a waiter; the
+  // fences pair with the one in notify(), so that either the waker sees the
+  // waiter or the waiter sees the change.
+  template <typename Predicate>
+  static void wait(detail::futex_word &word,
+                   std::atomic<std::uint32_t> &waiters, Predicate ready,
+                   const timespec *timeout) noexcept
+  {
+    waiters.fetch_add(1);
+    std::uint32_t seq = word.load();
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!ready())
+      detail::futex_wait(word, seq, timeout, false);
+    waiters.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  static void notify(detail::futex_word &word,
+                     std::atomic<std::uint32_t> &waiters,
+                     size_type count) noexcept
+  {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waiters.load(std::memory_order_relaxed) == 0)
+      return;
+    word.fetch_add(1);
+    detail::futex_wake(word, count > INT_MAX ? INT_MAX : int(count), false);
+  }
+
+  size_type mask_;
+  std::unique_ptr<slot[]> slots_;
+
+  position tail_;
+  alignas(GPCL_CACHELINE_SIZE) detail::futex_word not_empty_{0};
+  std::atomic<std::uint32_t> pop_waiters_{0};
+
+  position head_;
+  alignas(GPCL_CACHELINE_SIZE) detail::futex_word not_full_{0};
+  std::atomic<std::uint32_t> push_waiters_{0};
+};
+
+} // namespace gpcl
+
+#endif // GPCL_POSIX
+
+#endif // GPCL_MPMC_QUEUE_HPP
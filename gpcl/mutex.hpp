@@ -17,7 +17,9 @@
 #include <gpcl/detail/win_mutex.hpp>
 #include <gpcl/noncopyable.hpp>
 #include <gpcl/thread_annotations.hpp>
+#include <gpcl/time.hpp>
 #include <type_traits>
+#include <utility>
 
 namespace gpcl {
 
@@ -148,6 +150,21 @@ public:
         chrono::duration_cast<system_clock::duration>(rel_time));
   }
 
+#if defined(GPCL_POSIX)
+  /// Tries to lock the mutex until deadline at the latest. Unlike a
+  /// system_clock time point, an instant is not affected by setting the
+  /// system clock.
+  GPCL_TRY_ACQUIRE(true) auto try_lock_until(const instant &deadline) -> bool
+  {
+    return impl_.try_lock_until(deadline);
+  }
+
+  GPCL_TRY_ACQUIRE(true) auto try_lock_for(const duration &rel_time) -> bool
+  {
+    return impl_.try_lock_until(instant::now().saturating_add(rel_time));
+  }
+#endif
+
   auto native_handle() noexcept -> native_handle_type
   {
     return impl_.native_handle();
@@ -0,0 +1,83 @@
+//
+// numa_pool.hpp
+// ~~~~~~~~~~~~~
+//
+// Copyright (c) 2020 Zhengyi Fu (tsingyat at outlook dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef GPCL_NUMA_POOL_HPP
+#define GPCL_NUMA_POOL_HPP
+
+#include <gpcl/detail/config.hpp>
+#include <gpcl/detail/error.hpp>
+#include <gpcl/pmr/numa_resource.hpp>
+#include <gpcl/pool.hpp>
+
+#ifdef GPCL_POSIX
+
+namespace gpcl {
+
+/// A user allocator that obtains blocks placed on NUMA node Node, or on the
+/// node of the allocating thread if Node is pmr::numa_resource::local_node.
+///
+/// Every block is mapped separately and rounded up to whole pages, so pools
+/// using this allocator should request large blocks.
+template <int Node, pmr::numa_policy Policy = pmr::numa_policy::prefer>
+struct numa_user_allocator
+{
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+
+  [[nodiscard]] static char *malloc(size_type sz) noexcept
+  {
+    char *p = nullptr;
+    GPCL_TRY
+    {
+      p = static_cast<char *>(resource().allocate(header_size + sz));
+    }
+    GPCL_CATCH (...)
+    {
+      return nullptr;
+    }
+    GPCL_CATCH_END
+    *reinterpret_cast<size_type *>(p) = sz;
+    return p + header_size;
+  }
+
+  static void free(char *p) noexcept
+  {
+    p -= header_size;
+    resource().deallocate(p, header_size + *reinterpret_cast<size_type *>(p));
+  }
+
+  /// \returns The resource the blocks are mapped from.
+  static pmr::numa_resource &resource()
+  {
+    static pmr::numa_resource instance(Node, Policy);
+    return instance;
+  }
+
+private:
+  // Keeps the block size in front of the block.
+  static constexpr size_type header_size = alignof(std::max_align_t);
+};
+
+/// A singleton_pool whose chunks live on NUMA node Node.
+///
+/// Each node has its own pool, so threads pinned to a node can allocate from
+/// the pool of that node and get node-local chunks, e.g.
+/// `numa_singleton_pool<tag, 64, 1>::malloc()` on the threads of node 1.
+/// On a single-node machine every node's pool behaves like a singleton_pool.
+template <typename Tag, unsigned RequestedSize, int Node,
+          typename Statistics = null_pool_statistics>
+using numa_singleton_pool =
+    singleton_pool<Tag, RequestedSize, numa_user_allocator<Node>, Statistics>;
+
+} // namespace gpcl
+
+#endif // GPCL_POSIX
+
+#endif // GPCL_NUMA_POOL_HPP
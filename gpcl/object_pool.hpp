@@ -20,7 +20,8 @@
 namespace gpcl {
 
 template <typename T, typename UA = default_new_delete_user_allocator,
-          typename MutexType = gpcl::mutex>
+          typename MutexType = gpcl::mutex,
+          typename Statistics = null_pool_statistics>
 class object_pool
 {
   struct chunk_info
@@ -34,6 +35,7 @@ public:
   using element_type = T;
   using user_allocator = UA;
   using mutex_type = MutexType;
+  using statistics_type = Statistics;
   using size_type = typename user_allocator::size_type;
   using difference_type = typename user_allocator::difference_type;
 
@@ -55,7 +57,7 @@ public:
 
   element_type *malloc()
   {
-    gpcl::unique_lock<mutex_type> lock(p_.second());
+    auto lock = lock_pool();
 
     auto *obj = reinterpret_cast<chunk_info *>(p_.first().malloc());
     obj->prev = nullptr;
@@ -70,7 +72,7 @@ public:
   {
     GPCL_ASSERT(p != nullptr);
     auto *obj = reinterpret_cast<chunk_info *>(p);
-    gpcl::unique_lock<mutex_type> lock(p_.second());
+    auto lock = lock_pool();
 
     auto prev = obj->prev;
     auto next = obj->next;
@@ -99,15 +101,32 @@ public:
     this->free(p);
   }
 
-  size_type get_next_size() const { p_.first().get_next_size(); }
+  size_type get_next_size() const { return p_.first().get_next_size(); }
 
   void set_next_size(size_type next_size)
   {
     p_.first().set_next_size(next_size);
   }
 
+  statistics_type &statistics() noexcept { return p_.first().statistics(); }
+
+  const statistics_type &statistics() const noexcept
+  {
+    return p_.first().statistics();
+  }
+
 private:
-  detail::compressed_pair<pool<user_allocator, null_mutex>, mutex_type> p_;
+  using pool_type =
+      pool<user_allocator, null_mutex,
+           simple_segregated_storage<size_type>, statistics_type>;
+
+  gpcl::unique_lock<mutex_type> lock_pool()
+  {
+    p_.first().statistics().lock(p_.second());
+    return gpcl::unique_lock<mutex_type>(p_.second(), adopt_lock);
+  }
+
+  detail::compressed_pair<pool_type, mutex_type> p_;
   chunk_info *obj_list_;
 };
 
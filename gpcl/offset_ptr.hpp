@@ -15,7 +15,9 @@
 #include <gpcl/detail/config.hpp>
 #include <gpcl/detail/type_traits.hpp>
 #include "narrow_cast.hpp"
+#include <iterator>
 #include <limits>
+#include <memory>
 #include <string>
 
 namespace gpcl {
@@ -59,15 +61,20 @@ std::intptr_t as_integer(T *ptr)
 template <typename T>
 class offset_ptr : public detail::offset_ptr_base<T>
 {
-private:
+public:
   using iterator_category = std::random_access_iterator_tag;
 
+  using element_type = T;
   using value_type = typename std::decay<T>::type;
   typedef T *pointer;
   std::size_t typedef size_type;
   std::ptrdiff_t typedef difference_type;
   std::intptr_t typedef offset_type;
 
+  template <typename U>
+  using rebind = offset_ptr<U>;
+
+private:
   constexpr static offset_type poison =
       (std::numeric_limits<offset_type>::max)();
   offset_type offset_; // offset in bytes to this
@@ -90,6 +97,24 @@ public:
   {
   }
 
+  /// Converts from an offset_ptr to a type whose pointer converts to T*.
+  template <typename U, typename std::enable_if<
+                            std::is_convertible<U *, T *>::value &&
+                                !std::is_same<U, T>::value,
+                            int>::type = 0>
+  GPCL_DECL_INLINE offset_ptr(const offset_ptr<U> &other)
+      : offset_ptr(static_cast<U *>(other))
+  {
+  }
+
+  /// \returns An offset_ptr to r, for std::pointer_traits.
+  template <typename U = T,
+            typename std::enable_if<!std::is_void<U>::value, int>::type = 0>
+  GPCL_DECL_INLINE static offset_ptr pointer_to(U &r)
+  {
+    return offset_ptr(std::addressof(r));
+  }
+
   /// Converts to raw pointer
   GPCL_DECL_INLINE constexpr operator pointer() const { return _real_ptr(); }
 
@@ -218,7 +243,7 @@ public:
 
   GPCL_DECL_INLINE constexpr bool operator!=(pointer ptr) const
   {
-    return this->_real_ptr() == ptr;
+    return this->_real_ptr() != ptr;
   }
 
   template <
@@ -0,0 +1,86 @@
+//
+// arena.hpp
+// ~~~~~~~~~
+//
+// Copyright (c) 2020 Zhengyi Fu (tsingyat at outlook dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef GPCL_PMR_ARENA_HPP
+#define GPCL_PMR_ARENA_HPP
+
+#include <gpcl/assert.hpp>
+#include <gpcl/detail/config.hpp>
+#include <gpcl/detail/error.hpp>
+#include <gpcl/pmr/monotonic_buffer_resource.hpp>
+#include <cstdint>
+#include <new>
+
+namespace gpcl {
+namespace pmr {
+
+/// A monotonic_buffer_resource with an inline, non-virtual allocation path.
+///
+/// allocate_bytes() and allocate_object<T>() align the bump pointer with a
+/// mask and take the slow path only when the current block is exhausted;
+/// they never go through a virtual call. The blocks, reset() and release()
+/// are those of monotonic_buffer_resource, and an arena can still be passed
+/// wherever a memory_resource is expected, e.g. to polymorphic_allocator.
+///
+/// \notes Allocations made through the inline path are not reported to
+/// the statistics object; block usage still is.
+class arena final : public monotonic_buffer_resource
+{
+public:
+  using monotonic_buffer_resource::monotonic_buffer_resource;
+
+  /// \returns Memory for bytes bytes aligned to alignment.
+  ///
+  /// \requires alignment is a power of two.
+  /// \throws Whatever the upstream resource throws when a new block is
+  /// needed.
+  GPCL_DECL_INLINE void *
+  allocate_bytes(std::size_t bytes,
+                 std::size_t alignment = alignof(std::max_align_t))
+  {
+    GPCL_ASSERT(alignment != 0 && (alignment & (alignment - 1)) == 0);
+    GPCL_ASSERT(bytes <= std::size_t(PTRDIFF_MAX));
+
+    // Zero-sized requests get distinct non-null pointers.
+    bytes += bytes == 0;
+
+    auto aligned = (reinterpret_cast<std::uintptr_t>(cur_) + alignment - 1) &
+                   ~std::uintptr_t(alignment - 1);
+    auto next = aligned + bytes;
+    if (next <= reinterpret_cast<std::uintptr_t>(end_))
+    {
+      cur_ = reinterpret_cast<char *>(next);
+      return reinterpret_cast<void *>(aligned);
+    }
+    return allocate_slow(bytes, alignment);
+  }
+
+  /// \returns Uninitialized memory for n objects of type T.
+  ///
+  /// \throws std::bad_array_new_length if n * sizeof(T) overflows.
+  template <typename T>
+  GPCL_DECL_INLINE T *allocate_object(std::size_t n = 1)
+  {
+    if (n > std::size_t(PTRDIFF_MAX) / sizeof(T))
+      GPCL_THROW(std::bad_array_new_length());
+    return static_cast<T *>(allocate_bytes(n * sizeof(T), alignof(T)));
+  }
+
+private:
+  void *do_allocate(std::size_t bytes, std::size_t alignment) override
+  {
+    return allocate_bytes(bytes, alignment);
+  }
+};
+
+} // namespace pmr
+} // namespace gpcl
+
+#endif // GPCL_PMR_ARENA_HPP
@@ -12,15 +12,50 @@
 #define GPCL_PMR_DEFAULT_RESOURCE_HPP
 
 #include <gpcl/detail/config.hpp>
+#include <gpcl/noncopyable.hpp>
 #include <gpcl/pmr/memory_resource.hpp>
 
 namespace gpcl {
 namespace pmr {
 
+/// \returns The default resource of the calling thread if one is set,
+/// otherwise the process-wide default resource.
 GPCL_DECL memory_resource *get_default_resource() noexcept;
 
+/// Sets the process-wide default resource, which threads without a default
+/// resource of their own use.
 GPCL_DECL void set_default_resource(memory_resource *resource) noexcept;
 
+/// \returns The default resource of the calling thread, or null if the
+/// thread uses the process-wide one.
+GPCL_DECL memory_resource *get_thread_default_resource() noexcept;
+
+/// Sets the default resource of the calling thread. Null makes the thread
+/// use the process-wide default resource again.
+///
+/// \returns The previous default resource of the calling thread.
+GPCL_DECL memory_resource *
+set_thread_default_resource(memory_resource *resource) noexcept;
+
+/// Makes a resource the default resource of the calling thread for the
+/// lifetime of the guard, then restores the previous one.
+///
+/// Guards nest, and must be destroyed in the reverse order of their
+/// construction, on the thread that created them.
+class scoped_default_resource : noncopyable
+{
+public:
+  explicit scoped_default_resource(memory_resource *resource) noexcept
+      : previous_(set_thread_default_resource(resource))
+  {
+  }
+
+  ~scoped_default_resource() { set_thread_default_resource(previous_); }
+
+private:
+  memory_resource *previous_;
+};
+
 } // namespace pmr
 } // namespace gpcl
 
@@ -21,12 +21,19 @@ namespace pmr {
 
 namespace pmr_detail {
 
-std::atomic<memory_resource *> &default_memory_resource()
+GPCL_DECL std::atomic<memory_resource *> &default_memory_resource()
 {
   static std::atomic<memory_resource *> instance = pmr::new_delete_resource();
   return instance;
 }
 
+GPCL_DECL memory_resource *&thread_default_memory_resource() noexcept
+{
+  // Constant-initialized, so access needs no guard.
+  static thread_local memory_resource *instance = nullptr;
+  return instance;
+}
+
 } // namespace pmr_detail
 
 void set_default_resource(memory_resource *resource) noexcept
@@ -37,9 +44,24 @@ void set_default_resource(memory_resource *resource) noexcept
 
 memory_resource *get_default_resource() noexcept
 {
+  if (memory_resource *r = pmr_detail::thread_default_memory_resource())
+    return r;
   return pmr_detail::default_memory_resource().load(std::memory_order_acquire);
 }
 
+memory_resource *get_thread_default_resource() noexcept
+{
+  return pmr_detail::thread_default_memory_resource();
+}
+
+memory_resource *set_thread_default_resource(memory_resource *resource) noexcept
+{
+  memory_resource *&current = pmr_detail::thread_default_memory_resource();
+  memory_resource *previous = current;
+  current = resource;
+  return previous;
+}
+
 } // namespace pmr
 } // namespace gpcl
 
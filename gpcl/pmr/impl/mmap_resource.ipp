@@ -0,0 +1,204 @@
+//
+// mmap_resource.ipp
+// ~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2020 Zhengyi Fu (tsingyat at outlook dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef GPCL_PMR_IMPL_MMAP_RESOURCE_IPP
+#define GPCL_PMR_IMPL_MMAP_RESOURCE_IPP
+
+#include <gpcl/pmr/mmap_resource.hpp>
+
+#ifdef GPCL_POSIX
+
+#include <gpcl/assert.hpp>
+#include <gpcl/detail/error.hpp>
+#include <gpcl/unique_lock.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <new>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace gpcl {
+namespace pmr {
+
+namespace pmr_detail {
+
+GPCL_DECL_INLINE std::size_t round_up(std::size_t n, std::size_t align)
+{
+  return (n + align - 1) / align * align;
+}
+
+} // namespace pmr_detail
+
+mmap_resource::mmap_resource(const mmap_resource_options &opts)
+    : opts_(opts),
+      page_size_(static_cast<std::size_t>(::sysconf(_SC_PAGESIZE)))
+{
+  GPCL_ASSERT(opts.huge_page_size != 0 &&
+              (opts.huge_page_size & (opts.huge_page_size - 1)) == 0);
+  if (opts_.huge_page_size < page_size_)
+    opts_.huge_page_size = page_size_;
+}
+
+mmap_resource::~mmap_resource() { trim(); }
+
+std::size_t mmap_resource::cached_bytes() const
+{
+  unique_lock<mutex> lock(cache_mtx_);
+  return cached_bytes_;
+}
+
+void mmap_resource::trim()
+{
+  unique_lock<mutex> lock(cache_mtx_);
+  for (const cached_mapping &m : cache_)
+    GPCL_VERIFY_0(::munmap(m.addr, m.size));
+  cache_.clear();
+  cached_bytes_ = 0;
+}
+
+std::size_t mmap_resource::mapping_size(std::size_t bytes) const noexcept
+{
+  bytes = (std::max)(bytes, std::size_t(1));
+  if (opts_.huge_pages == huge_page_mode::explicit_pages ||
+      (opts_.huge_pages == huge_page_mode::transparent &&
+       bytes >= opts_.huge_page_size))
+    return pmr_detail::round_up(bytes, opts_.huge_page_size);
+  return pmr_detail::round_up(bytes, page_size_);
+}
+
+void *mmap_resource::do_allocate(std::size_t bytes, std::size_t alignment)
+{
+  std::size_t size = mapping_size(bytes);
+  if (size < bytes)
+    GPCL_THROW(std::bad_alloc());
+
+  if (opts_.max_cached_bytes != 0)
+  {
+    if (void *p = take_cached(size, alignment))
+      return p;
+  }
+  return map(size, alignment);
+}
+
+void mmap_resource::do_deallocate(void *p, std::size_t bytes,
+                                  std::size_t alignment)
+{
+  (void)alignment;
+  std::size_t size = mapping_size(bytes);
+
+  if (opts_.max_cached_bytes != 0)
+  {
+    unique_lock<mutex> lock(cache_mtx_);
+    if (cached_bytes_ + size <= opts_.max_cached_bytes)
+    {
+      // Keep the address range but give the pages back.
+      GPCL_VERIFY_0(::madvise(p, size, MADV_DONTNEED));
+      cache_.push_back(cached_mapping{p, size});
+      cached_bytes_ += size;
+      return;
+    }
+  }
+  GPCL_VERIFY_0(::munmap(p, size));
+}
+
+bool mmap_resource::do_is_equal(const memory_resource &other) const noexcept
+{
+  return &other == this;
+}
+
+void *mmap_resource::map(std::size_t size, std::size_t alignment)
+{
+  constexpr int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+
+#ifdef MAP_HUGETLB
+  if (opts_.huge_pages == huge_page_mode::explicit_pages &&
+      alignment <= opts_.huge_page_size)
+  {
+    // Huge page mappings are aligned to the huge page size.
+    void *p = ::mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                     flags | MAP_HUGETLB | (opts_.populate ? MAP_POPULATE : 0),
+                     -1, 0);
+    if (p != MAP_FAILED)
+      return p;
+  }
+#endif
+
+  bool huge = opts_.huge_pages != huge_page_mode::none &&
+              size >= opts_.huge_page_size;
+  std::size_t align = (std::max)(alignment, page_size_);
+  if (huge)
+    align = (std::max)(align, opts_.huge_page_size);
+
+  // Over-map to find an aligned range, then unmap the excess. Pre-faulting
+  // is done afterwards, so that the excess is never touched.
+  std::size_t extra = align - page_size_;
+  if (size + extra < size)
+    GPCL_THROW(std::bad_alloc());
+  int populate = (opts_.populate && !huge && extra == 0) ? MAP_POPULATE : 0;
+  void *m = ::mmap(nullptr, size + extra, PROT_READ | PROT_WRITE,
+                   flags | populate, -1, 0);
+  if (m == MAP_FAILED)
+    GPCL_THROW(std::bad_alloc());
+
+  auto begin = reinterpret_cast<std::uintptr_t>(m);
+  auto aligned = pmr_detail::round_up(begin, align);
+  if (aligned != begin)
+    ::munmap(m, aligned - begin);
+  if (std::size_t tail = extra - (aligned - begin))
+    ::munmap(reinterpret_cast<void *>(aligned + size), tail);
+
+  auto *p = reinterpret_cast<char *>(aligned);
+#ifdef MADV_HUGEPAGE
+  if (huge)
+    ::madvise(p, size, MADV_HUGEPAGE);
+#endif
+  if (opts_.populate && !populate)
+    prefault(p, size);
+  return p;
+}
+
+void *mmap_resource::take_cached(std::size_t size, std::size_t alignment)
+{
+  unique_lock<mutex> lock(cache_mtx_);
+  auto it = std::find_if(cache_.begin(), cache_.end(),
+                         [&](const cached_mapping &m) {
+                           return m.size == size &&
+                                  reinterpret_cast<std::uintptr_t>(m.addr) %
+                                          alignment ==
+                                      0;
+                         });
+  if (it == cache_.end())
+    return nullptr;
+
+  void *p = it->addr;
+  *it = cache_.back();
+  cache_.pop_back();
+  cached_bytes_ -= size;
+  lock.unlock();
+
+  if (opts_.populate)
+    prefault(p, size);
+  return p;
+}
+
+void mmap_resource::prefault(void *p, std::size_t size) const noexcept
+{
+  // Anonymous memory reads as zero, so writing zeros only faults the pages
+  // in.
+  for (std::size_t off = 0; off < size; off += page_size_)
+    static_cast<volatile char *>(p)[off] = 0;
+}
+
+} // namespace pmr
+} // namespace gpcl
+
+#endif // GPCL_POSIX
+
+#endif // GPCL_PMR_IMPL_MMAP_RESOURCE_IPP
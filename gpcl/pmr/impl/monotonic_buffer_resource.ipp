@@ -20,91 +20,232 @@ namespace pmr {
 monotonic_buffer_resource::monotonic_buffer_resource(void *buffer,
                                                      std::size_t size,
                                                      memory_resource *upstream)
-    : buffer_(reinterpret_cast<char *>(buffer), size),
-      upstream_(upstream)
+    : monotonic_buffer_resource(buffer, size, monotonic_buffer_options(),
+                                upstream)
 {
-  GPCL_ASSERT(buffer);
-  GPCL_ASSERT(upstream);
 }
 
 monotonic_buffer_resource::monotonic_buffer_resource(std::size_t initial_buffer,
                                                      memory_resource *upstream)
+    : monotonic_buffer_resource(
+          monotonic_buffer_options{initial_buffer, 2.0, 0}, upstream)
+{
+  allocate_slow(0, 1);
+}
+
+monotonic_buffer_resource::monotonic_buffer_resource(
+    const monotonic_buffer_options &opts, memory_resource *upstream)
     : upstream_(upstream),
-      next_buffer_bytes_(initial_buffer)
+      opts_(opts),
+      next_buffer_bytes_(opts.initial_size)
 {
-  GPCL_ASSERT(initial_buffer != 0);
+  GPCL_ASSERT(opts.initial_size != 0);
+  GPCL_ASSERT(opts.growth_factor >= 1.0);
   GPCL_ASSERT(upstream);
-  request_from_upstream();
+}
+
+monotonic_buffer_resource::monotonic_buffer_resource(
+    void *buffer, std::size_t size, const monotonic_buffer_options &opts,
+    memory_resource *upstream)
+    : monotonic_buffer_resource(opts, upstream)
+{
+  GPCL_ASSERT(buffer);
+  initial_buffer_ = static_cast<char *>(buffer);
+  initial_size_ = size;
+  rewind_to_initial_buffer();
 }
 
 void monotonic_buffer_resource::release()
 {
-  while (block_list_.ptr)
+  reset(reset_mode::keep_all);
+  while (spare_)
+  {
+    block_header *next = spare_->next;
+    deallocate_block(spare_);
+    spare_ = next;
+  }
+  next_buffer_bytes_ = opts_.initial_size;
+
+  GPCL_VERIFY(upstream_bytes_ == 0);
+}
+
+void monotonic_buffer_resource::reset(reset_mode mode)
+{
+  // Move the used blocks in front of the spare ones, restoring the order in
+  // which they were obtained.
+  while (used_)
+  {
+    block_header *next = used_->next;
+    used_->next = spare_;
+    spare_ = used_;
+    used_ = next;
+  }
+
+  if (mode == reset_mode::keep_largest && spare_)
+  {
+    block_header *largest = spare_;
+    for (block_header *b = spare_->next; b; b = b->next)
+      if (b->size > largest->size)
+        largest = b;
+
+    while (spare_)
+    {
+      block_header *next = spare_->next;
+      if (spare_ != largest)
+        deallocate_block(spare_);
+      spare_ = next;
+    }
+    largest->next = nullptr;
+    spare_ = largest;
+  }
+
+  if (stats_)
+    stats_->on_purge();
+  rewind_to_initial_buffer();
+}
+
+void monotonic_buffer_resource::rewind(const checkpoint &cp) noexcept
+{
+  // Same order as in reset(): the most recent block ends up last.
+  while (used_ != cp.block_)
+  {
+    GPCL_ASSERT(used_);
+    block_header *next = used_->next;
+    used_->next = spare_;
+    spare_ = used_;
+    used_ = next;
+  }
+
+  if (used_)
+  {
+    cur_ = cp.cur_;
+    end_ = reinterpret_cast<char *>(used_) + used_->size;
+  }
+  else
+  {
+    rewind_to_initial_buffer();
+    GPCL_ASSERT(cp.cur_ == cur_ || (cp.cur_ > cur_ && cp.cur_ <= end_));
+    cur_ = cp.cur_;
+  }
+}
+
+void monotonic_buffer_resource::set_statistics(pool_statistics *stats) noexcept
+{
+  for (block_header *list : {used_, spare_})
   {
-    block_info next;
-    std::memcpy(&next,
-                reinterpret_cast<char *>(block_list_.ptr) + block_list_.size,
-                sizeof(next));
-    upstream_->deallocate(block_list_.ptr,
-                          block_list_.size + sizeof(block_info),
-                          block_list_.alignment);
-    block_list_ = next;
+    for (block_header *b = list; b; b = b->next)
+    {
+      if (stats_)
+        stats_->on_block_released(b->size);
+      if (stats)
+        stats->on_block_acquired(b->size);
+    }
   }
+  stats_ = stats;
+}
+
+void *monotonic_buffer_resource::allocate_slow(std::size_t bytes,
+                                               std::size_t alignment)
+{
+  // Enough for the header, the bytes and any alignment padding.
+  std::size_t needed = header_size + bytes;
+  if (alignment > alignof(std::max_align_t))
+    needed += alignment;
+
+  // Reuse the first spare block that fits.
+  for (block_header **link = &spare_; *link; link = &(*link)->next)
+  {
+    block_header *b = *link;
+    if (b->size >= needed)
+    {
+      *link = b->next;
+      use_block(b);
+      return alloc_from_buffer(bytes, alignment);
+    }
+  }
+
+  std::size_t size = header_size + next_buffer_bytes_;
+  if (size < needed)
+    size = needed;
+  size = (size + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) *
+         alignof(std::max_align_t);
+
+  auto *b = static_cast<block_header *>(
+      upstream_->allocate(size, alignof(std::max_align_t)));
+  b->size = size;
+  upstream_bytes_ += size;
+  if (stats_)
+    stats_->on_block_acquired(size);
+  use_block(b);
+
+  auto next = static_cast<std::size_t>(double(next_buffer_bytes_) *
+                                       opts_.growth_factor);
+  if (next <= next_buffer_bytes_)
+    next = next_buffer_bytes_ + 1;
+  if (opts_.max_block_size != 0 && next > opts_.max_block_size)
+    next = (std::max)(opts_.max_block_size, std::size_t(1));
+  next_buffer_bytes_ = next;
 
-  GPCL_VERIFY(block_list_.ptr == nullptr);
-  GPCL_VERIFY(block_list_.size == 0);
+  return alloc_from_buffer(bytes, alignment);
 }
 
 void *monotonic_buffer_resource::alloc_from_buffer(std::size_t bytes,
                                                    std::size_t alignment)
 {
-  std::uintptr_t off =
-      reinterpret_cast<std::uintptr_t>(buffer_.data()) % alignment;
+  if (!cur_)
+    return nullptr;
+
+  std::uintptr_t off = reinterpret_cast<std::uintptr_t>(cur_) % alignment;
   off = (alignment - off) % alignment;
 
-  if (off > buffer_.size_bytes())
-    return nullptr;
-  buffer_ += off;
-  if (buffer_.size_bytes() < bytes)
+  std::size_t avail = static_cast<std::size_t>(end_ - cur_);
+  if (off > avail || bytes > avail - off)
     return nullptr;
-  auto *ret = buffer_.data();
-  buffer_ += bytes;
+  char *ret = cur_ + off;
+  cur_ = ret + bytes;
   return ret;
 }
 
-void monotonic_buffer_resource::request_from_upstream()
+void monotonic_buffer_resource::use_block(block_header *block) noexcept
 {
-  auto *p = upstream_->allocate(next_buffer_bytes_ + sizeof(block_info));
-  std::memcpy(reinterpret_cast<char *>(p) + next_buffer_bytes_, &block_list_,
-              sizeof block_list_);
-  block_list_.ptr = p;
-  block_list_.size = next_buffer_bytes_;
-  block_list_.alignment = alignof(std::max_align_t);
-  buffer_ = buffer(p, next_buffer_bytes_);
-  next_buffer_bytes_ *= 2;
+  block->next = used_;
+  used_ = block;
+  cur_ = reinterpret_cast<char *>(block) + header_size;
+  end_ = reinterpret_cast<char *>(block) + block->size;
 }
 
-void *monotonic_buffer_resource::do_allocate(std::size_t bytes,
-                                             std::size_t alignment)
+void monotonic_buffer_resource::deallocate_block(block_header *block) noexcept
 {
-  if (auto ret = alloc_from_buffer(bytes, alignment))
-    return ret;
+  upstream_bytes_ -= block->size;
+  if (stats_)
+    stats_->on_block_released(block->size);
+  upstream_->deallocate(block, block->size, alignof(std::max_align_t));
+}
 
-  if (next_buffer_bytes_ < bytes)
-    next_buffer_bytes_ = (bytes + sizeof(std::max_align_t) - 1) /
-                         sizeof(std::max_align_t) * sizeof(std::max_align_t);
+void monotonic_buffer_resource::rewind_to_initial_buffer() noexcept
+{
+  cur_ = initial_buffer_;
+  end_ = initial_buffer_ ? initial_buffer_ + initial_size_ : nullptr;
+}
 
-  request_from_upstream();
+void *monotonic_buffer_resource::do_allocate(std::size_t bytes,
+                                             std::size_t alignment)
+{
+  auto *ret = alloc_from_buffer(bytes, alignment);
+  if (!ret)
+    ret = allocate_slow(bytes, alignment);
 
-  return alloc_from_buffer(bytes, alignment);
+  if (stats_)
+    stats_->on_allocate(ret, 1, bytes);
+  return ret;
 }
 
 void monotonic_buffer_resource::do_deallocate(void *p, std::size_t bytes,
                                               std::size_t alignment)
 {
-  (void)p;
-  (void)bytes;
   (void)alignment;
+  if (stats_)
+    stats_->on_deallocate(p, 1, bytes);
 }
 
 bool monotonic_buffer_resource::do_is_equal(
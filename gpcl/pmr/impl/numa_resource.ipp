@@ -0,0 +1,73 @@
+//
+// numa_resource.ipp
+// ~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2020 Zhengyi Fu (tsingyat at outlook dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef GPCL_PMR_IMPL_NUMA_RESOURCE_IPP
+#define GPCL_PMR_IMPL_NUMA_RESOURCE_IPP
+
+#include <gpcl/pmr/numa_resource.hpp>
+
+#ifdef GPCL_POSIX
+
+#include <gpcl/assert.hpp>
+
+namespace gpcl {
+namespace pmr {
+
+namespace pmr_detail {
+
+GPCL_DECL_INLINE mmap_resource_options
+without_populate(mmap_resource_options opts)
+{
+  opts.populate = false;
+  return opts;
+}
+
+} // namespace pmr_detail
+
+numa_resource::numa_resource(int node, numa_policy policy,
+                             const mmap_resource_options &opts)
+    : mmap_resource(pmr_detail::without_populate(opts)),
+      node_(node),
+      policy_(policy),
+      populate_(opts.populate),
+      binding_(node_count() > 1)
+{
+  GPCL_ASSERT(node == local_node || (node >= 0 && node < node_count()) ||
+              !binding());
+}
+
+void *numa_resource::do_allocate(std::size_t bytes, std::size_t alignment)
+{
+  void *p = mmap_resource::do_allocate(bytes, alignment);
+
+  if (binding())
+  {
+    int node = node_ == local_node ? current_node() : node_;
+    if (detail::numa_bind(p, mapping_size(bytes), node,
+                          policy_ == numa_policy::bind) != 0)
+    {
+      // Typically ENOSYS or EPERM in a sandbox. The memory is still usable;
+      // later allocations do not try again.
+      binding_.store(false, std::memory_order_relaxed);
+    }
+  }
+
+  // Fault the pages in only after the policy is set.
+  if (populate_)
+    prefault(p, mapping_size(bytes));
+  return p;
+}
+
+} // namespace pmr
+} // namespace gpcl
+
+#endif // GPCL_POSIX
+
+#endif // GPCL_PMR_IMPL_NUMA_RESOURCE_IPP
@@ -0,0 +1,120 @@
+//
+// synchronized_pool_resource.ipp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2020 Zhengyi Fu (tsingyat at outlook dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef GPCL_PMR_IMPL_SYNCHRONIZED_POOL_RESOURCE_IPP
+#define GPCL_PMR_IMPL_SYNCHRONIZED_POOL_RESOURCE_IPP
+
+#include <gpcl/pmr/synchronized_pool_resource.hpp>
+#include <gpcl/unique_lock.hpp>
+#include <algorithm>
+
+namespace gpcl {
+namespace pmr {
+
+synchronized_pool_resource::synchronized_pool_resource(
+    const pool_options &opts, memory_resource *upstream)
+    : upstream_(upstream),
+      opts_(detail::normalize_pool_options(opts)),
+      class_count_(detail::pool_size_class_count(opts_)),
+      classes_(new size_class[class_count_])
+{
+  GPCL_ASSERT(upstream);
+  for (std::size_t i = 0; i < class_count_; ++i)
+  {
+    classes_[i].pool.configure(detail::pool_resource_min_block << i,
+                               opts_.max_blocks_per_chunk);
+    reset_cache(classes_[i]);
+  }
+}
+
+synchronized_pool_resource::~synchronized_pool_resource() { release(); }
+
+void synchronized_pool_resource::release()
+{
+  for (std::size_t i = 0; i < class_count_; ++i)
+  {
+    size_class &c = classes_[i];
+    reset_cache(c);
+    unique_lock<mutex> lock(c.mtx);
+    c.pool.release(upstream_);
+  }
+
+  unique_lock<mutex> lock(oversized_mtx_);
+  oversized_.release(upstream_);
+}
+
+void *synchronized_pool_resource::do_allocate(std::size_t bytes,
+                                              std::size_t alignment)
+{
+  std::size_t i = detail::pool_size_class_index(bytes, alignment);
+  if (i >= class_count_ ||
+      alignment > detail::pool_resource_max_block_alignment)
+  {
+    unique_lock<mutex> lock(oversized_mtx_);
+    return oversized_.allocate(upstream_, bytes, alignment);
+  }
+
+  size_class &c = classes_[i];
+  if (void *p = c.cache->try_pop())
+    return p;
+
+  void *first;
+  std::size_t n;
+  {
+    unique_lock<mutex> lock(c.mtx);
+    n = c.pool.allocate_batch(upstream_, c.cache->batch_size(), first);
+  }
+  return c.cache->refill(first, n);
+}
+
+void synchronized_pool_resource::do_deallocate(void *p, std::size_t bytes,
+                                               std::size_t alignment)
+{
+  std::size_t i = detail::pool_size_class_index(bytes, alignment);
+  if (i >= class_count_ ||
+      alignment > detail::pool_resource_max_block_alignment)
+  {
+    unique_lock<mutex> lock(oversized_mtx_);
+    oversized_.deallocate(upstream_, p, bytes, alignment);
+    return;
+  }
+
+  classes_[i].cache->push(p);
+}
+
+bool synchronized_pool_resource::do_is_equal(
+    const memory_resource &other) const noexcept
+{
+  return this == &other;
+}
+
+void synchronized_pool_resource::drain(void *context, void *first, void *last)
+{
+  auto *c = static_cast<size_class *>(context);
+  unique_lock<mutex> lock(c->mtx);
+  c->pool.deallocate_batch(first, last);
+}
+
+void synchronized_pool_resource::reset_cache(size_class &c)
+{
+  // Caching about 16 KiB per thread and size class, at least one block.
+  std::size_t batch =
+      (std::max)(std::size_t(1),
+                 (std::min)(std::size_t(32), 8192 / c.pool.block_size()));
+
+  // Replacing the owner orphans the magazines of all threads.
+  c.cache.reset();
+  c.cache.reset(new detail::thread_cache_owner(batch, batch * 2, &drain, &c));
+}
+
+} // namespace pmr
+} // namespace gpcl
+
+#endif // GPCL_PMR_IMPL_SYNCHRONIZED_POOL_RESOURCE_IPP
@@ -0,0 +1,69 @@
+//
+// unsynchronized_pool_resource.ipp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2020 Zhengyi Fu (tsingyat at outlook dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef GPCL_PMR_IMPL_UNSYNCHRONIZED_POOL_RESOURCE_IPP
+#define GPCL_PMR_IMPL_UNSYNCHRONIZED_POOL_RESOURCE_IPP
+
+#include <gpcl/pmr/unsynchronized_pool_resource.hpp>
+
+namespace gpcl {
+namespace pmr {
+
+unsynchronized_pool_resource::unsynchronized_pool_resource(
+    const pool_options &opts, memory_resource *upstream)
+    : upstream_(upstream),
+      opts_(detail::normalize_pool_options(opts)),
+      class_count_(detail::pool_size_class_count(opts_)),
+      pools_(new detail::pool_size_class[class_count_])
+{
+  GPCL_ASSERT(upstream);
+  for (std::size_t i = 0; i < class_count_; ++i)
+    pools_[i].configure(detail::pool_resource_min_block << i,
+                        opts_.max_blocks_per_chunk);
+}
+
+void unsynchronized_pool_resource::release()
+{
+  for (std::size_t i = 0; i < class_count_; ++i)
+    pools_[i].release(upstream_);
+  oversized_.release(upstream_);
+}
+
+void *unsynchronized_pool_resource::do_allocate(std::size_t bytes,
+                                                std::size_t alignment)
+{
+  std::size_t i = detail::pool_size_class_index(bytes, alignment);
+  if (i < class_count_ &&
+      alignment <= detail::pool_resource_max_block_alignment)
+    return pools_[i].allocate(upstream_);
+  return oversized_.allocate(upstream_, bytes, alignment);
+}
+
+void unsynchronized_pool_resource::do_deallocate(void *p, std::size_t bytes,
+                                                 std::size_t alignment)
+{
+  std::size_t i = detail::pool_size_class_index(bytes, alignment);
+  if (i < class_count_ &&
+      alignment <= detail::pool_resource_max_block_alignment)
+    pools_[i].deallocate(p);
+  else
+    oversized_.deallocate(upstream_, p, bytes, alignment);
+}
+
+bool unsynchronized_pool_resource::do_is_equal(
+    const memory_resource &other) const noexcept
+{
+  return this == &other;
+}
+
+} // namespace pmr
+} // namespace gpcl
+
+#endif // GPCL_PMR_IMPL_UNSYNCHRONIZED_POOL_RESOURCE_IPP
@@ -98,6 +98,20 @@ private:
   virtual bool do_is_equal(const memory_resource &other) const noexcept = 0;
 };
 
+/// \returns `&a == &b || a.is_equal(b)`.
+inline bool operator==(const memory_resource &a,
+                       const memory_resource &b) noexcept
+{
+  return &a == &b || a.is_equal(b);
+}
+
+/// \returns `!(a == b)`.
+inline bool operator!=(const memory_resource &a,
+                       const memory_resource &b) noexcept
+{
+  return !(a == b);
+}
+
 } // namespace pmr
 } // namespace gpcl
 
@@ -0,0 +1,131 @@
+//
+// mmap_resource.hpp
+// ~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2020 Zhengyi Fu (tsingyat at outlook dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef GPCL_PMR_MMAP_RESOURCE_HPP
+#define GPCL_PMR_MMAP_RESOURCE_HPP
+
+#include <gpcl/detail/config.hpp>
+#include <gpcl/mutex.hpp>
+#include <gpcl/pmr/memory_resource.hpp>
+#include <vector>
+
+#ifdef GPCL_POSIX
+
+namespace gpcl {
+namespace pmr {
+
+/// How mmap_resource uses huge pages.
+enum class huge_page_mode
+{
+  /// Regular pages only.
+  none,
+
+  /// Mappings are aligned to the huge page size and marked with
+  /// madvise(MADV_HUGEPAGE), so that transparent huge pages can back them.
+  transparent,
+
+  /// Mappings use MAP_HUGETLB, which needs huge pages reserved by the
+  /// system; when none are available the mapping falls back to transparent
+  /// huge pages.
+  explicit_pages
+};
+
+/// Options of mmap_resource.
+struct mmap_resource_options
+{
+  huge_page_mode huge_pages = huge_page_mode::none;
+
+  /// Size of a huge page. Must be the system default for explicit_pages.
+  std::size_t huge_page_size = std::size_t(2) << 20;
+
+  /// Pre-faults new mappings (MAP_POPULATE), so the first access to the
+  /// memory does not take page faults.
+  bool populate = false;
+
+  /// Up to this many bytes of deallocated mappings are kept for reuse
+  /// instead of being unmapped. Their pages are returned to the system with
+  /// madvise(MADV_DONTNEED), so a cached mapping costs address space only.
+  std::size_t max_cached_bytes = 0;
+};
+
+/// A thread-safe memory resource that maps anonymous memory for every
+/// allocation.
+///
+/// Every allocation is rounded up to whole pages, or whole huge pages when
+/// huge pages are used, so this resource is meant as the upstream of
+/// resources that request large blocks, such as monotonic_buffer_resource
+/// or the pool resources, rather than for small objects.
+class mmap_resource : public memory_resource
+{
+public:
+  GPCL_DECL explicit mmap_resource(
+      const mmap_resource_options &opts = mmap_resource_options());
+
+  mmap_resource(const mmap_resource &) = delete;
+  mmap_resource &operator=(const mmap_resource &) = delete;
+
+  /// \effects Unmaps the cached mappings.
+  ///
+  /// \requires Every allocation has been deallocated.
+  GPCL_DECL ~mmap_resource() override;
+
+  mmap_resource_options options() const { return opts_; }
+
+  /// \returns The number of bytes held by cached mappings.
+  GPCL_DECL std::size_t cached_bytes() const;
+
+  /// \effects Unmaps the cached mappings.
+  GPCL_DECL void trim();
+
+  /// \returns The size of the mapping that backs an allocation of bytes.
+  GPCL_DECL std::size_t mapping_size(std::size_t bytes) const noexcept;
+
+protected:
+  GPCL_DECL void *do_allocate(std::size_t bytes,
+                              std::size_t alignment) override;
+
+  GPCL_DECL void do_deallocate(void *p, std::size_t bytes,
+                               std::size_t alignment) override;
+
+  GPCL_DECL bool do_is_equal(const memory_resource &other) const
+      noexcept override;
+
+  // Faults in the pages of [p, p + size).
+  GPCL_DECL void prefault(void *p, std::size_t size) const noexcept;
+
+private:
+  struct cached_mapping
+  {
+    void *addr;
+    std::size_t size;
+  };
+
+  GPCL_DECL void *map(std::size_t size, std::size_t alignment);
+
+  GPCL_DECL void *take_cached(std::size_t size, std::size_t alignment);
+
+  mmap_resource_options opts_;
+  std::size_t page_size_;
+
+  mutable mutex cache_mtx_;
+  std::vector<cached_mapping> cache_;
+  std::size_t cached_bytes_{};
+};
+
+} // namespace pmr
+} // namespace gpcl
+
+#endif // GPCL_POSIX
+
+#ifdef GPCL_HEADER_ONLY
+#  include <gpcl/pmr/impl/mmap_resource.ipp>
+#endif
+
+#endif // GPCL_PMR_MMAP_RESOURCE_HPP
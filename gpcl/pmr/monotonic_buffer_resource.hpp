@@ -13,18 +13,76 @@
 
 #include <gpcl/detail/config.hpp>
 #include <gpcl/pmr/default_resource.hpp>
+#include <gpcl/noncopyable.hpp>
 #include <gpcl/pmr/memory_resource.hpp>
+#include <gpcl/pool_statistics.hpp>
 
 namespace gpcl {
 namespace pmr {
 
+/// Growth policy of monotonic_buffer_resource.
+struct monotonic_buffer_options
+{
+  /// Size of the first block requested from upstream.
+  std::size_t initial_size = 32;
+
+  /// Each block requested from upstream is this many times larger than the
+  /// previous one. Must be at least 1.
+  double growth_factor = 2.0;
+
+  /// Blocks do not grow beyond this size, 0 for no limit. A request larger
+  /// than the limit still gets a block large enough for it.
+  std::size_t max_block_size = 0;
+};
+
+/// What reset() keeps of the blocks obtained from upstream.
+enum class reset_mode
+{
+  /// Keep every block for reuse.
+  keep_all,
+
+  /// Keep the largest block and return the others to upstream.
+  keep_largest
+};
+
+/// A memory resource that releases memory only when it is destroyed,
+/// released or reset.
+///
+/// Allocation bumps a pointer through the current block. reset() rewinds the
+/// resource to its initial buffer while keeping the blocks obtained from
+/// upstream, which are used again, in the same order, before any new block
+/// is requested. A loop that allocates the same amounts between resets thus
+/// makes no upstream calls once it reaches a steady state. mark() and
+/// rewind() do the same for the allocations made since a checkpoint, which
+/// gives nested scratch work stack-like reuse of memory.
 class monotonic_buffer_resource : public memory_resource
 {
+protected:
+  struct block_header;
+
 public:
-  monotonic_buffer_resource(void *buffer, std::size_t size,
-                            memory_resource *upstream = get_default_resource());
+  /// A position in the allocation sequence, obtained by mark().
+  class checkpoint
+  {
+    friend class monotonic_buffer_resource;
 
-  explicit monotonic_buffer_resource(
+    checkpoint(block_header *block, char *cur) noexcept
+        : block_(block),
+          cur_(cur)
+    {
+    }
+
+    block_header *block_;
+    char *cur_;
+  };
+
+  /// Uses [buffer, buffer + size) before requesting memory from upstream.
+  GPCL_DECL monotonic_buffer_resource(
+      void *buffer, std::size_t size,
+      memory_resource *upstream = get_default_resource());
+
+  /// Requests a block of initial_buffer bytes from upstream.
+  GPCL_DECL explicit monotonic_buffer_resource(
       std::size_t initial_buffer,
       memory_resource *upstream = get_default_resource());
 
@@ -34,35 +92,137 @@ public:
   {
   }
 
+  GPCL_DECL explicit monotonic_buffer_resource(
+      const monotonic_buffer_options &opts,
+      memory_resource *upstream = get_default_resource());
+
+  /// Uses [buffer, buffer + size) before requesting memory from upstream.
+  GPCL_DECL monotonic_buffer_resource(
+      void *buffer, std::size_t size, const monotonic_buffer_options &opts,
+      memory_resource *upstream = get_default_resource());
+
+  monotonic_buffer_resource(const monotonic_buffer_resource &) = delete;
+  monotonic_buffer_resource &
+  operator=(const monotonic_buffer_resource &) = delete;
+
   ~monotonic_buffer_resource() override { release(); }
 
-  void release();
+  /// \effects Returns every block to upstream, rewinds to the initial buffer
+  /// and restarts the block growth from options().initial_size.
+  GPCL_DECL void release();
+
+  /// \effects Rewinds to the initial buffer, keeping the blocks obtained from
+  /// upstream as selected by mode. The block growth is not restarted.
+  ///
+  /// \notes Every pointer returned by this resource becomes invalid.
+  GPCL_DECL void reset(reset_mode mode = reset_mode::keep_all);
+
+  /// \returns The current position of the allocation sequence.
+  checkpoint mark() const noexcept { return checkpoint(used_, cur_); }
+
+  /// \effects Frees everything allocated since cp was obtained. The blocks
+  /// obtained since then are kept for reuse, as by reset().
+  ///
+  /// \requires cp was obtained from this resource, and neither release(),
+  /// reset() nor a rewind to an earlier checkpoint has been called since.
+  ///
+  /// \complexity Linear in the number of blocks obtained since cp.
+  GPCL_DECL void rewind(const checkpoint &cp) noexcept;
 
   memory_resource *upstream_resource() const { return upstream_; }
 
-private:
-  struct block_info
+  monotonic_buffer_options options() const { return opts_; }
+
+  /// \returns Bytes obtained from upstream and not yet returned.
+  std::size_t upstream_bytes() const noexcept { return upstream_bytes_; }
+
+  /// Starts recording statistics into stats, or stops if stats is null.
+  ///
+  /// The blocks held by this resource move from the previous statistics
+  /// object to the new one. Every allocation counts as one chunk; release()
+  /// and reset() clear the live chunks.
+  ///
+  /// \notes Not thread-safe. stats must outlive this resource or be
+  /// detached first.
+  GPCL_DECL void set_statistics(pool_statistics *stats) noexcept;
+
+  pool_statistics *statistics() const noexcept { return stats_; }
+
+protected:
+  // A block obtained from upstream; the usable memory follows the header.
+  struct block_header
   {
-    void *ptr;
+    block_header *next;
+
+    // Size of the block, header included.
     std::size_t size;
-    std::size_t alignment;
   };
 
-  void *alloc_from_buffer(std::size_t bytes, std::size_t alignment);
+  static constexpr std::size_t header_size =
+      (sizeof(block_header) + alignof(std::max_align_t) - 1) /
+      alignof(std::max_align_t) * alignof(std::max_align_t);
+
+  // Makes room for bytes with the given alignment, reusing a spare block or
+  // requesting one from upstream, and allocates from it.
+  GPCL_DECL void *allocate_slow(std::size_t bytes, std::size_t alignment);
 
-  void request_from_upstream();
+  // Bump pointer of the current buffer.
+  char *cur_{};
+  char *end_{};
 
-  void *do_allocate(std::size_t bytes, std::size_t alignment) override;
+  // Blocks in use, the most recent first.
+  block_header *used_{};
 
-  void do_deallocate(void *p, std::size_t bytes,
-                     std::size_t alignment) override;
+private:
+  GPCL_DECL void *alloc_from_buffer(std::size_t bytes, std::size_t alignment);
 
-  bool do_is_equal(const memory_resource &other) const noexcept override;
+  GPCL_DECL void use_block(block_header *block) noexcept;
+
+  GPCL_DECL void deallocate_block(block_header *block) noexcept;
+
+  GPCL_DECL void rewind_to_initial_buffer() noexcept;
+
+  GPCL_DECL void *do_allocate(std::size_t bytes,
+                              std::size_t alignment) override;
+
+  GPCL_DECL void do_deallocate(void *p, std::size_t bytes,
+                               std::size_t alignment) override;
+
+  GPCL_DECL bool do_is_equal(const memory_resource &other) const
+      noexcept override;
 
-  mutable_buffer buffer_;
   memory_resource *upstream_;
-  std::size_t next_buffer_bytes_ = 32;
-  block_info block_list_{};
+  monotonic_buffer_options opts_;
+
+  // The caller's buffer, if any.
+  char *initial_buffer_{};
+  std::size_t initial_size_{};
+
+  std::size_t next_buffer_bytes_;
+  std::size_t upstream_bytes_{};
+
+  // Blocks kept by reset(), in the order they were first used.
+  block_header *spare_{};
+
+  pool_statistics *stats_{};
+};
+
+/// Rewinds a monotonic_buffer_resource to the position it had at
+/// construction.
+class scoped_checkpoint : noncopyable
+{
+public:
+  explicit scoped_checkpoint(monotonic_buffer_resource &resource) noexcept
+      : resource_(resource),
+        checkpoint_(resource.mark())
+  {
+  }
+
+  ~scoped_checkpoint() { resource_.rewind(checkpoint_); }
+
+private:
+  monotonic_buffer_resource &resource_;
+  monotonic_buffer_resource::checkpoint checkpoint_;
 };
 
 } // namespace pmr
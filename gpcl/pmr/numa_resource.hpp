@@ -0,0 +1,97 @@
+//
+// numa_resource.hpp
+// ~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2020 Zhengyi Fu (tsingyat at outlook dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef GPCL_PMR_NUMA_RESOURCE_HPP
+#define GPCL_PMR_NUMA_RESOURCE_HPP
+
+#include <gpcl/detail/config.hpp>
+#include <gpcl/detail/posix_numa.hpp>
+#include <gpcl/pmr/mmap_resource.hpp>
+#include <atomic>
+
+#ifdef GPCL_POSIX
+
+namespace gpcl {
+namespace pmr {
+
+/// How numa_resource places memory on its node.
+enum class numa_policy
+{
+  /// Use other nodes when the node is out of memory.
+  prefer,
+
+  /// Fail, or invoke the OOM killer, when the node is out of memory.
+  bind
+};
+
+/// An mmap_resource that places the memory it maps on one NUMA node.
+///
+/// The policy is set with mbind(2) before the memory is first touched, so
+/// the placement does not depend on which thread touches it first. The node
+/// is either fixed or, with local_node, that of the CPU the allocating
+/// thread runs on.
+///
+/// On machines with a single node, or where the kernel refuses the NUMA
+/// system calls, the resource behaves as a plain mmap_resource; binding()
+/// tells which is the case.
+class numa_resource : public mmap_resource
+{
+public:
+  /// Selects the node of the allocating thread.
+  static constexpr int local_node = -1;
+
+  /// \requires node is local_node or less than node_count().
+  GPCL_DECL explicit numa_resource(
+      int node = local_node, numa_policy policy = numa_policy::prefer,
+      const mmap_resource_options &opts = mmap_resource_options());
+
+  int node() const noexcept { return node_; }
+
+  numa_policy policy() const noexcept { return policy_; }
+
+  /// \returns Whether allocations are bound to a node.
+  bool binding() const noexcept
+  {
+    return binding_.load(std::memory_order_relaxed);
+  }
+
+  /// \returns The number of nodes the process may allocate memory from.
+  static int node_count() noexcept { return detail::numa_node_count(); }
+
+  /// \returns The node of the CPU the calling thread runs on.
+  static int current_node() noexcept { return detail::numa_current_node(); }
+
+  /// \returns The node holding the page at p, or -1 if it is unknown.
+  static int node_of(const void *p) noexcept
+  {
+    return detail::numa_node_of(p);
+  }
+
+protected:
+  GPCL_DECL void *do_allocate(std::size_t bytes,
+                              std::size_t alignment) override;
+
+private:
+  int node_;
+  numa_policy policy_;
+  bool populate_;
+  std::atomic<bool> binding_;
+};
+
+} // namespace pmr
+} // namespace gpcl
+
+#endif // GPCL_POSIX
+
+#ifdef GPCL_HEADER_ONLY
+#  include <gpcl/pmr/impl/numa_resource.ipp>
+#endif
+
+#endif // GPCL_PMR_NUMA_RESOURCE_HPP
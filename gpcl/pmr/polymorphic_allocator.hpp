@@ -13,8 +13,11 @@
 
 #include <gpcl/detail/config.hpp>
 #include <gpcl/pmr/default_resource.hpp>
+#include <gpcl/detail/error.hpp>
+#include <gpcl/detail/uses_allocator.hpp>
 #include <gpcl/pmr/memory_resource.hpp>
 #include <limits>
+#include <new>
 
 namespace gpcl {
 namespace pmr {
@@ -113,6 +116,92 @@ public:
     this->resource()->deallocate(p, n * sizeof(T), alignof(T));
   }
 
+  /// Allocates nbytes bytes aligned to alignment from the underlying memory
+  /// resource.
+  ///
+  /// \throws Whatever resource()->allocate throws.
+  [[nodiscard]] void *
+  allocate_bytes(std::size_t nbytes,
+                 std::size_t alignment = alignof(std::max_align_t))
+  {
+    return resource()->allocate(nbytes, alignment);
+  }
+
+  /// Deallocates memory obtained by allocate_bytes(nbytes, alignment).
+  void deallocate_bytes(void *p, std::size_t nbytes,
+                        std::size_t alignment = alignof(std::max_align_t))
+  {
+    resource()->deallocate(p, nbytes, alignment);
+  }
+
+  /// Allocates storage for n objects of type U.
+  ///
+  /// \throws std::bad_array_new_length if n * sizeof(U) overflows; may also
+  /// throw whatever resource()->allocate throws.
+  template <typename U>
+  [[nodiscard]] U *allocate_object(std::size_t n = 1)
+  {
+    if (n > std::numeric_limits<std::size_t>::max() / sizeof(U))
+      GPCL_THROW(std::bad_array_new_length());
+    return static_cast<U *>(allocate_bytes(n * sizeof(U), alignof(U)));
+  }
+
+  /// Deallocates memory obtained by allocate_object<U>(n).
+  template <typename U>
+  void deallocate_object(U *p, std::size_t n = 1)
+  {
+    deallocate_bytes(p, n * sizeof(U), alignof(U));
+  }
+
+  /// Allocates and constructs an object of type U from args by
+  /// uses-allocator construction.
+  ///
+  /// \throws Whatever the allocation or the constructor throws; the memory
+  /// is deallocated if the constructor throws.
+  template <typename U, typename... Args>
+  [[nodiscard]] U *new_object(Args &&... args)
+  {
+    U *p = allocate_object<U>();
+    GPCL_TRY
+    {
+      construct(p, std::forward<Args>(args)...);
+    }
+    GPCL_CATCH (...)
+    {
+      deallocate_object(p);
+      GPCL_RETHROW
+    }
+    GPCL_CATCH_END
+    return p;
+  }
+
+  /// Destroys and deallocates an object created by new_object<U>().
+  template <typename U>
+  void delete_object(U *p)
+  {
+    destroy(p);
+    deallocate_object(p);
+  }
+
+  /// Constructs a U at p from args by uses-allocator construction: if U
+  /// uses an allocator convertible from this one, the allocator is passed
+  /// to its constructor, either after std::allocator_arg or as the last
+  /// argument. The members of a std::pair are constructed the same way,
+  /// so containers of pairs of pmr containers share one resource.
+  template <typename U, typename... Args>
+  void construct(U *p, Args &&... args)
+  {
+    detail::uninitialized_construct_using_allocator(
+        p, *this, std::forward<Args>(args)...);
+  }
+
+  /// Destroys the object at p.
+  template <typename U>
+  void destroy(U *p)
+  {
+    p->~U();
+  }
+
   /// \returns a default-constructed polymorphic_allocator object.
   /// \remarks polymorphic_allocator do not propagate on container copy
   /// construction.
@@ -125,8 +214,6 @@ public:
   /// \throws nothing.
   memory_resource *resource() const { return res_; }
 
-  // todo: construct() and destroy()
-
 private:
   memory_resource *res_;
 };
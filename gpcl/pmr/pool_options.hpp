@@ -0,0 +1,38 @@
+//
+// pool_options.hpp
+// ~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2020 Zhengyi Fu (tsingyat at outlook dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef GPCL_PMR_POOL_OPTIONS_HPP
+#define GPCL_PMR_POOL_OPTIONS_HPP
+
+#include <gpcl/detail/config.hpp>
+#include <cstddef>
+
+namespace gpcl {
+namespace pmr {
+
+/// Options of unsynchronized_pool_resource and synchronized_pool_resource.
+struct pool_options
+{
+  /// The maximum number of blocks that will be allocated at once from the
+  /// upstream memory resource to replenish a pool. Zero selects the default
+  /// (1024); larger values are clamped to the implementation limit (65536).
+  std::size_t max_blocks_per_chunk = 0;
+
+  /// The largest allocation size that is served by a pool. Larger requests
+  /// go to the upstream memory resource directly. Zero selects the default
+  /// (4096); the value is rounded up to a power of two and clamped to the
+  /// implementation limit (1 MiB).
+  std::size_t largest_required_pool_block = 0;
+};
+
+} // namespace pmr
+} // namespace gpcl
+
+#endif // GPCL_PMR_POOL_OPTIONS_HPP
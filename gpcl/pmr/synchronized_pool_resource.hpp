@@ -0,0 +1,110 @@
+//
+// synchronized_pool_resource.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2020 Zhengyi Fu (tsingyat at outlook dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef GPCL_PMR_SYNCHRONIZED_POOL_RESOURCE_HPP
+#define GPCL_PMR_SYNCHRONIZED_POOL_RESOURCE_HPP
+
+#include <gpcl/detail/config.hpp>
+#include <gpcl/detail/pool_resource.hpp>
+#include <gpcl/detail/thread_cache.hpp>
+#include <gpcl/mutex.hpp>
+#include <gpcl/pmr/default_resource.hpp>
+#include <gpcl/pmr/memory_resource.hpp>
+#include <gpcl/pmr/pool_options.hpp>
+#include <memory>
+
+namespace gpcl {
+namespace pmr {
+
+/// A thread-safe memory resource that pools blocks of power-of-two sizes.
+///
+/// The pools are those of unsynchronized_pool_resource, one mutex per size
+/// class. In front of them each thread caches freed blocks per size class,
+/// so allocate() and deallocate() usually take no lock; the cache is
+/// refilled from and drained to the pool a batch at a time. A thread's
+/// cached blocks return to the pool when the thread exits.
+///
+/// \notes release() and the destructor must not run concurrently with
+/// other calls.
+class synchronized_pool_resource : public memory_resource
+{
+public:
+  GPCL_DECL synchronized_pool_resource(const pool_options &opts,
+                                       memory_resource *upstream);
+
+  synchronized_pool_resource()
+      : synchronized_pool_resource(pool_options(), get_default_resource())
+  {
+  }
+
+  explicit synchronized_pool_resource(memory_resource *upstream)
+      : synchronized_pool_resource(pool_options(), upstream)
+  {
+  }
+
+  explicit synchronized_pool_resource(const pool_options &opts)
+      : synchronized_pool_resource(opts, get_default_resource())
+  {
+  }
+
+  synchronized_pool_resource(const synchronized_pool_resource &) = delete;
+  synchronized_pool_resource &
+  operator=(const synchronized_pool_resource &) = delete;
+
+  GPCL_DECL ~synchronized_pool_resource() override;
+
+  /// \effects Returns all memory to the upstream resource, even if some
+  /// blocks have not been deallocated, and drops the blocks cached by all
+  /// threads.
+  GPCL_DECL void release();
+
+  memory_resource *upstream_resource() const { return upstream_; }
+
+  /// \returns The options in effect, after defaults and limits are applied.
+  pool_options options() const { return opts_; }
+
+protected:
+  GPCL_DECL void *do_allocate(std::size_t bytes,
+                              std::size_t alignment) override;
+
+  GPCL_DECL void do_deallocate(void *p, std::size_t bytes,
+                               std::size_t alignment) override;
+
+  GPCL_DECL bool do_is_equal(const memory_resource &other) const
+      noexcept override;
+
+private:
+  struct size_class
+  {
+    mutex mtx;
+    detail::pool_size_class pool;
+    std::unique_ptr<detail::thread_cache_owner> cache;
+  };
+
+  GPCL_DECL static void drain(void *context, void *first, void *last);
+
+  GPCL_DECL void reset_cache(size_class &c);
+
+  memory_resource *upstream_;
+  pool_options opts_;
+  std::size_t class_count_;
+  std::unique_ptr<size_class[]> classes_;
+  mutex oversized_mtx_;
+  detail::oversized_list oversized_;
+};
+
+} // namespace pmr
+} // namespace gpcl
+
+#ifdef GPCL_HEADER_ONLY
+#  include <gpcl/pmr/impl/synchronized_pool_resource.ipp>
+#endif
+
+#endif // GPCL_PMR_SYNCHRONIZED_POOL_RESOURCE_HPP
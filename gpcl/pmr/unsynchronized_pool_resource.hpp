@@ -0,0 +1,93 @@
+//
+// unsynchronized_pool_resource.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2020 Zhengyi Fu (tsingyat at outlook dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef GPCL_PMR_UNSYNCHRONIZED_POOL_RESOURCE_HPP
+#define GPCL_PMR_UNSYNCHRONIZED_POOL_RESOURCE_HPP
+
+#include <gpcl/detail/config.hpp>
+#include <gpcl/detail/pool_resource.hpp>
+#include <gpcl/pmr/default_resource.hpp>
+#include <gpcl/pmr/memory_resource.hpp>
+#include <gpcl/pmr/pool_options.hpp>
+#include <memory>
+
+namespace gpcl {
+namespace pmr {
+
+/// A memory resource that pools blocks of power-of-two sizes, for use from
+/// a single thread.
+///
+/// Each size class is a simple segregated storage replenished with chunks
+/// from the upstream resource; the chunks grow geometrically up to
+/// pool_options::max_blocks_per_chunk blocks. Requests larger than
+/// pool_options::largest_required_pool_block go to upstream directly.
+/// Memory is returned to upstream by release() and the destructor.
+class unsynchronized_pool_resource : public memory_resource
+{
+public:
+  GPCL_DECL unsynchronized_pool_resource(const pool_options &opts,
+                                         memory_resource *upstream);
+
+  unsynchronized_pool_resource()
+      : unsynchronized_pool_resource(pool_options(), get_default_resource())
+  {
+  }
+
+  explicit unsynchronized_pool_resource(memory_resource *upstream)
+      : unsynchronized_pool_resource(pool_options(), upstream)
+  {
+  }
+
+  explicit unsynchronized_pool_resource(const pool_options &opts)
+      : unsynchronized_pool_resource(opts, get_default_resource())
+  {
+  }
+
+  unsynchronized_pool_resource(const unsynchronized_pool_resource &) = delete;
+  unsynchronized_pool_resource &
+  operator=(const unsynchronized_pool_resource &) = delete;
+
+  ~unsynchronized_pool_resource() override { release(); }
+
+  /// \effects Returns all memory to the upstream resource, even if some
+  /// blocks have not been deallocated.
+  GPCL_DECL void release();
+
+  memory_resource *upstream_resource() const { return upstream_; }
+
+  /// \returns The options in effect, after defaults and limits are applied.
+  pool_options options() const { return opts_; }
+
+protected:
+  GPCL_DECL void *do_allocate(std::size_t bytes,
+                              std::size_t alignment) override;
+
+  GPCL_DECL void do_deallocate(void *p, std::size_t bytes,
+                               std::size_t alignment) override;
+
+  GPCL_DECL bool do_is_equal(const memory_resource &other) const
+      noexcept override;
+
+private:
+  memory_resource *upstream_;
+  pool_options opts_;
+  std::size_t class_count_;
+  std::unique_ptr<detail::pool_size_class[]> pools_;
+  detail::oversized_list oversized_;
+};
+
+} // namespace pmr
+} // namespace gpcl
+
+#ifdef GPCL_HEADER_ONLY
+#  include <gpcl/pmr/impl/unsynchronized_pool_resource.ipp>
+#endif
+
+#endif // GPCL_PMR_UNSYNCHRONIZED_POOL_RESOURCE_HPP
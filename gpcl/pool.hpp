@@ -11,8 +11,11 @@
 #ifndef GPCL_POOL_HPP
 #define GPCL_POOL_HPP
 
+#include <gpcl/bitmap_segregated_storage.hpp>
 #include <gpcl/detail/config.hpp>
+#include <gpcl/detail/type_traits.hpp>
 #include <gpcl/mutex.hpp>
+#include <gpcl/pool_statistics.hpp>
 #include <gpcl/simple_segregated_storage.hpp>
 #include <gpcl/unique_lock.hpp>
 
@@ -57,8 +60,19 @@ struct default_new_delete_user_allocator
   static void free(char *p) noexcept { ::operator delete[](p, std::nothrow); }
 };
 
+/// A memory pool of fixed-size chunks.
+///
+/// \tparam UA user allocator used to obtain blocks.
+/// \tparam MutexType mutex protecting the pool.
+/// \tparam Storage storage of the free chunks, simple_segregated_storage or
+/// bitmap_segregated_storage. The latter makes ordered_free() O(log B) and
+/// ordered_malloc(n) O(C / 64) instead of linear in the number of free chunks.
+/// \tparam Statistics null_pool_statistics or pool_statistics.
 template <typename UA = default_new_delete_user_allocator,
-          typename MutexType = gpcl::mutex>
+          typename MutexType = gpcl::mutex,
+          typename Storage =
+              simple_segregated_storage<typename UA::size_type>,
+          typename Statistics = null_pool_statistics>
 class pool
 {
   static_assert(is_user_allocator<UA>::value, "user allocator");
@@ -66,34 +80,34 @@ class pool
 public:
   using user_allocator_type = UA;
   using mutex_type = MutexType;
+  using storage_type = Storage;
+  using statistics_type = Statistics;
   using size_type = typename user_allocator_type::size_type;
   using difference_type = typename user_allocator_type::difference_type;
 
   /// Constructor.
-  explicit pool(size_type requested_size)
+  ///
+  /// \param requested_size size of the chunks.
+  /// \param next_size number of chunks in the first block.
+  /// \param max_size maximum number of chunks in a block, 0 for no limit.
+  explicit pool(size_type requested_size, size_type next_size = 32,
+                size_type max_size = 0)
       : requested_size_(requested_size),
         chunk_size_(std::lcm(requested_size_,
                              std::lcm(sizeof(void *), sizeof(size_type)))),
         block_list_(),
-        next_size_(32)
+        start_size_(capped(next_size, max_size)),
+        next_size_(start_size_),
+        max_size_(max_size)
   {
     GPCL_ASSERT(requested_size != 0);
+    GPCL_ASSERT(next_size != 0);
   }
 
   /// Destructor.
   ///
   /// During destruction, any malloc'd but not free'd memory will be recycled.
-  ~pool() noexcept
-  {
-    block_info block = block_list_;
-    while (block.ptr)
-    {
-      auto next = *reinterpret_cast<block_info *>(
-          block.ptr + block_info_offset(block.size));
-      user_allocator_type::free(block.ptr);
-      block = next;
-    }
-  }
+  ~pool() noexcept { free_all_blocks(); }
 
   /// Determines the requested size.
   size_type requested_size() const noexcept { return requested_size_; }
@@ -101,33 +115,27 @@ public:
   /// Allocates memory for an object of size requested_size.
   [[nodiscard]] void *malloc()
   {
-    gpcl::unique_lock<mutex_type> lock(mutex_);
+    auto lock = lock_pool();
 
-    if (storage_.empty())
-    {
-      if (request_new_block(chunk_size_))
-        return storage_.malloc(chunk_size_);
-      else
-        return nullptr;
-    }
+    if (storage_.empty() && !request_new_block(chunk_size_))
+      return nullptr;
 
-    return storage_.malloc(chunk_size_);
+    void *ret = storage_.malloc(chunk_size_);
+    stats_.on_allocate(ret, 1, requested_size_);
+    return ret;
   }
 
   /// Allocates memory for an object of size requested_size.
   [[nodiscard]] void *ordered_malloc()
   {
-    gpcl::unique_lock<mutex_type> lock(mutex_);
+    auto lock = lock_pool();
 
-    if (storage_.empty())
-    {
-      if (request_new_block(chunk_size_, true))
-        return storage_.malloc(chunk_size_);
-      else
-        return nullptr;
-    }
+    if (storage_.empty() && !request_new_block(chunk_size_, true))
+      return nullptr;
 
-    return storage_.malloc(chunk_size_);
+    void *ret = storage_.malloc(chunk_size_);
+    stats_.on_allocate(ret, 1, requested_size_);
+    return ret;
   }
 
   /// Allocates memory for an array of n objects of size requested_size.
@@ -135,35 +143,147 @@ public:
   {
     GPCL_ASSERT(n != 0);
     auto count = chunk_count(n);
-    gpcl::unique_lock<mutex_type> lock(mutex_);
-    if (auto ret = storage_.malloc_n(count, chunk_size_))
-      return ret;
-    request_new_block(count * chunk_size_, true);
+    auto lock = lock_pool();
+    void *ret = storage_.malloc_n(count, chunk_size_);
+    if (!ret && request_new_block(count * chunk_size_, true))
+      ret = storage_.malloc_n(count, chunk_size_);
 
-    return storage_.malloc_n(count, chunk_size_);
+    if (ret)
+      stats_.on_allocate(ret, count, n * requested_size_);
+    return ret;
+  }
+
+  /// Allocates up to n chunks of size requested_size under a single lock.
+  ///
+  /// The chunks are linked through their first word and the last one points
+  /// to null.
+  ///
+  /// \param n maximum number of chunks to allocate.
+  /// \param first receives the first chunk.
+  /// \returns The number of allocated chunks, 0 if out of memory.
+  [[nodiscard]] size_type malloc_batch(size_type n, void *&first)
+  {
+    GPCL_ASSERT(n != 0);
+    auto lock = lock_pool();
+
+    if (storage_.empty() && !request_new_block(chunk_size_))
+    {
+      first = nullptr;
+      return 0;
+    }
+
+    auto m = storage_.malloc_batch(n, first);
+    stats_.on_allocate(first, m, m * requested_size_);
+    return m;
   }
 
   /// Frees memory for an object.
   void free(void *ptr)
   {
-    gpcl::unique_lock<mutex_type> lock(mutex_);
+    auto lock = lock_pool();
     storage_.free(ptr);
+    stats_.on_deallocate(ptr, 1, requested_size_);
+  }
+
+  /// Frees a list of chunks returned by malloc() or malloc_batch() under a
+  /// single lock.
+  ///
+  /// \param first first chunk of the list.
+  /// \param last last chunk of the list.
+  void free_batch(void *first, void *last)
+  {
+    size_type m = 0;
+    if constexpr (statistics_type::enabled)
+    {
+      for (void *c = first;; c = *static_cast<void **>(c))
+      {
+        ++m;
+        if (c == last)
+          break;
+      }
+    }
+
+    auto lock = lock_pool();
+    storage_.free_batch(first, last);
+    stats_.on_deallocate(first, m, m * requested_size_);
   }
 
   /// Frees memory for an object.
   void ordered_free(void *ptr)
   {
-    gpcl::unique_lock<mutex_type> lock(mutex_);
+    auto lock = lock_pool();
     storage_.ordered_free(ptr);
+    stats_.on_deallocate(ptr, 1, requested_size_);
   }
 
   /// Frees memory for an array of objects.
   void ordered_free(void *ptr, size_type n)
   {
-    gpcl::unique_lock<mutex_type> lock(mutex_);
-    storage_.ordered_free_n(ptr, chunk_count(n), chunk_size_);
+    auto count = chunk_count(n);
+    auto lock = lock_pool();
+    storage_.ordered_free_n(ptr, count, chunk_size_);
+    stats_.on_deallocate(ptr, count, n * requested_size_);
+  }
+
+  /// Frees every block whose chunks are all free.
+  ///
+  /// \returns true if at least one block was freed.
+  ///
+  /// \complexity O(B * N) with simple_segregated_storage, where N is the size
+  /// of the free list, and O(B^2) with bitmap_segregated_storage.
+  bool release_memory()
+  {
+    auto lock = lock_pool();
+
+    bool released = false;
+    block_info *link = &block_list_;
+    while (link->ptr)
+    {
+      block_info block = *link;
+      block_info &next = next_block(block);
+      if (storage_.release_block(block.ptr, block_info_offset(block.size),
+                                 chunk_size_))
+      {
+        *link = next;
+        user_allocator_type::free(block.ptr);
+        stats_.on_block_released(block.size);
+        released = true;
+      }
+      else
+      {
+        link = &next;
+      }
+    }
+    return released;
+  }
+
+  /// Frees every block, whether or not its chunks are in use, and resets the
+  /// next block size to the one given at construction.
+  ///
+  /// \returns true if at least one block was freed.
+  ///
+  /// \notes Every pointer returned by this pool becomes invalid.
+  bool purge_memory()
+  {
+    auto lock = lock_pool();
+
+    if (!block_list_.ptr)
+      return false;
+
+    free_all_blocks();
+    block_list_ = block_info{};
+    storage_.clear();
+    stats_.on_purge();
+    next_size_ = start_size_;
+    return true;
   }
 
+  /// \returns The statistics policy object.
+  statistics_type &statistics() noexcept { return stats_; }
+
+  /// \returns The statistics policy object.
+  const statistics_type &statistics() const noexcept { return stats_; }
+
   // not thread-safe
   size_type get_next_size() const { return next_size_; }
 
@@ -171,7 +291,21 @@ public:
   void set_next_size(size_type next_size)
   {
     GPCL_ASSERT(next_size != 0);
-    next_size_ = next_size;
+    start_size_ = next_size_ = capped(next_size, max_size_);
+  }
+
+  // not thread-safe
+  size_type get_max_size() const { return max_size_; }
+
+  /// Limits the number of chunks in the blocks requested later, 0 for no
+  /// limit. Requests for larger arrays still get a large enough block.
+  ///
+  /// \notes not thread-safe
+  void set_max_size(size_type max_size)
+  {
+    max_size_ = max_size;
+    start_size_ = capped(start_size_, max_size_);
+    next_size_ = capped(next_size_, max_size_);
   }
 
 private:
@@ -188,20 +322,29 @@ private:
 #endif
   ;
 
+  static size_type capped(size_type n, size_type max_size) noexcept
+  {
+    return max_size != 0 && n > max_size ? max_size : n;
+  }
+
   // Requests a block with at least min_size bytes for chunks.
   bool request_new_block(size_type min_size, bool ordered = false)
   {
-    auto sz = next_size_ * chunk_size_;
-    while (sz < min_size + sizeof(block_info) * 2)
+    // Only a block too small for the request and the bookkeeping grows
+    // past max_size_.
+    auto sz = capped(next_size_, max_size_) * chunk_size_;
+    while (sz < min_size + storage_type::block_overhead(sz, chunk_size_) +
+                     sizeof(block_info) * 2)
       sz *= 2;
 
-    next_size_ *= 2;
+    next_size_ = capped(next_size_ * 2, max_size_);
 
     char *block = user_allocator_type::malloc(sz);
     if (block == nullptr)
       return false;
 
     block_list_ = add_block(block, sz, block_list_, ordered);
+    stats_.on_block_acquired(sz);
     GPCL_VERIFY_FALSE(storage_.empty());
     return true;
   }
@@ -217,6 +360,30 @@ private:
     return {ptr, sz};
   }
 
+  gpcl::unique_lock<mutex_type> lock_pool()
+  {
+    stats_.lock(mutex_);
+    return gpcl::unique_lock<mutex_type>(mutex_, adopt_lock);
+  }
+
+  block_info &next_block(const block_info &block)
+  {
+    return *reinterpret_cast<block_info *>(block.ptr +
+                                           block_info_offset(block.size));
+  }
+
+  void free_all_blocks() noexcept
+  {
+    block_info block = block_list_;
+    while (block.ptr)
+    {
+      auto next = next_block(block);
+      user_allocator_type::free(block.ptr);
+      stats_.on_block_released(block.size);
+      block = next;
+    }
+  }
+
   difference_type block_info_offset(size_type block_size)
   {
     return (block_size - sizeof(block_info)) / alignof(block_info) *
@@ -234,22 +401,30 @@ private:
   mutable mutex_type mutex_;
   const size_type requested_size_;
   const size_type chunk_size_;
-  size_type next_size_;
   block_info block_list_;
-  simple_segregated_storage<size_type> storage_;
+  size_type start_size_;
+  size_type next_size_;
+  size_type max_size_;
+  storage_type storage_;
+  statistics_type stats_;
 };
 
 template <typename Tag, unsigned RequestedSize,
-          typename UserAllocator = default_malloc_free_user_allocator>
+          typename UserAllocator = default_malloc_free_user_allocator,
+          typename Statistics = null_pool_statistics>
 class singleton_pool
 {
-  using pool_type = pool<UserAllocator>;
+  using pool_type =
+      pool<UserAllocator, gpcl::mutex,
+           simple_segregated_storage<typename UserAllocator::size_type>,
+           Statistics>;
 
 public:
   using tag = Tag;
   using user_allocator = UserAllocator;
-  using size_type = typename pool<UserAllocator>::size_type;
-  using difference_type = typename pool<UserAllocator>::difference_type;
+  using statistics_type = Statistics;
+  using size_type = typename pool_type::size_type;
+  using difference_type = typename pool_type::difference_type;
 
   const static unsigned requested_size = RequestedSize;
 
@@ -271,6 +446,12 @@ public:
     get_pool().ordered_free(ptr, n);
   }
 
+  static bool release_memory() { return get_pool().release_memory(); }
+
+  static bool purge_memory() { return get_pool().purge_memory(); }
+
+  static statistics_type &statistics() { return get_pool().statistics(); }
+
 private:
   static pool_type &get_pool()
   {
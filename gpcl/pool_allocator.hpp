@@ -17,21 +17,32 @@
 namespace gpcl {
 
 /// Allocator that allocates from a global pool.
-template <typename T>
+///
+/// \tparam SingletonPool the singleton pool template used for allocation,
+/// e.g. singleton_pool or lockfree_singleton_pool.
+template <typename T,
+          template <typename, unsigned, typename...> class SingletonPool =
+              singleton_pool>
 class pool_allocator
 {
-  using pool_type = singleton_pool<class unordered_tag, sizeof(T)>;
-  using ordered_pool_type = singleton_pool<class ordered_tag, sizeof(T)>;
+  using pool_type = SingletonPool<class unordered_tag, sizeof(T)>;
+  using ordered_pool_type = SingletonPool<class ordered_tag, sizeof(T)>;
 
 public:
   using value_type = T;
   using size_type = typename pool_type::size_type;
   using difference_type = typename pool_type::size_type;
 
+  template <typename U>
+  struct rebind
+  {
+    using other = pool_allocator<U, SingletonPool>;
+  };
+
   pool_allocator() = default;
 
   template <typename U>
-  explicit pool_allocator(const pool_allocator<U> &) noexcept
+  explicit pool_allocator(const pool_allocator<U, SingletonPool> &) noexcept
   {
   }
 
@@ -50,6 +61,18 @@ public:
     else
       pool_type::free(ptr);
   }
+
+  friend bool operator==(const pool_allocator &,
+                         const pool_allocator &) noexcept
+  {
+    return true;
+  }
+
+  friend bool operator!=(const pool_allocator &,
+                         const pool_allocator &) noexcept
+  {
+    return false;
+  }
 };
 
 } // namespace gpcl
@@ -0,0 +1,225 @@
+//
+// pool_statistics.hpp
+// ~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2020 Zhengyi Fu (tsingyat at outlook dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef GPCL_POOL_STATISTICS_HPP
+#define GPCL_POOL_STATISTICS_HPP
+
+#include <gpcl/detail/config.hpp>
+#include <gpcl/is_lockable.hpp>
+#include <gpcl/noncopyable.hpp>
+#include <gpcl/time.hpp>
+#include <atomic>
+#include <cstddef>
+
+namespace gpcl {
+
+/// An allocation or deallocation reported to a trace hook.
+struct allocation_event
+{
+  enum kind_type
+  {
+    allocate,
+    deallocate
+  };
+
+  kind_type kind;
+
+  /// The allocated or deallocated memory.
+  void *ptr;
+
+  /// Size of the memory in bytes.
+  std::size_t bytes;
+};
+
+/// Callback for sampled allocation tracing.
+using allocation_trace_hook = void (*)(void *context,
+                                       const allocation_event &event);
+
+/// Statistics policy that records nothing.
+///
+/// Every hook is an empty inline function, so a pool instantiated with this
+/// policy compiles to the same code as one without statistics.
+class null_pool_statistics
+{
+public:
+  static constexpr bool enabled = false;
+
+  GPCL_DECL_INLINE void on_block_acquired(std::size_t) noexcept {}
+
+  GPCL_DECL_INLINE void on_block_released(std::size_t) noexcept {}
+
+  GPCL_DECL_INLINE void on_allocate(void *, std::size_t, std::size_t) noexcept
+  {
+  }
+
+  GPCL_DECL_INLINE void on_deallocate(void *, std::size_t,
+                                      std::size_t) noexcept
+  {
+  }
+
+  GPCL_DECL_INLINE void on_purge() noexcept {}
+
+  template <typename Mutex>
+  GPCL_DECL_INLINE void lock(Mutex &mtx)
+  {
+    mtx.lock();
+  }
+};
+
+/// Statistics policy that records the usage of a pool.
+///
+/// The counters are updated with relaxed atomic operations and can be read
+/// from any thread while the pool is in use.
+class pool_statistics : noncopyable
+{
+public:
+  static constexpr bool enabled = true;
+
+  pool_statistics() = default;
+
+  /// \returns Bytes currently obtained from the upstream allocator.
+  std::size_t bytes_reserved() const noexcept
+  {
+    return bytes_reserved_.load(std::memory_order_relaxed);
+  }
+
+  /// \returns Number of blocks currently obtained from the upstream allocator.
+  std::size_t blocks() const noexcept
+  {
+    return blocks_.load(std::memory_order_relaxed);
+  }
+
+  /// \returns Number of chunks allocated and not yet deallocated.
+  std::size_t live_chunks() const noexcept
+  {
+    return live_chunks_.load(std::memory_order_relaxed);
+  }
+
+  /// \returns The maximum of live_chunks() since construction or the last
+  /// call to reset_peak().
+  std::size_t peak_live_chunks() const noexcept
+  {
+    return peak_live_chunks_.load(std::memory_order_relaxed);
+  }
+
+  /// \returns Number of times a thread found the pool mutex locked.
+  std::size_t contentions() const noexcept
+  {
+    return contentions_.load(std::memory_order_relaxed);
+  }
+
+  /// \returns Total time threads waited for the pool mutex.
+  duration contention_wait() const noexcept
+  {
+    return duration::from_nanos(
+        contention_wait_nanos_.load(std::memory_order_relaxed));
+  }
+
+  /// \effects Sets peak_live_chunks() to live_chunks().
+  void reset_peak() noexcept
+  {
+    peak_live_chunks_.store(live_chunks(), std::memory_order_relaxed);
+  }
+
+  /// \effects Calls hook(context, event) for every sample_period-th
+  /// allocation or deallocation. A null hook disables tracing.
+  ///
+  /// \notes Not thread-safe with respect to concurrent allocations.
+  void set_trace_hook(allocation_trace_hook hook, void *context,
+                      std::size_t sample_period = 1) noexcept
+  {
+    GPCL_ASSERT(sample_period != 0);
+    trace_hook_ = hook;
+    trace_context_ = context;
+    sample_period_ = sample_period;
+  }
+
+  void on_block_acquired(std::size_t bytes) noexcept
+  {
+    bytes_reserved_.fetch_add(bytes, std::memory_order_relaxed);
+    blocks_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void on_block_released(std::size_t bytes) noexcept
+  {
+    bytes_reserved_.fetch_sub(bytes, std::memory_order_relaxed);
+    blocks_.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  void on_allocate(void *ptr, std::size_t chunks, std::size_t bytes) noexcept
+  {
+    auto live =
+        live_chunks_.fetch_add(chunks, std::memory_order_relaxed) + chunks;
+    auto peak = peak_live_chunks_.load(std::memory_order_relaxed);
+    while (peak < live && !peak_live_chunks_.compare_exchange_weak(
+                              peak, live, std::memory_order_relaxed))
+    {
+    }
+    trace(allocation_event::allocate, ptr, bytes);
+  }
+
+  void on_deallocate(void *ptr, std::size_t chunks, std::size_t bytes) noexcept
+  {
+    live_chunks_.fetch_sub(chunks, std::memory_order_relaxed);
+    trace(allocation_event::deallocate, ptr, bytes);
+  }
+
+  void on_purge() noexcept { live_chunks_.store(0, std::memory_order_relaxed); }
+
+  /// \effects Locks mtx, counting and timing the wait if it is already
+  /// locked.
+  template <typename Mutex>
+  void lock(Mutex &mtx)
+  {
+    if constexpr (is_lockable<Mutex>::value)
+    {
+      if (mtx.try_lock())
+        return;
+
+      auto start = instant::now();
+      mtx.lock();
+      contentions_.fetch_add(1, std::memory_order_relaxed);
+      contention_wait_nanos_.fetch_add(
+          static_cast<std::size_t>(start.elapsed().as_nanos()),
+          std::memory_order_relaxed);
+    }
+    else
+    {
+      mtx.lock();
+    }
+  }
+
+private:
+  void trace(allocation_event::kind_type kind, void *ptr,
+             std::size_t bytes) noexcept
+  {
+    if (!trace_hook_)
+      return;
+    if (events_.fetch_add(1, std::memory_order_relaxed) % sample_period_ != 0)
+      return;
+    trace_hook_(trace_context_, allocation_event{kind, ptr, bytes});
+  }
+
+  std::atomic<std::size_t> bytes_reserved_{};
+  std::atomic<std::size_t> blocks_{};
+  std::atomic<std::size_t> live_chunks_{};
+  std::atomic<std::size_t> peak_live_chunks_{};
+  std::atomic<std::size_t> contentions_{};
+  std::atomic<std::size_t> contention_wait_nanos_{};
+  std::atomic<std::size_t> events_{};
+
+  allocation_trace_hook trace_hook_{};
+  void *trace_context_{};
+  std::size_t sample_period_ = 1;
+};
+
+} // namespace gpcl
+
+#endif // GPCL_POOL_STATISTICS_HPP
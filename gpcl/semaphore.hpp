@@ -15,6 +15,7 @@
 #include <gpcl/detail/posix_semaphore.hpp>
 #include <gpcl/detail/win_semaphore.hpp>
 #include <gpcl/noncopyable.hpp>
+#include <gpcl/time.hpp>
 
 namespace gpcl {
 
@@ -62,6 +63,24 @@ public:
     return impl_.try_wait();
   }
 
+#if defined(GPCL_POSIX)
+  /// Lock a semaphore, waiting until deadline at the latest.
+  ///
+  /// \returns Whether the semaphore was locked.
+  auto try_wait_until(const instant &deadline) -> bool
+  {
+    return impl_.try_wait_until(deadline);
+  }
+
+  /// Lock a semaphore, waiting for at most rel_time.
+  ///
+  /// \returns Whether the semaphore was locked.
+  auto try_wait_for(const duration &rel_time) -> bool
+  {
+    return impl_.try_wait_until(instant::now().saturating_add(rel_time));
+  }
+#endif
+
   /// Returns a native handle of the semaphore.
   auto native_handle() -> native_handle_type
   {
@@ -0,0 +1,132 @@
+//
+// shared_lock.hpp
+// ~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2020 Zhengyi Fu (tsingyat at outlook dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef GPCL_SHARED_LOCK_HPP
+#define GPCL_SHARED_LOCK_HPP
+
+#include <gpcl/assert.hpp>
+#include <gpcl/detail/config.hpp>
+#include <gpcl/thread_annotations.hpp>
+#include <gpcl/unique_lock.hpp>
+#include <utility>
+
+namespace gpcl {
+
+/// RAII type that automatically unlocks a mutex it shares with other
+/// readers.
+///
+/// \requires MutexType has lock_shared(), unlock_shared() and, to use
+/// try_to_lock or try_lock(), try_lock_shared().
+template <typename MutexType>
+class GPCL_SCOPED_CAPABILITY shared_lock
+{
+public:
+  using mutex_type = MutexType;
+
+  explicit shared_lock(mutex_type &mtx) GPCL_ACQUIRE_SHARED(mtx)
+      : mtx_(&mtx),
+        owns_lock_(false)
+  {
+    lock();
+  }
+
+  shared_lock(mutex_type &mtx, defer_lock_t) noexcept GPCL_EXCLUDES(mtx)
+      : mtx_(&mtx),
+        owns_lock_(false)
+  {
+  }
+
+  shared_lock(mutex_type &mtx, adopt_lock_t) noexcept
+      GPCL_REQUIRES_SHARED(mtx)
+      : mtx_(&mtx),
+        owns_lock_(true)
+  {
+  }
+
+  shared_lock(mutex_type &mtx, try_to_lock_t) : mtx_(&mtx), owns_lock_(false)
+  {
+    try_lock();
+  }
+
+  shared_lock(const shared_lock &) = delete;
+  auto operator=(const shared_lock &) -> shared_lock & = delete;
+
+  shared_lock(shared_lock &&other) noexcept
+      : mtx_(std::exchange(other.mtx_, nullptr)),
+        owns_lock_(std::exchange(other.owns_lock_, false))
+  {
+  }
+
+  ~shared_lock() GPCL_RELEASE()
+  {
+    if (owns_lock_)
+      mtx_->unlock_shared();
+  }
+
+  auto operator=(shared_lock &&other) noexcept -> shared_lock &
+  {
+    shared_lock(std::move(other)).swap(*this);
+    return *this;
+  }
+
+  auto swap(shared_lock &other) noexcept -> void
+  {
+    using std::swap;
+    swap(mtx_, other.mtx_);
+    swap(owns_lock_, other.owns_lock_);
+  }
+
+  friend inline auto swap(shared_lock &x, shared_lock &y) noexcept -> void
+  {
+    x.swap(y);
+  }
+
+  [[nodiscard]] auto owns_lock() const noexcept -> bool { return owns_lock_; }
+
+  [[nodiscard]] mutex_type &mutex() const noexcept { return *mtx_; }
+
+  /// \effects Disassociates the mutex without unlocking it.
+  ///
+  /// \returns The mutex.
+  auto release() noexcept -> mutex_type *
+  {
+    owns_lock_ = false;
+    return std::exchange(mtx_, nullptr);
+  }
+
+  GPCL_ACQUIRE_SHARED() void lock()
+  {
+    GPCL_ASSERT(owns_lock_ == false);
+    mutex().lock_shared();
+    owns_lock_ = true;
+  }
+
+  GPCL_TRY_ACQUIRE_SHARED(true) bool try_lock()
+  {
+    GPCL_ASSERT(owns_lock_ == false);
+    owns_lock_ = mutex().try_lock_shared();
+    return owns_lock_;
+  }
+
+  GPCL_RELEASE_SHARED() void unlock()
+  {
+    GPCL_ASSERT(owns_lock_);
+    mutex().unlock_shared();
+    owns_lock_ = false;
+  }
+
+private:
+  mutex_type *mtx_{};
+  bool owns_lock_{};
+};
+
+} // namespace gpcl
+
+#endif // GPCL_SHARED_LOCK_HPP
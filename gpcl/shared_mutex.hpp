@@ -0,0 +1,215 @@
+//
+// shared_mutex.hpp
+// ~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2020 Zhengyi Fu (tsingyat at outlook dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef GPCL_SHARED_MUTEX_HPP
+#define GPCL_SHARED_MUTEX_HPP
+
+#include <gpcl/clock.hpp>
+#include <gpcl/detail/config.hpp>
+#include <gpcl/detail/posix_shared_mutex.hpp>
+#include <gpcl/noncopyable.hpp>
+#include <gpcl/thread_annotations.hpp>
+#include <gpcl/time.hpp>
+#include <type_traits>
+
+#ifdef GPCL_POSIX
+
+namespace gpcl {
+
+/// Reader-writer mutex: any number of threads may share it, or one thread
+/// may own it exclusively.
+///
+/// Waiting writers are preferred over new readers, so that a steady stream
+/// of readers cannot starve them. Like mutex, it is not recursive in either
+/// mode.
+class GPCL_CAPABILITY("mutex") shared_mutex : noncopyable
+{
+public:
+#if defined(GPCL_DOXYGEN)
+  using impl_type = /*unspecified*/;
+#else
+  using impl_type = detail::posix_shared_mutex;
+#endif
+
+  using native_handle_type = impl_type::native_handle_type;
+
+  shared_mutex() = default;
+
+  shared_mutex(const shared_mutex &) = delete;
+  shared_mutex(shared_mutex &&) = delete;
+
+  auto operator=(const shared_mutex &) -> shared_mutex & = delete;
+  auto operator=(shared_mutex &&) -> shared_mutex & = delete;
+
+  GPCL_ACQUIRE() auto lock() -> void { return impl_.lock(); }
+  GPCL_RELEASE() auto unlock() -> void { return impl_.unlock(); }
+  GPCL_TRY_ACQUIRE(true) auto try_lock() -> bool { return impl_.try_lock(); }
+
+  GPCL_ACQUIRE_SHARED() auto lock_shared() -> void
+  {
+    return impl_.lock_shared();
+  }
+
+  GPCL_RELEASE_SHARED() auto unlock_shared() -> void
+  {
+    return impl_.unlock_shared();
+  }
+
+  GPCL_TRY_ACQUIRE_SHARED(true) auto try_lock_shared() -> bool
+  {
+    return impl_.try_lock_shared();
+  }
+
+  auto native_handle() noexcept -> native_handle_type
+  {
+    return impl_.native_handle();
+  }
+
+private:
+  impl_type impl_;
+};
+
+/// shared_mutex whose locks may also be tried for a limited time.
+class GPCL_CAPABILITY("mutex") shared_timed_mutex : noncopyable
+{
+public:
+#if defined(GPCL_DOXYGEN)
+  using impl_type = /*unspecified*/;
+#else
+  using impl_type = detail::posix_shared_mutex;
+#endif
+
+  using native_handle_type = impl_type::native_handle_type;
+
+  shared_timed_mutex() = default;
+
+  shared_timed_mutex(const shared_timed_mutex &) = delete;
+  shared_timed_mutex(shared_timed_mutex &&) = delete;
+
+  auto operator=(const shared_timed_mutex &) -> shared_timed_mutex & = delete;
+  auto operator=(shared_timed_mutex &&) -> shared_timed_mutex & = delete;
+
+  GPCL_ACQUIRE() auto lock() -> void { return impl_.lock(); }
+  GPCL_RELEASE() auto unlock() -> void { return impl_.unlock(); }
+  GPCL_TRY_ACQUIRE(true) auto try_lock() -> bool { return impl_.try_lock(); }
+
+  template <typename Clock, typename Duration,
+            typename std::enable_if<std::is_same<Clock, system_clock>::value,
+                                    int>::type = 0>
+  GPCL_TRY_ACQUIRE(true)
+  auto try_lock_until(chrono::time_point<Clock, Duration> const &timeout_time)
+      -> bool
+  {
+    return impl_.try_lock_until(
+        chrono::time_point_cast<system_clock::duration>(timeout_time));
+  }
+
+  template <typename Clock, typename Duration,
+            typename std::enable_if<!std::is_same<Clock, system_clock>::value,
+                                    int>::type = 0>
+  GPCL_TRY_ACQUIRE(true)
+  auto try_lock_until(chrono::time_point<Clock, Duration> const &timeout_time)
+      -> bool
+  {
+    return try_lock_for(timeout_time - Clock::now());
+  }
+
+  template <typename Rep, typename Period>
+  GPCL_TRY_ACQUIRE(true)
+  auto try_lock_for(chrono::duration<Rep, Period> const &rel_time) -> bool
+  {
+    return impl_.try_lock_for(
+        chrono::duration_cast<system_clock::duration>(rel_time));
+  }
+
+  /// Tries to lock the mutex until deadline at the latest, measured on
+  /// CLOCK_MONOTONIC.
+  GPCL_TRY_ACQUIRE(true) auto try_lock_until(const instant &deadline) -> bool
+  {
+    return impl_.try_lock_until(deadline);
+  }
+
+  GPCL_TRY_ACQUIRE(true) auto try_lock_for(const duration &rel_time) -> bool
+  {
+    return impl_.try_lock_until(instant::now().saturating_add(rel_time));
+  }
+
+  GPCL_ACQUIRE_SHARED() auto lock_shared() -> void
+  {
+    return impl_.lock_shared();
+  }
+
+  GPCL_RELEASE_SHARED() auto unlock_shared() -> void
+  {
+    return impl_.unlock_shared();
+  }
+
+  GPCL_TRY_ACQUIRE_SHARED(true) auto try_lock_shared() -> bool
+  {
+    return impl_.try_lock_shared();
+  }
+
+  template <typename Clock, typename Duration,
+            typename std::enable_if<std::is_same<Clock, system_clock>::value,
+                                    int>::type = 0>
+  GPCL_TRY_ACQUIRE_SHARED(true)
+  auto try_lock_shared_until(
+      chrono::time_point<Clock, Duration> const &timeout_time) -> bool
+  {
+    return impl_.try_lock_shared_until(
+        chrono::time_point_cast<system_clock::duration>(timeout_time));
+  }
+
+  template <typename Clock, typename Duration,
+            typename std::enable_if<!std::is_same<Clock, system_clock>::value,
+                                    int>::type = 0>
+  GPCL_TRY_ACQUIRE_SHARED(true)
+  auto try_lock_shared_until(
+      chrono::time_point<Clock, Duration> const &timeout_time) -> bool
+  {
+    return try_lock_shared_for(timeout_time - Clock::now());
+  }
+
+  template <typename Rep, typename Period>
+  GPCL_TRY_ACQUIRE_SHARED(true)
+  auto try_lock_shared_for(chrono::duration<Rep, Period> const &rel_time)
+      -> bool
+  {
+    return impl_.try_lock_shared_for(
+        chrono::duration_cast<system_clock::duration>(rel_time));
+  }
+
+  GPCL_TRY_ACQUIRE_SHARED(true)
+  auto try_lock_shared_until(const instant &deadline) -> bool
+  {
+    return impl_.try_lock_shared_until(deadline);
+  }
+
+  GPCL_TRY_ACQUIRE_SHARED(true)
+  auto try_lock_shared_for(const duration &rel_time) -> bool
+  {
+    return impl_.try_lock_shared_until(
+        instant::now().saturating_add(rel_time));
+  }
+
+  auto native_handle() noexcept -> native_handle_type
+  {
+    return impl_.native_handle();
+  }
+
+private:
+  impl_type impl_;
+};
+
+} // namespace gpcl
+
+#endif // GPCL_POSIX
+
+#endif // GPCL_SHARED_MUTEX_HPP
@@ -0,0 +1,146 @@
+//
+// shm_mpsc_channel.hpp
+// ~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2020 Zhengyi Fu (tsingyat at outlook dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef GPCL_SHM_MPSC_CHANNEL_HPP
+#define GPCL_SHM_MPSC_CHANNEL_HPP
+
+#include <gpcl/buffer.hpp>
+#include <gpcl/creation_tag.hpp>
+#include <gpcl/detail/config.hpp>
+#include <gpcl/detail/error.hpp>
+#include <gpcl/detail/posix_mpsc_channel.hpp>
+#include <gpcl/noncopyable.hpp>
+#include <gpcl/zstring.hpp>
+#include <system_error>
+
+namespace gpcl {
+
+#ifdef GPCL_POSIX
+
+/// A channel in shared memory that passes variable-length messages from
+/// many producers to a single consumer, possibly in different processes.
+///
+/// Messages are written and read in place: a producer reserves space for a
+/// message, serializes it directly into the channel and commits it; the
+/// consumer peeks at the next message, parses it where it is and releases
+/// it. Producers never wait for each other, but a message that has been
+/// reserved and not committed yet holds back the messages reserved after
+/// it.
+///
+/// Each producer thread uses its own shm_mpsc_channel object, since an
+/// object reserves one message at a time. Only one thread may consume.
+class shm_mpsc_channel : noncopyable
+{
+  using impl_type = detail::posix_mpsc_channel;
+
+public:
+  /// Creates a channel of at least capacity bytes, rounded up to a power of
+  /// two.
+  ///
+  /// \throws std::system_error if the channel exists or cannot be created.
+  shm_mpsc_channel(create_only_t, czstring<> name, std::size_t capacity)
+      : impl_(create_only, name, capacity)
+  {
+  }
+
+  /// Opens the channel if it exists, otherwise creates it.
+  shm_mpsc_channel(open_or_create_t, czstring<> name, std::size_t capacity)
+      : impl_(open_or_create, name, capacity)
+  {
+  }
+
+  /// Opens an existing channel, waiting until its creator has formatted it.
+  ///
+  /// \throws std::system_error with ETIMEDOUT if the creator has not
+  /// formatted it within a few seconds, having most likely died.
+  shm_mpsc_channel(open_only_t, czstring<> name) : impl_(open_only, name) {}
+
+  /// Removes the name of the channel. The channel is freed once every
+  /// process has closed it.
+  static void remove(czstring<> name) { impl_type::unlink(name); }
+
+  static void remove(czstring<> name, std::error_code &ec)
+  {
+    impl_type::unlink(name, ec);
+  }
+
+  /// \returns The size of the channel in bytes.
+  std::size_t capacity() const noexcept { return impl_.capacity(); }
+
+  /// \returns The size of the largest message, which is a little less than
+  /// half of the capacity.
+  std::size_t max_msg_size() const noexcept { return impl_.max_msg_size(); }
+
+  /// \effects Reserves size bytes for a message if there is room.
+  ///
+  /// \returns The reserved bytes, or a buffer with a null data() if there
+  /// is no room.
+  ///
+  /// \requires No message is reserved through this object.
+  ///
+  /// \throws std::system_error with EMSGSIZE if size is larger than
+  /// max_msg_size().
+  mutable_buffer try_reserve(std::size_t size)
+  {
+    std::error_code ec;
+    mutable_buffer buf = impl_.try_reserve(size, ec);
+    if (ec)
+      GPCL_THROW(std::system_error(ec, __PRETTY_FUNCTION__));
+    return buf;
+  }
+
+  /// \effects Reserves size bytes for a message, blocking while the channel
+  /// is full.
+  ///
+  /// \requires No message is reserved through this object.
+  ///
+  /// \throws std::system_error with EMSGSIZE if size is larger than
+  /// max_msg_size().
+  mutable_buffer reserve(std::size_t size)
+  {
+    std::error_code ec;
+    mutable_buffer buf = impl_.reserve(size, ec);
+    if (ec)
+      GPCL_THROW(std::system_error(ec, __PRETTY_FUNCTION__));
+    return buf;
+  }
+
+  /// \effects Makes the first n bytes of the reserved buffer a message
+  /// visible to the consumer.
+  ///
+  /// \requires A message is reserved through this object, and n is at most
+  /// its reserved size.
+  void commit(std::size_t n) noexcept { impl_.commit(n); }
+
+  /// \returns Whether a message is reserved through this object.
+  bool reserved() const noexcept { return impl_.reserved(); }
+
+  /// \returns The next message, or a buffer with a null data() if there is
+  /// none. The message stays in the channel until release() is called.
+  const_buffer try_peek() noexcept { return impl_.try_peek(); }
+
+  /// \returns The next message, blocking while there is none.
+  const_buffer peek() noexcept { return impl_.peek(); }
+
+  /// \effects Removes the peeked message from the channel. The buffer
+  /// returned by peek() must not be used afterwards.
+  ///
+  /// \requires A message has been peeked and not released.
+  void release() noexcept { impl_.release(); }
+
+private:
+  impl_type impl_;
+};
+
+#endif // GPCL_POSIX
+
+} // namespace gpcl
+
+#endif // GPCL_SHM_MPSC_CHANNEL_HPP
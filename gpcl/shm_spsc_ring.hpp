@@ -0,0 +1,167 @@
+//
+// shm_spsc_ring.hpp
+// ~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2020 Zhengyi Fu (tsingyat at outlook dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef GPCL_SHM_SPSC_RING_HPP
+#define GPCL_SHM_SPSC_RING_HPP
+
+#include <gpcl/creation_tag.hpp>
+#include <gpcl/detail/config.hpp>
+#include <gpcl/detail/error.hpp>
+#include <gpcl/detail/posix_spsc_ring.hpp>
+#include <gpcl/noncopyable.hpp>
+#include <gpcl/span.hpp>
+#include <gpcl/zstring.hpp>
+#include <system_error>
+
+namespace gpcl {
+
+#ifdef GPCL_POSIX
+
+/// A byte ring in shared memory that passes variable-length messages from a
+/// single producer to a single consumer, possibly in different processes.
+///
+/// Unlike message_queue, sending and receiving a message copies it once and
+/// makes no system call unless the ring is full or empty; then the blocking
+/// functions sleep on a futex.
+///
+/// Only one thread may send and only one thread may receive at a time;
+/// both may hold their own shm_spsc_ring object for the same name.
+class shm_spsc_ring : noncopyable
+{
+  using impl_type = detail::posix_spsc_ring;
+
+public:
+  /// Creates a ring of at least capacity bytes, rounded up to a power of
+  /// two.
+  ///
+  /// \throws std::system_error if the ring exists or cannot be created.
+  shm_spsc_ring(create_only_t, czstring<> name, std::size_t capacity)
+      : impl_(create_only, name, capacity)
+  {
+  }
+
+  /// Opens the ring if it exists, otherwise creates it.
+  shm_spsc_ring(open_or_create_t, czstring<> name, std::size_t capacity)
+      : impl_(open_or_create, name, capacity)
+  {
+  }
+
+  /// Opens an existing ring, waiting until its creator has formatted it.
+  ///
+  /// \throws std::system_error with ETIMEDOUT if the creator has not
+  /// formatted it within a few seconds, having most likely died.
+  shm_spsc_ring(open_only_t, czstring<> name) : impl_(open_only, name) {}
+
+  /// Removes the name of the ring. The ring is freed once every process has
+  /// closed it.
+  static void remove(czstring<> name) { impl_type::unlink(name); }
+
+  static void remove(czstring<> name, std::error_code &ec)
+  {
+    impl_type::unlink(name, ec);
+  }
+
+  /// \returns The size of the ring in bytes.
+  std::size_t capacity() const noexcept { return impl_.capacity(); }
+
+  /// \returns The size of the largest message, which is a little less than
+  /// half of the capacity.
+  std::size_t max_msg_size() const noexcept { return impl_.max_msg_size(); }
+
+  /// \effects Sends msg, blocking while the ring is full.
+  ///
+  /// \throws std::system_error with EMSGSIZE if msg is larger than
+  /// max_msg_size().
+  void send(span<const char> msg)
+  {
+    std::error_code ec;
+    impl_.send(msg, ec);
+    if (ec)
+      GPCL_THROW(std::system_error(ec, __PRETTY_FUNCTION__));
+  }
+
+  void send(span<const char> msg, std::error_code &ec)
+  {
+    impl_.send(msg, ec);
+  }
+
+  /// \effects Sends msg if there is room for it.
+  ///
+  /// \returns Whether msg was sent.
+  bool try_send(span<const char> msg)
+  {
+    if (!try_write(msg))
+      return false;
+    impl_.commit();
+    return true;
+  }
+
+  /// \effects Copies msg into the ring without making it visible to the
+  /// consumer, so that a batch of messages costs a single wake-up.
+  ///
+  /// \returns Whether there was room for msg.
+  ///
+  /// \throws std::system_error with EMSGSIZE if msg is larger than
+  /// max_msg_size().
+  bool try_write(span<const char> msg)
+  {
+    std::error_code ec;
+    bool written = impl_.try_write(msg, ec);
+    if (ec)
+      GPCL_THROW(std::system_error(ec, __PRETTY_FUNCTION__));
+    return written;
+  }
+
+  /// \effects Makes the messages written by try_write() visible to the
+  /// consumer. send() and try_send() commit as well.
+  void commit() noexcept { impl_.commit(); }
+
+  /// \effects Receives the next message into msg, blocking while the ring
+  /// is empty.
+  ///
+  /// \returns The size of the message.
+  ///
+  /// \throws std::system_error with EMSGSIZE if msg is too small for the
+  /// message, which is left in the ring.
+  std::size_t receive(span<char> msg)
+  {
+    std::error_code ec;
+    std::size_t len = impl_.receive(msg, ec);
+    if (ec)
+      GPCL_THROW(std::system_error(ec, __PRETTY_FUNCTION__));
+    return len;
+  }
+
+  std::size_t receive(span<char> msg, std::error_code &ec)
+  {
+    return impl_.receive(msg, ec);
+  }
+
+  /// \effects Receives the next message into msg if there is one.
+  ///
+  /// \returns Whether a message was received; its size is stored in len.
+  bool try_receive(span<char> msg, std::size_t &len)
+  {
+    std::error_code ec;
+    bool received = impl_.try_receive(msg, len, ec);
+    if (ec)
+      GPCL_THROW(std::system_error(ec, __PRETTY_FUNCTION__));
+    return received;
+  }
+
+private:
+  impl_type impl_;
+};
+
+#endif // GPCL_POSIX
+
+} // namespace gpcl
+
+#endif // GPCL_SHM_SPSC_RING_HPP
@@ -26,6 +26,12 @@ class simple_segregated_storage : noncopyable
 public:
   using size_type = SizeType;
 
+  /// \returns The bytes used for bookkeeping in a block, always 0.
+  static constexpr size_type block_overhead(size_type, size_type) noexcept
+  {
+    return 0;
+  }
+
   /// \effects Interleaves a free list through the memory block specified of
   /// `block` of size `sz` bytes, partitioning it into as many
   /// partition_sz-sized chunks as possible. The last chunk is set to point to
@@ -47,7 +53,7 @@ public:
     void *chunk = block;
     void *block_end = reinterpret_cast<char *>(block) + sz - partition_sz;
     while (reinterpret_cast<void *>(reinterpret_cast<char *>(chunk) +
-                                    partition_sz) < block_end)
+                                    partition_sz) <= block_end)
     {
       next_chunk(chunk) = reinterpret_cast<char *>(chunk) + partition_sz;
       chunk = next_chunk(chunk);
@@ -161,6 +167,36 @@ public:
     return nullptr;
   }
 
+  /// \effects Remove up to n chunks from the front of the free list. The
+  /// removed chunks stay linked through their first word and the last one
+  /// points to null.
+  ///
+  /// \param n maximum number of chunks to remove.
+  /// \param first receives the first removed chunk.
+  /// \returns The number of removed chunks.
+  ///
+  /// \notes If `this` is ordered before calling this function, it will remain
+  /// ordered after calling this function.
+  ///
+  /// \complexity O(n).
+  size_type malloc_batch(size_type n, void *&first)
+  {
+    first = free_list_;
+    if (n == 0 || empty())
+      return 0;
+
+    size_type m = 1;
+    void *last = free_list_;
+    while (m < n && next_chunk(last))
+    {
+      last = next_chunk(last);
+      ++m;
+    }
+    free_list_ = next_chunk(last);
+    next_chunk(last) = nullptr;
+    return m;
+  }
+
   /// \effects Put chunk back to the free list.
   ///
   /// \preconditions chunk was previously returned from a call to
@@ -173,6 +209,20 @@ public:
     free_list_ = chunk;
   }
 
+  /// \effects Put a list of chunks linked through their first word back to
+  /// the free list.
+  ///
+  /// \preconditions Every chunk in [first, last] was previously returned from
+  /// this->malloc() or this->malloc_batch().
+  ///
+  /// \complexity O(1).
+  void free_batch(void *const first, void *const last)
+  {
+    GPCL_ASSERT(first && last);
+    next_chunk(last) = free_list_;
+    free_list_ = first;
+  }
+
   /// \effects Put an array of n chunks back to the free list.
   ///
   /// \preconditions the array of chunks was previously returned from a call to
@@ -214,6 +264,45 @@ public:
     add_ordered_block(chunk, partition_sz * n, partition_sz);
   }
 
+  /// \effects If every chunk of the block added by add_block(block, sz,
+  /// partition_sz) is in the free list, removes all of them.
+  ///
+  /// \returns true if the chunks were removed; the block may then be freed.
+  ///
+  /// \notes If `this` is ordered before calling this function, it will remain
+  /// ordered after calling this function.
+  ///
+  /// \complexity O(N) where N is the size of the free list.
+  bool release_block(void *const block, size_type sz, size_type partition_sz)
+  {
+    char *const begin = static_cast<char *>(block);
+    char *const end = begin + sz / partition_sz * partition_sz;
+    auto in_block = [begin, end](void *chunk) {
+      return static_cast<char *>(chunk) >= begin &&
+             static_cast<char *>(chunk) < end;
+    };
+
+    size_type count = 0;
+    for (void *chunk = free_list_; chunk; chunk = next_chunk(chunk))
+      count += in_block(chunk);
+    if (count != sz / partition_sz)
+      return false;
+
+    void **pp = &free_list_;
+    while (*pp)
+    {
+      if (in_block(*pp))
+        *pp = next_chunk(*pp);
+      else
+        pp = &next_chunk(*pp);
+    }
+    return true;
+  }
+
+  /// \effects Forgets all chunks.
+  /// \postconditions this->empty().
+  void clear() noexcept { free_list_ = nullptr; }
+
 private:
   void *&upper_bound(void *const p)
   {
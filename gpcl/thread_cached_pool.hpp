@@ -0,0 +1,124 @@
+//
+// thread_cached_pool.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2020 Zhengyi Fu (tsingyat at outlook dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef GPCL_THREAD_CACHED_POOL_HPP
+#define GPCL_THREAD_CACHED_POOL_HPP
+
+#include <gpcl/detail/config.hpp>
+#include <gpcl/detail/thread_cache.hpp>
+#include <gpcl/noncopyable.hpp>
+#include <gpcl/pool.hpp>
+
+namespace gpcl {
+
+/// A pool with a per-thread cache in front of it.
+///
+/// Every thread keeps a magazine of free chunks. malloc() and free() only
+/// touch the calling thread's magazine; the underlying pool, and its mutex,
+/// are reached once per batch_size chunks to refill an empty magazine or to
+/// drain a full one.
+///
+/// A thread never caches more than max_cached chunks, i.e. at most
+/// max_cached * requested_size bytes (plus alignment) per thread. When a
+/// thread exits its cached chunks are returned to the pool.
+///
+/// \notes Chunks cached by a thread are not free from the pool's point of
+/// view. Call flush() before trimming the underlying pool.
+template <typename UA = default_new_delete_user_allocator,
+          typename MutexType = gpcl::mutex>
+class thread_cached_pool : noncopyable
+{
+public:
+  using pool_type = pool<UA, MutexType>;
+  using user_allocator_type = UA;
+  using mutex_type = MutexType;
+  using size_type = typename pool_type::size_type;
+  using difference_type = typename pool_type::difference_type;
+
+  /// Constructor.
+  ///
+  /// \param requested_size size of each chunk.
+  /// \param batch_size number of chunks moved between a thread's cache and
+  /// the underlying pool at a time.
+  /// \param max_cached maximum number of chunks cached by a thread.
+  /// \requires batch_size != 0 and max_cached >= batch_size.
+  explicit thread_cached_pool(size_type requested_size,
+                              size_type batch_size = 32,
+                              size_type max_cached = 128)
+      : pool_(requested_size),
+        cache_(batch_size, max_cached, &drain, &pool_)
+  {
+  }
+
+  /// Destructor.
+  ///
+  /// \requires No other thread uses the pool concurrently.
+  ~thread_cached_pool() = default;
+
+  /// Determines the requested size.
+  size_type requested_size() const noexcept { return pool_.requested_size(); }
+
+  /// \returns The maximum number of chunks moved at a time.
+  size_type batch_size() const noexcept { return cache_.batch_size(); }
+
+  /// \returns The maximum number of chunks cached by a thread.
+  size_type max_cached() const noexcept { return cache_.max_cached(); }
+
+  /// Allocates memory for an object of size requested_size.
+  ///
+  /// \returns null if out of memory.
+  [[nodiscard]] void *malloc()
+  {
+    if (void *chunk = cache_.try_pop())
+      return chunk;
+
+    void *first;
+    size_type n = pool_.malloc_batch(cache_.batch_size(), first);
+    if (n == 0)
+      return nullptr;
+    return cache_.refill(first, n);
+  }
+
+  /// Allocates memory for an array of n objects of size requested_size.
+  ///
+  /// The array is taken directly from the underlying pool.
+  [[nodiscard]] void *ordered_malloc(size_type n)
+  {
+    return pool_.ordered_malloc(n);
+  }
+
+  /// Frees memory for an object.
+  void free(void *ptr) { cache_.push(ptr); }
+
+  /// Frees memory for an array of objects.
+  void ordered_free(void *ptr, size_type n) { pool_.ordered_free(ptr, n); }
+
+  /// Returns the chunks cached by the calling thread to the underlying pool.
+  void flush() { cache_.flush(); }
+
+  /// \returns The underlying pool.
+  pool_type &underlying_pool() noexcept { return pool_; }
+
+private:
+  static void drain(void *context, void *first, void *last)
+  {
+    static_cast<pool_type *>(context)->free_batch(first, last);
+  }
+
+  pool_type pool_;
+
+  // Declared after pool_, so the caches are detached before the pool frees
+  // its blocks.
+  detail::thread_cache_owner cache_;
+};
+
+} // namespace gpcl
+
+#endif // GPCL_THREAD_CACHED_POOL_HPP
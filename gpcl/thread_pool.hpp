@@ -0,0 +1,193 @@
+//
+// thread_pool.hpp
+// ~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2020 Zhengyi Fu (tsingyat at outlook dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef GPCL_THREAD_POOL_HPP
+#define GPCL_THREAD_POOL_HPP
+
+#include <gpcl/detail/config.hpp>
+#include <gpcl/detail/error.hpp>
+#include <gpcl/detail/futex.hpp>
+#include <gpcl/detail/work_stealing_deque.hpp>
+#include <gpcl/fast_mutex.hpp>
+#include <gpcl/noncopyable.hpp>
+#include <gpcl/thread.hpp>
+#include <gpcl/thread_annotations.hpp>
+#include <gpcl/thread_attributes.hpp>
+#include <gpcl/thread_cached_pool.hpp>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#ifdef GPCL_POSIX
+
+namespace gpcl {
+
+/// A fixed set of worker threads running posted tasks.
+///
+/// Every worker owns a Chase-Lev deque. A task posted from a worker goes
+/// to the bottom of that worker's deque, which the worker pops first, so
+/// fork-join style tasks run depth first and in cache. Tasks posted from
+/// other threads go to a shared injection queue. A worker without work
+/// takes from the injection queue, then steals from the top of the other
+/// workers' deques, and only then sleeps on a futex.
+///
+/// Tasks are stored in fixed-size nodes from a thread_cached_pool; a
+/// callable that fits in the node is stored in place, a larger one on the
+/// heap.
+///
+/// \notes A task that exits with an exception calls std::terminate().
+class thread_pool : noncopyable
+{
+public:
+  /// Starts threads workers, or one per online CPU if threads is 0. The
+  /// workers are created with attr, which sets their stack size and
+  /// scheduling.
+  ///
+  /// \throws std::system_error if a worker cannot be created; the workers
+  /// already started are joined first.
+  GPCL_DECL explicit thread_pool(
+      std::size_t threads = 0,
+      const thread_attributes &attr = thread_attributes());
+
+  /// \effects Calls shutdown().
+  GPCL_DECL ~thread_pool();
+
+  /// \returns The number of workers.
+  std::size_t size() const noexcept { return size_; }
+
+  /// \effects Queues f to be called by a worker.
+  ///
+  /// \throws std::bad_alloc if no task node can be allocated, or what
+  /// copying or moving f throws.
+  ///
+  /// \requires shutdown() has not returned.
+  template <typename F>
+  void post(F &&f)
+  {
+    using function_type = typename std::decay<F>::type;
+
+    void *p = tasks_.malloc();
+    if (!p)
+      GPCL_THROW(std::bad_alloc());
+    task *t = ::new (p) task;
+    GPCL_TRY
+    {
+      construct<function_type>(t, std::forward<F>(f),
+                               fits_in_place<function_type>());
+    }
+    GPCL_CATCH(...)
+    {
+      tasks_.free(p);
+      GPCL_RETHROW
+    }
+    GPCL_CATCH_END
+    submit(t);
+  }
+
+  /// \effects Blocks until every task posted so far, and every task they
+  /// posted, has finished.
+  ///
+  /// \requires Not called from a task of this pool.
+  GPCL_DECL void wait_idle();
+
+  /// \effects Runs the queued tasks, including those they post, then stops
+  /// and joins the workers. Later calls do nothing.
+  ///
+  /// \requires Not called from a task of this pool.
+  GPCL_DECL void shutdown();
+
+private:
+  struct task
+  {
+    task *next;
+    // Calls and then destroys the stored callable.
+    void (*invoke)(task *);
+    alignas(std::max_align_t) unsigned char storage[48];
+  };
+
+  template <typename F>
+  using fits_in_place =
+      std::integral_constant<bool, sizeof(F) <= sizeof(task::storage) &&
+                                       alignof(F) <= alignof(std::max_align_t)>;
+
+  template <typename F, typename Arg>
+  static void construct(task *t, Arg &&f, std::true_type)
+  {
+    ::new (static_cast<void *>(t->storage)) F(std::forward<Arg>(f));
+    t->invoke = [](task *self) {
+      F &fn = *reinterpret_cast<F *>(self->storage);
+      fn();
+      fn.~F();
+    };
+  }
+
+  template <typename F, typename Arg>
+  static void construct(task *t, Arg &&f, std::false_type)
+  {
+    ::new (static_cast<void *>(t->storage)) F *(new F(std::forward<Arg>(f)));
+    t->invoke = [](task *self) {
+      std::unique_ptr<F> fn(*reinterpret_cast<F **>(self->storage));
+      (*fn)();
+    };
+  }
+
+  struct alignas(GPCL_CACHELINE_SIZE) worker
+  {
+    thread_pool *pool = nullptr;
+    std::size_t index = 0;
+    detail::work_stealing_deque<task> deque;
+    gpcl::thread thread;
+  };
+
+  // The worker run by the calling thread, if it is one.
+  GPCL_DECL static worker *&current_worker() noexcept;
+
+  GPCL_DECL void submit(task *t) noexcept;
+  GPCL_DECL void inject(task *t) noexcept;
+  GPCL_DECL task *find_task(worker &w) noexcept;
+  GPCL_DECL bool has_work() const noexcept;
+  GPCL_DECL void execute(task *t) noexcept;
+  GPCL_DECL void run(worker &w) noexcept;
+
+  thread_cached_pool<> tasks_{sizeof(task)};
+
+  std::size_t size_;
+  std::unique_ptr<worker[]> workers_;
+
+  // Tasks posted from outside the workers, oldest first. injected_ lets
+  // workers check for them without taking the mutex.
+  fast_mutex injection_mutex_;
+  task *injection_head_ GPCL_GUARDED_BY(injection_mutex_) = nullptr;
+  task *injection_tail_ GPCL_GUARDED_BY(injection_mutex_) = nullptr;
+  std::atomic<std::size_t> injected_{0};
+
+  // Posted tasks that have not finished yet.
+  alignas(GPCL_CACHELINE_SIZE) detail::futex_word pending_{0};
+  std::atomic<std::uint32_t> idle_waiters_{0};
+
+  // Bumped to wake sleeping workers.
+  alignas(GPCL_CACHELINE_SIZE) detail::futex_word work_seq_{0};
+  std::atomic<std::uint32_t> sleepers_{0};
+  std::atomic<bool> stopping_{false};
+};
+
+} // namespace gpcl
+
+#endif // GPCL_POSIX
+
+#ifdef GPCL_HEADER_ONLY
+#  include <gpcl/detail/impl/thread_pool.ipp>
+#endif
+
+#endif // GPCL_THREAD_POOL_HPP
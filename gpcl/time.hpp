@@ -62,7 +62,7 @@ public:
 
   GPCL_DECL_INLINE static constexpr duration from_micros(u64 micros)
   {
-    return duration(micros / 1'000'000, micros % 1'000'000 * 100);
+    return duration(micros / 1'000'000, micros % 1'000'000 * 1'000);
   }
 
   GPCL_DECL_INLINE static constexpr duration from_nanos(u64 nanos)
@@ -87,14 +87,14 @@ public:
   {
     GPCL_ASSERT(nanos_ < 1'000'000'000);
 
-    return nanos_ / 1'000;
+    return nanos_ / 1'000'000;
   }
 
   GPCL_DECL_INLINE constexpr u32 subsec_micros() const
   {
     GPCL_ASSERT(nanos_ < 1'000'000'000);
 
-    return nanos_ / 1'000'000;
+    return nanos_ / 1'000;
   }
 
   GPCL_DECL_INLINE constexpr u32 subsec_nanos() const
@@ -251,7 +251,7 @@ class instant
   // duration since startup of the system.
   duration since_startup_;
 
-  explicit instant(const duration &d) : since_startup_(d) {}
+  explicit instant(const duration &d) noexcept : since_startup_(d) {}
 
 public:
   /// Returns an instant corresponding to "now".
@@ -295,6 +295,25 @@ public:
     return now().saturating_duration_since(*this);
   }
 
+  /// Returns the instant dur after this one, for use as a deadline.
+  GPCL_DECL_INLINE instant checked_add(const duration &dur) const
+  {
+    return instant{since_startup_.checked_add(dur)};
+  }
+
+  /// Returns the instant dur after this one, or the latest representable
+  /// instant if that would overflow.
+  GPCL_DECL_INLINE instant saturating_add(const duration &dur) const noexcept
+  {
+    return instant{since_startup_.saturating_add(dur)};
+  }
+
+  /// Returns the time of CLOCK_MONOTONIC at this instant.
+  GPCL_DECL_INLINE constexpr duration duration_since_startup() const
+  {
+    return since_startup_;
+  }
+
   friend GPCL_DECL_INLINE constexpr bool operator==(const instant &lhs,
                                                     const instant &rhs)
   {
@@ -0,0 +1,52 @@
+#include <gpcl/counting_semaphore.hpp>
+#include <gpcl/thread.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <vector>
+
+TEST_CASE("counting_semaphore counts")
+{
+  gpcl::counting_semaphore<> sem(2);
+  REQUIRE(sem.try_acquire());
+  REQUIRE(sem.try_acquire());
+  REQUIRE_FALSE(sem.try_acquire());
+  REQUIRE_FALSE(sem.try_acquire_for(gpcl::duration::from_millis(10)));
+  REQUIRE_FALSE(sem.try_acquire_until(gpcl::instant::now()));
+
+  sem.release(3);
+  REQUIRE(sem.try_acquire_for(gpcl::duration::from_millis(10)));
+  REQUIRE(sem.try_acquire_until(
+      gpcl::instant::now().saturating_add(gpcl::duration::max)));
+  sem.acquire();
+  REQUIRE_FALSE(sem.try_acquire());
+}
+
+TEST_CASE("counting_semaphore wakes waiters")
+{
+  constexpr int threads = 4;
+  constexpr int count = 5000;
+  gpcl::counting_semaphore<> items(0);
+  gpcl::binary_semaphore done(0);
+  int acquired = 0;
+  std::vector<gpcl::thread> ts;
+  gpcl::binary_semaphore guard(1);
+  for (int i = 0; i < threads; ++i)
+  {
+    ts.emplace_back([&] {
+      for (int j = 0; j < count; ++j)
+      {
+        items.acquire();
+        guard.acquire();
+        if (++acquired == threads * count)
+          done.release();
+        guard.release();
+      }
+    });
+  }
+  for (int j = 0; j < count; ++j)
+    items.release(threads);
+  done.acquire();
+  for (gpcl::thread &t : ts)
+    t.join();
+  REQUIRE(acquired == threads * count);
+  REQUIRE_FALSE(items.try_acquire());
+}
@@ -0,0 +1,46 @@
+#include <gpcl/fast_event.hpp>
+#include <gpcl/thread.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <atomic>
+#include <vector>
+
+TEST_CASE("fast_event set and reset")
+{
+  gpcl::fast_event e;
+  REQUIRE_FALSE(e.is_set());
+  REQUIRE_FALSE(e.wait_for(gpcl::duration::from_millis(10)));
+
+  e.set();
+  REQUIRE(e.is_set());
+  e.wait();
+  REQUIRE(e.wait_for(gpcl::duration::from_millis(10)));
+
+  e.reset();
+  REQUIRE_FALSE(e.is_set());
+
+  gpcl::fast_event initially_set(true);
+  REQUIRE(initially_set.is_set());
+}
+
+TEST_CASE("fast_event wakes all waiters")
+{
+  constexpr int threads = 8;
+  constexpr int rounds = 100;
+  for (int r = 0; r < rounds; ++r)
+  {
+    gpcl::fast_event e;
+    std::atomic<int> woken{0};
+    std::vector<gpcl::thread> ts;
+    for (int i = 0; i < threads; ++i)
+    {
+      ts.emplace_back([&] {
+        e.wait();
+        ++woken;
+      });
+    }
+    e.set();
+    for (gpcl::thread &t : ts)
+      t.join();
+    REQUIRE(woken == threads);
+  }
+}
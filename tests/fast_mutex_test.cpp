@@ -0,0 +1,143 @@
+#include <gpcl/fast_condition_variable.hpp>
+#include <gpcl/fast_mutex.hpp>
+#include <gpcl/thread.hpp>
+#include <gpcl/unique_lock.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <deque>
+#include <system_error>
+#include <vector>
+
+TEST_CASE("fast_mutex mutual exclusion")
+{
+  gpcl::fast_mutex m;
+  REQUIRE(m.try_lock());
+  REQUIRE_FALSE(m.try_lock());
+  m.unlock();
+
+  constexpr int threads = 8;
+  constexpr int count = 20000;
+  long counter = 0;
+  std::vector<gpcl::thread> ts;
+  for (int i = 0; i < threads; ++i)
+  {
+    ts.emplace_back([&] {
+      for (int j = 0; j < count; ++j)
+      {
+        gpcl::unique_lock<gpcl::fast_mutex> lock(m);
+        ++counter;
+      }
+    });
+  }
+  for (gpcl::thread &t : ts)
+    t.join();
+  REQUIRE(counter == long(threads) * count);
+}
+
+TEST_CASE("checked_fast_mutex reports misuse")
+{
+  gpcl::checked_fast_mutex m;
+  REQUIRE_THROWS_AS(m.unlock(), std::system_error);
+
+  m.lock();
+  REQUIRE(m.owned());
+  REQUIRE_THROWS_AS(m.lock(), std::system_error);
+  REQUIRE_THROWS_AS(m.try_lock(), std::system_error);
+
+  bool other_owned = true;
+  bool other_unlock_failed = false;
+  gpcl::thread t([&] {
+    other_owned = m.owned();
+    try
+    {
+      m.unlock();
+    }
+    catch (const std::system_error &)
+    {
+      other_unlock_failed = true;
+    }
+  });
+  t.join();
+  REQUIRE_FALSE(other_owned);
+  REQUIRE(other_unlock_failed);
+
+  m.unlock();
+  REQUIRE_FALSE(m.owned());
+}
+
+TEST_CASE("fast_condition_variable")
+{
+  gpcl::fast_mutex m;
+  gpcl::fast_condition_variable cv;
+  std::deque<int> q;
+  constexpr int count = 10000;
+
+  long sum = 0;
+  gpcl::thread consumer([&] {
+    for (int i = 0; i < count; ++i)
+    {
+      gpcl::unique_lock<gpcl::fast_mutex> lock(m);
+      cv.wait(lock, [&] { return !q.empty(); });
+      sum += q.front();
+      q.pop_front();
+    }
+  });
+  for (int i = 0; i < count; ++i)
+  {
+    {
+      gpcl::unique_lock<gpcl::fast_mutex> lock(m);
+      q.push_back(i);
+    }
+    cv.notify_one();
+  }
+  consumer.join();
+  REQUIRE(sum == long(count) * (count - 1) / 2);
+
+  gpcl::unique_lock<gpcl::fast_mutex> lock(m);
+  REQUIRE_FALSE(
+      cv.wait_for(lock, gpcl::duration::from_millis(10), [] { return false; }));
+  REQUIRE(lock.owns_lock());
+
+  // Works with the checked mutex as well.
+  gpcl::checked_fast_mutex cm;
+  gpcl::unique_lock<gpcl::checked_fast_mutex> clock(cm);
+  REQUIRE(cv.wait_for(clock, gpcl::duration::from_millis(10)) ==
+          gpcl::cv_status::timeout);
+  REQUIRE(cm.owned());
+}
+
+TEST_CASE("fast_condition_variable notify_all")
+{
+  gpcl::fast_mutex m;
+  gpcl::fast_condition_variable cv;
+  constexpr int threads = 8;
+  constexpr int rounds = 200;
+
+  // Every round wakes all waiters at once; the requeued ones must each
+  // get the mutex in turn.
+  int round = 0;
+  int arrived = 0;
+  std::vector<gpcl::thread> ts;
+  for (int i = 0; i < threads; ++i)
+  {
+    ts.emplace_back([&] {
+      gpcl::unique_lock<gpcl::fast_mutex> lock(m);
+      for (int r = 0; r < rounds; ++r)
+      {
+        ++arrived;
+        cv.notify_all();
+        cv.wait(lock, [&] { return round > r; });
+      }
+    });
+  }
+  for (int r = 0; r < rounds; ++r)
+  {
+    gpcl::unique_lock<gpcl::fast_mutex> lock(m);
+    cv.wait(lock, [&] { return arrived == threads; });
+    arrived = 0;
+    ++round;
+    cv.notify_all();
+  }
+  for (gpcl::thread &t : ts)
+    t.join();
+  REQUIRE(round == rounds);
+}
@@ -0,0 +1,87 @@
+#include <gpcl/barrier.hpp>
+#include <gpcl/latch.hpp>
+#include <gpcl/thread.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <atomic>
+#include <vector>
+
+TEST_CASE("latch")
+{
+  gpcl::latch l(3);
+  REQUIRE_FALSE(l.try_wait());
+  REQUIRE_FALSE(l.wait_for(gpcl::duration::from_millis(10)));
+  l.count_down(2);
+  REQUIRE_FALSE(l.try_wait());
+
+  constexpr int threads = 4;
+  std::atomic<int> released{0};
+  std::vector<gpcl::thread> ts;
+  for (int i = 0; i < threads; ++i)
+  {
+    ts.emplace_back([&] {
+      l.wait();
+      ++released;
+    });
+  }
+  l.count_down();
+  for (gpcl::thread &t : ts)
+    t.join();
+  REQUIRE(released == threads);
+  REQUIRE(l.try_wait());
+  REQUIRE(l.wait_until(gpcl::instant::now()));
+
+  gpcl::latch start(threads);
+  ts.clear();
+  for (int i = 0; i < threads; ++i)
+    ts.emplace_back([&] { start.arrive_and_wait(); });
+  for (gpcl::thread &t : ts)
+    t.join();
+  REQUIRE(start.try_wait());
+}
+
+TEST_CASE("barrier phases")
+{
+  constexpr int threads = 4;
+  constexpr int phases = 500;
+  int completed = 0;
+  int counts[threads] = {};
+  bool consistent = true;
+
+  // The completion function sees every thread done with the phase.
+  auto on_completion = [&]() noexcept {
+    ++completed;
+    for (int c : counts)
+      consistent = consistent && c == completed;
+  };
+  gpcl::barrier<decltype(on_completion)> b(threads, on_completion);
+
+  std::vector<gpcl::thread> ts;
+  for (int i = 0; i < threads; ++i)
+  {
+    ts.emplace_back([&, i] {
+      for (int p = 0; p < phases; ++p)
+      {
+        ++counts[i];
+        b.arrive_and_wait();
+      }
+    });
+  }
+  for (gpcl::thread &t : ts)
+    t.join();
+  REQUIRE(completed == phases);
+  REQUIRE(consistent);
+}
+
+TEST_CASE("barrier arrive_and_drop and timed wait")
+{
+  gpcl::barrier<> b(2);
+  REQUIRE_FALSE(b.wait_for(b.arrive(), gpcl::duration::from_millis(10)));
+
+  // The second arrival completes the phase the first token belongs to.
+  gpcl::thread t([&] { b.arrive_and_drop(); });
+  t.join();
+
+  // Only one arrival is expected from now on.
+  b.arrive_and_wait();
+  REQUIRE(b.wait_until(b.arrive(), gpcl::instant::now()));
+}
@@ -0,0 +1,233 @@
+#include <gpcl/managed_shared_memory.hpp>
+#include "shm_name.hpp"
+#include <catch2/catch_test_macros.hpp>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+using shm_vector = std::vector<int, gpcl::segment_allocator<int>>;
+
+struct segment_name : shm_name
+{
+  segment_name()
+      : shm_name("/gpcl_test_", &gpcl::managed_shared_memory::remove)
+  {
+  }
+};
+
+} // namespace
+
+TEST_CASE("managed_shared_memory allocation")
+{
+  segment_name name;
+  gpcl::managed_shared_memory segment(gpcl::create_only, name.c_str(),
+                                      1 << 16);
+  std::size_t initial = segment.free_memory();
+
+  std::vector<void *> blocks;
+  for (std::size_t i = 0; i < 64; ++i)
+  {
+    std::size_t alignment = std::size_t(1) << (i % 8);
+    void *p = segment.allocate(i * 8, alignment);
+    REQUIRE(segment.contains(p));
+    REQUIRE(reinterpret_cast<std::uintptr_t>(p) % alignment == 0);
+    blocks.push_back(p);
+  }
+
+  // Free every other block first, so that merging happens on both sides.
+  for (std::size_t i = 0; i < blocks.size(); i += 2)
+    segment.deallocate(blocks[i]);
+  for (std::size_t i = 1; i < blocks.size(); i += 2)
+    segment.deallocate(blocks[i]);
+  REQUIRE(segment.free_memory() == initial);
+
+  void *all = segment.allocate(initial / 2);
+  REQUIRE_THROWS_AS(segment.allocate(initial / 2), std::bad_alloc);
+  segment.deallocate(all);
+
+  auto *r = segment.resource();
+  void *p = r->allocate(100, 64);
+  REQUIRE(segment.contains(p));
+  r->deallocate(p, 100, 64);
+  REQUIRE(segment.free_memory() == initial);
+}
+
+TEST_CASE("managed_shared_memory named objects")
+{
+  segment_name name;
+  gpcl::managed_shared_memory segment(gpcl::create_only, name.c_str(),
+                                      1 << 20);
+
+  auto *v = segment.construct<shm_vector>(
+      "numbers", gpcl::segment_allocator<int>(segment));
+  REQUIRE(v);
+  REQUIRE(segment.construct<shm_vector>(
+              "numbers", gpcl::segment_allocator<int>(segment)) == nullptr);
+  REQUIRE(segment.find_or_construct<shm_vector>(
+              "numbers", gpcl::segment_allocator<int>(segment)) == v);
+  for (int i = 0; i < 100; ++i)
+    v->push_back(i);
+
+  // A second mapping of the segment sits at another address.
+  {
+    gpcl::managed_shared_memory other(gpcl::open_only, name.c_str());
+    REQUIRE(other.address() != segment.address());
+    auto *w = other.find<shm_vector>("numbers");
+    REQUIRE(w);
+    REQUIRE(other.contains(w));
+    REQUIRE(w->size() == 100);
+    REQUIRE((*w)[99] == 99);
+    for (int i = 100; i < 1000; ++i)
+      w->push_back(i);
+  }
+  REQUIRE(v->size() == 1000);
+  REQUIRE((*v)[999] == 999);
+
+  // Another process.
+  pid_t pid = ::fork();
+  REQUIRE(pid != -1);
+  if (pid == 0)
+  {
+    gpcl::managed_shared_memory child(gpcl::open_or_create, name.c_str(),
+                                      1 << 20);
+    auto *w = child.find<shm_vector>("numbers");
+    bool ok = w && w->size() == 1000;
+    if (ok)
+      w->assign(10, 42);
+    ::_exit(ok ? 0 : 1);
+  }
+  int status = 0;
+  REQUIRE(::waitpid(pid, &status, 0) == pid);
+  REQUIRE(WIFEXITED(status));
+  REQUIRE(WEXITSTATUS(status) == 0);
+  REQUIRE(*v == shm_vector(10, 42, gpcl::segment_allocator<int>(segment)));
+
+  REQUIRE(segment.destroy<shm_vector>("numbers"));
+  REQUIRE_FALSE(segment.destroy<shm_vector>("numbers"));
+  REQUIRE(segment.find<shm_vector>("numbers") == nullptr);
+}
+
+TEST_CASE("managed_shared_memory owner death")
+{
+  segment_name name;
+  gpcl::managed_shared_memory segment(gpcl::create_only, name.c_str(),
+                                      1 << 16);
+  auto *mtx = &segment.segment_manager()->mutex();
+
+  // A process dies holding the mutex without touching the bookkeeping.
+  pid_t pid = ::fork();
+  REQUIRE(pid != -1);
+  if (pid == 0)
+  {
+    mtx->lock();
+    ::_exit(0);
+  }
+  REQUIRE(::waitpid(pid, nullptr, 0) == pid);
+  mtx->lock();
+  REQUIRE(mtx->owner_died());
+  mtx->unlock();
+  void *p = segment.allocate(100);
+  REQUIRE(p);
+  mtx->lock();
+  REQUIRE_FALSE(mtx->owner_died());
+  mtx->unlock();
+  segment.deallocate(p);
+
+  // A process dies holding the mutex in the middle of an update.
+  pid = ::fork();
+  REQUIRE(pid != -1);
+  if (pid == 0)
+  {
+    mtx->lock();
+    std::size_t offset = sizeof(gpcl::detail::segment_manager);
+    std::memset(static_cast<char *>(segment.address()) + offset, 0xff,
+                segment.size() - offset);
+    ::_exit(0);
+  }
+  REQUIRE(::waitpid(pid, nullptr, 0) == pid);
+  try
+  {
+    segment.allocate(100);
+    FAIL("a damaged segment was accepted");
+  }
+  catch (const std::system_error &e)
+  {
+    REQUIRE(e.code().value() == EOWNERDEAD);
+  }
+  REQUIRE_THROWS_AS(segment.find<int>("x"), std::system_error);
+}
+
+TEST_CASE("managed_shared_memory creator died before formatting")
+{
+  segment_name name;
+  auto require_timeout = [&name] {
+    try
+    {
+      gpcl::managed_shared_memory segment(gpcl::open_only, name.c_str());
+      FAIL("an unformatted segment was opened");
+    }
+    catch (const std::system_error &e)
+    {
+      REQUIRE(e.code().value() == ETIMEDOUT);
+    }
+  };
+
+  // Died before setting the size.
+  int fd = ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+  REQUIRE(fd != -1);
+  require_timeout();
+
+  // Died before formatting.
+  REQUIRE(::ftruncate(fd, 1 << 16) == 0);
+  ::close(fd);
+  require_timeout();
+}
+
+TEST_CASE("managed_shared_memory removes a segment it failed to map")
+{
+  segment_name name;
+  pid_t pid = ::fork();
+  REQUIRE(pid != -1);
+  if (pid == 0)
+  {
+    // Leave too little address space to map a large segment; setting its
+    // size does not need any.
+    long pages = 0;
+    if (std::FILE *f = std::fopen("/proc/self/statm", "r"))
+    {
+      if (std::fscanf(f, "%ld", &pages) != 1)
+        pages = 0;
+      std::fclose(f);
+    }
+    rlim_t limit = rlim_t(pages) * ::sysconf(_SC_PAGESIZE) + (16 << 20);
+    rlimit rl{limit, limit};
+    if (pages == 0 || ::setrlimit(RLIMIT_AS, &rl) != 0)
+      ::_exit(2);
+
+    bool failed = false;
+    try
+    {
+      gpcl::managed_shared_memory segment(gpcl::create_only, name.c_str(),
+                                          std::size_t(1) << 30);
+    }
+    catch (const std::system_error &e)
+    {
+      failed = e.code().value() == ENOMEM;
+    }
+    bool removed = ::shm_open(name.c_str(), O_RDWR, 0) == -1 && errno == ENOENT;
+    ::_exit(failed && removed ? 0 : 1);
+  }
+  int status = 0;
+  REQUIRE(::waitpid(pid, &status, 0) == pid);
+  REQUIRE(WIFEXITED(status));
+  REQUIRE(WEXITSTATUS(status) == 0);
+}
@@ -0,0 +1,131 @@
+#include <gpcl/message_queue.hpp>
+#include "shm_name.hpp"
+#include <catch2/catch_test_macros.hpp>
+#include <poll.h>
+#include <string>
+#include <unistd.h>
+
+namespace {
+
+struct queue_name : shm_name
+{
+  queue_name() : shm_name("/gpcl_mq_test_", &gpcl::message_queue::unlink) {}
+};
+
+bool readable(const gpcl::message_queue &q)
+{
+  pollfd pfd{q.native_handle(), POLLIN, 0};
+  return ::poll(&pfd, 1, 0) == 1 && (pfd.revents & POLLIN);
+}
+
+} // namespace
+
+TEST_CASE("message_queue non-blocking mode")
+{
+  queue_name name;
+  gpcl::message_queue q(gpcl::create_only, name.c_str(), 2, 16,
+                        gpcl::queue_mode::non_blocking);
+  REQUIRE(q.mode() == gpcl::queue_mode::non_blocking);
+
+  char buf[16];
+  std::error_code ec;
+  q.receive(buf, ec);
+  REQUIRE(ec == std::errc::resource_unavailable_try_again);
+  REQUIRE_FALSE(readable(q));
+
+  q.send(gpcl::span<const char>("a", 1), 0);
+  q.send(gpcl::span<const char>("b", 1), 0);
+  q.send(gpcl::span<const char>("c", 1), 0, ec);
+  REQUIRE(ec == std::errc::resource_unavailable_try_again);
+  REQUIRE(readable(q));
+
+  q.set_mode(gpcl::queue_mode::blocking);
+  REQUIRE(q.mode() == gpcl::queue_mode::blocking);
+  REQUIRE(q.receive(buf) == 1);
+  REQUIRE(buf[0] == 'a');
+}
+
+TEST_CASE("message_queue timed operations")
+{
+  queue_name name;
+  gpcl::message_queue q(gpcl::create_only, name.c_str(), 1, 16);
+
+  auto soon = [] {
+    return gpcl::system_time::now().checked_add(
+        gpcl::duration::from_millis(10));
+  };
+  char buf[16];
+  std::size_t len = 0;
+  REQUIRE_FALSE(q.timed_receive(buf, len, soon()));
+
+  REQUIRE(q.timed_send(gpcl::span<const char>("hi", 2), 0, soon()));
+  REQUIRE_FALSE(q.timed_send(gpcl::span<const char>("hi", 2), 0, soon()));
+  REQUIRE(q.timed_receive(buf, len, soon()));
+  REQUIRE(len == 2);
+
+  auto deadline = [] {
+    return gpcl::instant::now().saturating_add(
+        gpcl::duration::from_millis(10));
+  };
+  gpcl::received_message m;
+  gpcl::instant start = gpcl::instant::now();
+  REQUIRE_FALSE(q.timed_receive(buf, m, deadline()));
+  REQUIRE(start.elapsed() >= gpcl::duration::from_millis(10));
+
+  REQUIRE(q.timed_send(gpcl::span<const char>("hey", 3), 1, deadline()));
+  REQUIRE_FALSE(q.timed_send(gpcl::span<const char>("hi", 2), 0, deadline()));
+  REQUIRE(q.timed_receive(buf, m, deadline()));
+  REQUIRE(m.size() == 3);
+  REQUIRE(m.priority == 1);
+}
+
+TEST_CASE("message_queue receive_batch")
+{
+  queue_name name;
+  gpcl::message_queue q(gpcl::create_only, name.c_str(), 8, 16);
+  for (char c : std::string("xyz"))
+    q.send(gpcl::span<const char>(&c, 1), 0);
+
+  char storage[4][16];
+  gpcl::span<char> bufs[4] = {storage[0], storage[1], storage[2], storage[3]};
+  gpcl::received_message msgs[4] = {};
+
+  // Stops once the queue is empty, even though the queue is blocking.
+  REQUIRE(q.receive_batch(gpcl::span<const gpcl::span<char>>(bufs, 4), msgs) ==
+          3);
+  REQUIRE(msgs[0].size() == 1);
+  REQUIRE(msgs[0].data.data() == storage[0]);
+  REQUIRE(storage[0][0] == 'x');
+  REQUIRE(storage[1][0] == 'y');
+  REQUIRE(storage[2][0] == 'z');
+}
+
+TEST_CASE("message_queue priority and depth")
+{
+  queue_name name;
+  gpcl::message_queue q(gpcl::create_only, name.c_str(), 4, 32);
+  REQUIRE(q.capacity() == 4);
+  REQUIRE(q.max_msg_size() == 32);
+  REQUIRE(q.size() == 0);
+
+  q.send(gpcl::span<const char>("low", 3), 1);
+  q.send(gpcl::span<const char>("high", 4), 7);
+  REQUIRE(q.size() == 2);
+
+  // Messages of higher priority come first.
+  char buf[32];
+  gpcl::received_message m = q.receive_message(buf);
+  REQUIRE(m.priority == 7);
+  REQUIRE(std::string(m.data.data(), m.size()) == "high");
+
+  auto e = q.receive_message(gpcl::use_expected, buf);
+  REQUIRE(e.has_value());
+  REQUIRE(e->priority == 1);
+  REQUIRE(e->size() == 3);
+  REQUIRE(q.size() == 0);
+
+  q.set_mode(gpcl::queue_mode::non_blocking);
+  e = q.receive_message(gpcl::use_expected, buf);
+  REQUIRE_FALSE(e.has_value());
+  REQUIRE(e.error() == std::errc::resource_unavailable_try_again);
+}
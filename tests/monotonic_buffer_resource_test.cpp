@@ -1,6 +1,9 @@
+#include <gpcl/pmr/arena.hpp>
 #include <gpcl/pmr/monotonic_buffer_resource.hpp>
 #include <gpcl/pmr/new_delete_resource.hpp>
+#include <gpcl/pool_statistics.hpp>
 #include <catch2/catch_test_macros.hpp>
+#include <cstring>
 #include <map>
 #include <memory>
 
@@ -52,3 +55,217 @@ TEST_CASE("test monotonic_buffer_resource")
 
   resource.release();
 }
+
+TEST_CASE("monotonic_buffer_resource statistics")
+{
+  gpcl::pool_statistics stats;
+  {
+    checking_resource upstream;
+    gpcl::pmr::monotonic_buffer_resource resource(64, &upstream);
+    resource.set_statistics(&stats);
+
+    for (int i = 0; i < 10; ++i)
+      REQUIRE(resource.allocate(32, 8) != nullptr);
+    REQUIRE(stats.live_chunks() == 10);
+    REQUIRE(stats.blocks() >= 1);
+    REQUIRE(stats.bytes_reserved() >= 10 * 32);
+
+    resource.release();
+    REQUIRE(stats.live_chunks() == 0);
+    REQUIRE(stats.peak_live_chunks() == 10);
+    REQUIRE(stats.bytes_reserved() == 0);
+    resource.set_statistics(nullptr);
+  }
+}
+
+namespace {
+
+class counting_upstream : public gpcl::pmr::memory_resource
+{
+public:
+  std::size_t allocations = 0;
+  std::size_t deallocations = 0;
+
+private:
+  void *do_allocate(std::size_t bytes, std::size_t alignment) override
+  {
+    ++allocations;
+    return gpcl::pmr::new_delete_resource()->allocate(bytes, alignment);
+  }
+
+  void do_deallocate(void *p, std::size_t bytes, std::size_t alignment) override
+  {
+    ++deallocations;
+    gpcl::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+  }
+
+  bool do_is_equal(const memory_resource &other) const noexcept override
+  {
+    return this == &other;
+  }
+};
+
+void request_cycle(gpcl::pmr::memory_resource &r)
+{
+  for (std::size_t i = 1; i < 200; ++i)
+  {
+    void *p = r.allocate(i, alignof(std::max_align_t));
+    std::memset(p, 0xab, i);
+  }
+}
+
+} // namespace
+
+TEST_CASE("monotonic_buffer_resource reset keeps all blocks")
+{
+  counting_upstream upstream;
+  alignas(std::max_align_t) char buffer[256];
+  gpcl::pmr::monotonic_buffer_resource r(buffer, sizeof buffer, &upstream);
+
+  // The caller's buffer is used first.
+  void *p = r.allocate(64);
+  REQUIRE(p == buffer);
+
+  request_cycle(r);
+  std::size_t blocks = upstream.allocations;
+  REQUIRE(blocks != 0);
+
+  for (int i = 0; i < 10; ++i)
+  {
+    r.reset();
+    REQUIRE(r.allocate(64) == buffer);
+    request_cycle(r);
+  }
+  REQUIRE(upstream.allocations == blocks);
+  REQUIRE(upstream.deallocations == 0);
+
+  r.release();
+  REQUIRE(upstream.deallocations == blocks);
+  REQUIRE(r.upstream_bytes() == 0);
+  REQUIRE(r.allocate(64) == buffer);
+}
+
+TEST_CASE("monotonic_buffer_resource reset keeps the largest block")
+{
+  counting_upstream upstream;
+  gpcl::pmr::monotonic_buffer_resource r(&upstream);
+
+  request_cycle(r);
+  std::size_t blocks = upstream.allocations;
+  REQUIRE(blocks > 1);
+
+  r.reset(gpcl::pmr::reset_mode::keep_largest);
+  REQUIRE(upstream.deallocations == blocks - 1);
+
+  // The largest block serves the next small requests.
+  for (int i = 0; i < 10; ++i)
+    REQUIRE(r.allocate(8) != nullptr);
+  REQUIRE(upstream.allocations == blocks);
+}
+
+TEST_CASE("monotonic_buffer_resource growth options")
+{
+  counting_upstream upstream;
+  gpcl::pmr::monotonic_buffer_options opts;
+  opts.initial_size = 100;
+  opts.growth_factor = 1.5;
+  opts.max_block_size = 200;
+  gpcl::pmr::monotonic_buffer_resource r(opts, &upstream);
+  REQUIRE(r.options().max_block_size == 200);
+  REQUIRE(upstream.allocations == 0);
+
+  REQUIRE(r.allocate(100) != nullptr);
+  std::size_t first = r.upstream_bytes();
+  REQUIRE(r.allocate(150) != nullptr);
+  REQUIRE(r.upstream_bytes() - first >= 150);
+  REQUIRE(r.upstream_bytes() - first < 200);
+
+  // Later blocks stop growing at max_block_size.
+  for (int i = 0; i < 10; ++i)
+    REQUIRE(r.allocate(150) != nullptr);
+  REQUIRE(r.upstream_bytes() < 12 * 300);
+
+  // A request larger than the limit still succeeds.
+  REQUIRE(r.allocate(1000) != nullptr);
+}
+
+TEST_CASE("arena inline allocation")
+{
+  counting_upstream upstream;
+  gpcl::pmr::arena a(128, &upstream);
+  REQUIRE(upstream.allocations == 1);
+
+  auto *c = a.allocate_object<char>(3);
+  auto *d = a.allocate_object<double>(2);
+  REQUIRE(is_aligned(d, alignof(double)));
+  REQUIRE(reinterpret_cast<char *>(d) > c + 2);
+  auto *p = a.allocate_bytes(1, 64);
+  REQUIRE(is_aligned(p, 64));
+  REQUIRE(a.allocate_bytes(0) != a.allocate_bytes(0));
+
+  // Falls back to a new block when the current one is exhausted.
+  auto *big = a.allocate_object<std::uint64_t>(1000);
+  big[999] = 1;
+  REQUIRE(upstream.allocations == 2);
+
+  REQUIRE_THROWS_AS(a.allocate_object<std::uint64_t>(std::size_t(-1) / 4),
+                    std::bad_array_new_length);
+
+  // Usable through the memory_resource interface, also on an arena.
+  gpcl::pmr::memory_resource &r = a;
+  void *q = r.allocate(24, 8);
+  REQUIRE(is_aligned(q, 8));
+  r.deallocate(q, 24, 8);
+  q = a.allocate(16, 8);
+  REQUIRE(is_aligned(q, 8));
+  a.deallocate(q, 16, 8);
+
+  auto blocks = upstream.allocations;
+  a.reset();
+  REQUIRE(a.allocate_object<char>(3) != nullptr);
+  REQUIRE(a.allocate_object<std::uint64_t>(1000) != nullptr);
+  REQUIRE(upstream.allocations == blocks);
+}
+
+TEST_CASE("monotonic_buffer_resource checkpoints")
+{
+  counting_upstream upstream;
+  alignas(std::max_align_t) char buffer[64];
+  gpcl::pmr::monotonic_buffer_resource r(buffer, sizeof buffer, &upstream);
+
+  auto outer = r.mark();
+  void *p = r.allocate(16);
+  REQUIRE(p == buffer);
+
+  auto inner = r.mark();
+  void *q = r.allocate(16);
+  request_cycle(r);
+  std::size_t blocks = upstream.allocations;
+  REQUIRE(blocks != 0);
+
+  // Memory allocated since the mark is handed out again, and the blocks
+  // obtained since then are reused.
+  r.rewind(inner);
+  REQUIRE(r.allocate(16) == q);
+  request_cycle(r);
+  REQUIRE(upstream.allocations == blocks);
+
+  r.rewind(outer);
+  REQUIRE(r.allocate(16) == p);
+
+  {
+    gpcl::pmr::scoped_checkpoint scope(r);
+    request_cycle(r);
+  }
+  REQUIRE(upstream.allocations == blocks);
+  REQUIRE(upstream.deallocations == 0);
+
+  // Checkpoints taken inside a block.
+  gpcl::pmr::monotonic_buffer_resource r2(&upstream);
+  void *a = r2.allocate(8);
+  auto cp = r2.mark();
+  void *b = r2.allocate(8);
+  REQUIRE(b != a);
+  r2.rewind(cp);
+  REQUIRE(r2.allocate(8) == b);
+}
@@ -0,0 +1,121 @@
+#include <gpcl/mpmc_queue.hpp>
+#include <gpcl/thread.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+TEST_CASE("mpmc_queue single thread")
+{
+  gpcl::mpmc_queue<std::unique_ptr<int>> q(5);
+  REQUIRE(q.capacity() == 8);
+
+  std::unique_ptr<int> v;
+  REQUIRE_FALSE(q.try_pop(v));
+  for (int i = 0; i < 8; ++i)
+    REQUIRE(q.try_push(std::make_unique<int>(i)));
+  REQUIRE_FALSE(q.try_push(std::make_unique<int>(8)));
+  REQUIRE(q.size_approx() == 8);
+
+  for (int i = 0; i < 8; ++i)
+  {
+    REQUIRE(q.try_pop(v));
+    REQUIRE(*v == i);
+  }
+  REQUIRE_FALSE(q.pop_for(v, gpcl::duration::from_millis(10)));
+
+  // Batches stop at the end of the free or full slots.
+  std::vector<int> in{1, 2, 3, 4, 5, 6};
+  gpcl::mpmc_queue<int> ints(4);
+  REQUIRE(ints.try_push_n(in.begin(), in.size()) == 4);
+  REQUIRE(ints.try_push_n(in.begin(), in.size()) == 0);
+  int out[6] = {};
+  REQUIRE(ints.try_pop_n(out, 3) == 3);
+  REQUIRE(ints.try_push_n(in.begin() + 4, 2) == 2);
+  REQUIRE(ints.try_pop_n(out + 3, 6) == 3);
+  REQUIRE(std::vector<int>(out, out + 6) == in);
+
+  // Elements left in the queue are destroyed with it.
+  auto shared = std::make_shared<int>(0);
+  {
+    gpcl::mpmc_queue<std::shared_ptr<int>> left(4);
+    left.push(shared);
+    left.push(shared);
+    REQUIRE(shared.use_count() == 3);
+  }
+  REQUIRE(shared.use_count() == 1);
+}
+
+TEST_CASE("mpmc_queue many threads")
+{
+  constexpr int producers = 4;
+  constexpr int consumers = 4;
+  constexpr int count = 100000;
+  gpcl::mpmc_queue<int> q(64);
+  std::atomic<long long> sum{0};
+  std::atomic<int> popped{0};
+
+  std::vector<gpcl::thread> threads;
+  for (int p = 0; p < producers; ++p)
+  {
+    threads.emplace_back([&q, p] {
+      std::vector<int> batch;
+      for (int i = 0; i < count; ++i)
+      {
+        int v = p * count + i;
+        if (p % 2 == 0)
+        {
+          q.push(v);
+          continue;
+        }
+        batch.push_back(v);
+        if (batch.size() == 16 || i == count - 1)
+        {
+          q.push_n(batch.begin(), batch.size());
+          batch.clear();
+        }
+      }
+    });
+  }
+  for (int c = 0; c < consumers; ++c)
+  {
+    threads.emplace_back([&q, &sum, &popped, c] {
+      // Every consumer stops at the first -1 it pops.
+      int batch[16];
+      long long local = 0;
+      bool done = false;
+      while (!done)
+      {
+        std::size_t n = 1;
+        if (c % 2 == 0)
+          q.pop(batch[0]);
+        else
+          n = q.pop_n(batch, 16);
+
+        for (std::size_t i = 0; i < n; ++i)
+        {
+          if (batch[i] != -1)
+          {
+            local += batch[i];
+            popped.fetch_add(1);
+          }
+          else if (done)
+            q.push(-1);
+          else
+            done = true;
+        }
+      }
+      sum.fetch_add(local);
+    });
+  }
+  for (int p = 0; p < producers; ++p)
+    threads[p].join();
+  for (int c = 0; c < consumers; ++c)
+    q.push(-1);
+  for (int c = 0; c < consumers; ++c)
+    threads[producers + c].join();
+
+  long long total = static_cast<long long>(producers) * count;
+  REQUIRE(popped.load() == total);
+  REQUIRE(sum.load() == total * (total - 1) / 2);
+}
@@ -0,0 +1,159 @@
+#include <gpcl/pmr/monotonic_buffer_resource.hpp>
+#include <gpcl/pmr/new_delete_resource.hpp>
+#include <gpcl/pmr/polymorphic_allocator.hpp>
+#include <gpcl/thread.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace {
+
+template <typename T>
+using pmr_vector = std::vector<T, gpcl::pmr::polymorphic_allocator<T>>;
+
+// Takes the allocator as the trailing constructor argument.
+struct trailing
+{
+  using allocator_type = gpcl::pmr::polymorphic_allocator<char>;
+
+  explicit trailing(int v, const allocator_type &a = {}) : value(v), alloc(a)
+  {
+  }
+
+  int value;
+  allocator_type alloc;
+};
+
+// Takes the allocator after std::allocator_arg.
+struct leading
+{
+  using allocator_type = gpcl::pmr::polymorphic_allocator<char>;
+
+  leading(std::allocator_arg_t, const allocator_type &a, int v)
+      : value(v),
+        alloc(a)
+  {
+  }
+
+  int value;
+  allocator_type alloc;
+};
+
+struct throwing
+{
+  throwing() { throw std::runtime_error("throwing"); }
+};
+
+} // namespace
+
+TEST_CASE("polymorphic_allocator propagates to nested containers")
+{
+  gpcl::pmr::monotonic_buffer_resource arena;
+  gpcl::pmr::polymorphic_allocator<int> alloc(&arena);
+
+  pmr_vector<pmr_vector<int>> outer(alloc);
+  outer.emplace_back();
+  outer.emplace_back(3, 7);
+  REQUIRE(outer[0].get_allocator().resource() == &arena);
+  REQUIRE(outer[1].get_allocator().resource() == &arena);
+  REQUIRE(outer[1][2] == 7);
+
+  using value = std::pair<const int, pmr_vector<int>>;
+  std::map<int, pmr_vector<int>, std::less<int>,
+           gpcl::pmr::polymorphic_allocator<value>>
+      m(alloc);
+  m.emplace(1, pmr_vector<int>{});
+  m[2].push_back(1);
+  m.emplace(std::piecewise_construct, std::forward_as_tuple(3),
+            std::forward_as_tuple(2, 5));
+  REQUIRE(m[1].get_allocator().resource() == &arena);
+  REQUIRE(m[2].get_allocator().resource() == &arena);
+  REQUIRE(m[3].get_allocator().resource() == &arena);
+  REQUIRE(m[3] == pmr_vector<int>{5, 5});
+}
+
+TEST_CASE("polymorphic_allocator construct")
+{
+  gpcl::pmr::monotonic_buffer_resource arena;
+  gpcl::pmr::polymorphic_allocator<int> alloc(&arena);
+
+  auto *t = alloc.new_object<trailing>(1);
+  REQUIRE(t->value == 1);
+  REQUIRE(t->alloc.resource() == &arena);
+  alloc.delete_object(t);
+
+  auto *l = alloc.new_object<leading>(2);
+  REQUIRE(l->value == 2);
+  REQUIRE(l->alloc.resource() == &arena);
+  alloc.delete_object(l);
+
+  using pair = std::pair<trailing, int>;
+  auto *p = alloc.new_object<pair>(3, 4);
+  REQUIRE(p->first.value == 3);
+  REQUIRE(p->first.alloc.resource() == &arena);
+  REQUIRE(p->second == 4);
+  alloc.delete_object(p);
+
+  using vector_pair = std::pair<pmr_vector<int>, int>;
+  gpcl::pmr::monotonic_buffer_resource other;
+  vector_pair v(pmr_vector<int>(2, 1, &other), 5);
+  auto *q = alloc.new_object<vector_pair>(v);
+  REQUIRE(q->first.get_allocator().resource() == &arena);
+  REQUIRE(q->first == v.first);
+  alloc.delete_object(q);
+
+  REQUIRE_THROWS_AS(alloc.new_object<throwing>(), std::runtime_error);
+}
+
+TEST_CASE("polymorphic_allocator allocate_bytes")
+{
+  gpcl::pmr::monotonic_buffer_resource arena;
+  gpcl::pmr::polymorphic_allocator<char> alloc(&arena);
+
+  void *p = alloc.allocate_bytes(100, 64);
+  REQUIRE(reinterpret_cast<std::uintptr_t>(p) % 64 == 0);
+  alloc.deallocate_bytes(p, 100, 64);
+
+  auto *d = alloc.allocate_object<double>(4);
+  REQUIRE(reinterpret_cast<std::uintptr_t>(d) % alignof(double) == 0);
+  alloc.deallocate_object(d, 4);
+
+  REQUIRE_THROWS_AS(alloc.allocate_object<double>(SIZE_MAX / 2),
+                    std::bad_array_new_length);
+}
+
+TEST_CASE("thread default resource")
+{
+  gpcl::pmr::memory_resource *global = gpcl::pmr::get_default_resource();
+  gpcl::pmr::monotonic_buffer_resource outer_arena, inner_arena;
+  REQUIRE(gpcl::pmr::get_thread_default_resource() == nullptr);
+
+  {
+    gpcl::pmr::scoped_default_resource outer(&outer_arena);
+    REQUIRE(gpcl::pmr::get_default_resource() == &outer_arena);
+    REQUIRE(gpcl::pmr::polymorphic_allocator<int>().resource() ==
+            &outer_arena);
+
+    {
+      gpcl::pmr::scoped_default_resource inner(&inner_arena);
+      REQUIRE(gpcl::pmr::get_default_resource() == &inner_arena);
+
+      // Other threads keep the process-wide default.
+      gpcl::pmr::memory_resource *seen = nullptr;
+      gpcl::thread t([&seen] { seen = gpcl::pmr::get_default_resource(); });
+      t.join();
+      REQUIRE(seen == global);
+    }
+    REQUIRE(gpcl::pmr::get_default_resource() == &outer_arena);
+
+    // The thread default takes precedence over the global one.
+    gpcl::pmr::set_default_resource(&inner_arena);
+    REQUIRE(gpcl::pmr::get_default_resource() == &outer_arena);
+    gpcl::pmr::set_default_resource(global);
+  }
+  REQUIRE(gpcl::pmr::get_thread_default_resource() == nullptr);
+  REQUIRE(gpcl::pmr::get_default_resource() == global);
+}
@@ -0,0 +1,256 @@
+#include <gpcl/pmr/mmap_resource.hpp>
+#include <gpcl/pmr/monotonic_buffer_resource.hpp>
+#include <gpcl/pmr/new_delete_resource.hpp>
+#include <gpcl/pmr/numa_resource.hpp>
+#include <gpcl/pmr/synchronized_pool_resource.hpp>
+#include <gpcl/pmr/unsynchronized_pool_resource.hpp>
+#include <gpcl/mutex.hpp>
+#include <gpcl/numa_pool.hpp>
+#include <gpcl/thread.hpp>
+#include <gpcl/unique_lock.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <vector>
+
+namespace {
+
+// Records the outstanding upstream allocations. Size classes of a
+// synchronized_pool_resource replenish concurrently, hence the mutex.
+class counting_resource : public gpcl::pmr::memory_resource
+{
+public:
+  std::size_t outstanding()
+  {
+    gpcl::unique_lock<gpcl::mutex> lock(mtx_);
+    return allocations_.size();
+  }
+
+private:
+  void *do_allocate(std::size_t bytes, std::size_t alignment) override
+  {
+    void *p = gpcl::pmr::new_delete_resource()->allocate(bytes, alignment);
+    gpcl::unique_lock<gpcl::mutex> lock(mtx_);
+    allocations_[p] = {bytes, alignment};
+    return p;
+  }
+
+  void do_deallocate(void *p, std::size_t bytes, std::size_t alignment) override
+  {
+    gpcl::unique_lock<gpcl::mutex> lock(mtx_);
+    auto it = allocations_.find(p);
+    REQUIRE(it != allocations_.end());
+    REQUIRE(it->second == std::make_pair(bytes, alignment));
+    allocations_.erase(it);
+    lock.unlock();
+    gpcl::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+  }
+
+  bool do_is_equal(const memory_resource &other) const noexcept override
+  {
+    return this == &other;
+  }
+
+  gpcl::mutex mtx_;
+  std::map<void *, std::pair<std::size_t, std::size_t>> allocations_;
+};
+
+bool is_aligned(void *p, std::size_t alignment)
+{
+  return reinterpret_cast<std::uintptr_t>(p) % alignment == 0;
+}
+
+} // namespace
+
+TEST_CASE("pool_options are normalized")
+{
+  gpcl::pmr::pool_options opts;
+  opts.max_blocks_per_chunk = 1 << 30;
+  opts.largest_required_pool_block = 1000;
+  gpcl::pmr::unsynchronized_pool_resource r(opts);
+
+  REQUIRE(r.options().max_blocks_per_chunk == 1 << 16);
+  REQUIRE(r.options().largest_required_pool_block == 1024);
+  REQUIRE(r.upstream_resource() == gpcl::pmr::get_default_resource());
+  REQUIRE(r.is_equal(r));
+}
+
+TEST_CASE("unsynchronized_pool_resource")
+{
+  counting_resource upstream;
+  gpcl::pmr::pool_options opts;
+  opts.max_blocks_per_chunk = 16;
+  opts.largest_required_pool_block = 256;
+  gpcl::pmr::unsynchronized_pool_resource r(opts, &upstream);
+
+  struct allocation
+  {
+    void *p;
+    std::size_t bytes;
+    std::size_t alignment;
+  };
+  std::vector<allocation> v;
+  for (std::size_t i = 1; i < 600; i += 7)
+  {
+    std::size_t alignment = std::size_t(1) << (i % 7);
+    void *p = r.allocate(i, alignment);
+    REQUIRE(is_aligned(p, alignment));
+    std::memset(p, int(i), i);
+    v.push_back({p, i, alignment});
+  }
+  for (auto &a : v)
+    REQUIRE(static_cast<unsigned char *>(a.p)[a.bytes - 1] ==
+            static_cast<unsigned char>(a.bytes));
+
+  // A freed block is reused for the next request of its size class.
+  r.deallocate(v[3].p, v[3].bytes, v[3].alignment);
+  REQUIRE(r.allocate(v[3].bytes, v[3].alignment) == v[3].p);
+
+  for (auto &a : v)
+    r.deallocate(a.p, a.bytes, a.alignment);
+  REQUIRE(upstream.outstanding() != 0);
+
+  void *big = r.allocate(10000, 8192);
+  REQUIRE(is_aligned(big, 8192));
+  r.release();
+  REQUIRE(upstream.outstanding() == 0);
+  REQUIRE(r.allocate(16) != nullptr);
+}
+
+TEST_CASE("synchronized_pool_resource multiple threads")
+{
+  counting_resource upstream;
+  std::atomic<int> errors{0};
+  {
+    gpcl::pmr::synchronized_pool_resource r(&upstream);
+
+    auto worker = [&r, &errors](std::size_t id) {
+      std::vector<std::pair<std::size_t *, std::size_t>> v;
+      for (int round = 0; round < 200; ++round)
+      {
+        for (std::size_t i = 0; i < 64; ++i)
+        {
+          std::size_t bytes = 8 + (i * 24) % 512;
+          auto *p = static_cast<std::size_t *>(r.allocate(bytes));
+          p[0] = id;
+          v.emplace_back(p, bytes);
+        }
+        for (auto [p, bytes] : v)
+        {
+          if (p[0] != id)
+            ++errors;
+          r.deallocate(p, bytes);
+        }
+        v.clear();
+      }
+    };
+
+    {
+      gpcl::thread t1(worker, 1);
+      gpcl::thread t2(worker, 2);
+      gpcl::thread t3(worker, 3);
+      gpcl::thread t4(worker, 4);
+      gpcl::join_all(t1, t2, t3, t4);
+    }
+    REQUIRE(errors == 0);
+
+    // Blocks freed by exited threads are reused.
+    void *p = r.allocate(8);
+    REQUIRE(p != nullptr);
+    r.deallocate(p, 8);
+  }
+  REQUIRE(upstream.outstanding() == 0);
+}
+
+TEST_CASE("mmap_resource")
+{
+  gpcl::pmr::mmap_resource_options opts;
+  opts.max_cached_bytes = std::size_t(4) << 20;
+  gpcl::pmr::mmap_resource r(opts);
+
+  void *p = r.allocate(100, 8192);
+  REQUIRE(reinterpret_cast<std::uintptr_t>(p) % 8192 == 0);
+  std::memset(p, 0xab, 100);
+  r.deallocate(p, 100, 8192);
+  REQUIRE(r.cached_bytes() == r.mapping_size(100));
+
+  // The cached mapping is reused, and reads as zero again.
+  void *q = r.allocate(100, 4096);
+  REQUIRE(q == p);
+  REQUIRE(static_cast<unsigned char *>(q)[0] == 0);
+  REQUIRE(r.cached_bytes() == 0);
+  r.deallocate(q, 100, 4096);
+  r.trim();
+  REQUIRE(r.cached_bytes() == 0);
+
+  SECTION("as upstream")
+  {
+    gpcl::pmr::mmap_resource_options huge;
+    huge.huge_pages = gpcl::pmr::huge_page_mode::explicit_pages;
+    huge.populate = true;
+    gpcl::pmr::mmap_resource mapped(huge);
+    REQUIRE(mapped.mapping_size(1) == huge.huge_page_size);
+
+    gpcl::pmr::monotonic_buffer_resource arena(std::size_t(1) << 20,
+                                               &mapped);
+    auto *c = static_cast<char *>(arena.allocate(3 << 20));
+    c[(3 << 20) - 1] = 1;
+
+    gpcl::pmr::unsynchronized_pool_resource pool(&mapped);
+    std::vector<void *> blocks;
+    for (int i = 0; i < 1000; ++i)
+      blocks.push_back(pool.allocate(64));
+    for (void *b : blocks)
+      pool.deallocate(b, 64);
+  }
+}
+
+TEST_CASE("numa_resource")
+{
+  using gpcl::pmr::numa_resource;
+  int nodes = numa_resource::node_count();
+  REQUIRE(nodes >= 1);
+  REQUIRE(numa_resource::current_node() >= 0);
+
+  for (int node = 0; node < nodes; ++node)
+  {
+    gpcl::pmr::mmap_resource_options opts;
+    opts.populate = true;
+    numa_resource r(node, gpcl::pmr::numa_policy::bind, opts);
+
+    // With one node, or without NUMA system calls, memory is mapped as by
+    // mmap_resource.
+    if (nodes == 1)
+      REQUIRE_FALSE(r.binding());
+
+    auto *p = static_cast<char *>(r.allocate(1 << 16));
+    p[0] = 1;
+    int actual = numa_resource::node_of(p);
+    if (r.binding())
+      REQUIRE(actual == node);
+    else
+      REQUIRE(actual <= 0);
+    r.deallocate(p, 1 << 16);
+  }
+
+  numa_resource local;
+  auto *p = static_cast<char *>(local.allocate(100));
+  p[99] = 1;
+  local.deallocate(p, 100);
+
+  struct numa_tag
+  {
+  };
+  using pool0 = gpcl::numa_singleton_pool<numa_tag, 48, 0>;
+  std::vector<void *> chunks;
+  for (int i = 0; i < 100; ++i)
+  {
+    chunks.push_back(pool0::malloc());
+    std::memset(chunks.back(), i, 48);
+  }
+  for (void *c : chunks)
+    pool0::free(c);
+  REQUIRE(pool0::purge_memory());
+}
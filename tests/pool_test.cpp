@@ -0,0 +1,394 @@
+#include <gpcl/bitmap_segregated_storage.hpp>
+#include <gpcl/lockfree_singleton_pool.hpp>
+#include <gpcl/object_pool.hpp>
+#include <gpcl/pool.hpp>
+#include <gpcl/pool_allocator.hpp>
+#include <gpcl/pool_statistics.hpp>
+#include <gpcl/thread.hpp>
+#include <gpcl/thread_cached_pool.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <atomic>
+#include <cstring>
+#include <list>
+#include <set>
+#include <string>
+#include <vector>
+
+TEST_CASE("pool malloc_batch and free_batch")
+{
+  gpcl::pool<> p(sizeof(int));
+
+  void *first = nullptr;
+  auto n = p.malloc_batch(8, first);
+  REQUIRE(n == 8);
+
+  std::set<void *> chunks;
+  void *last = first;
+  for (void *c = first; c; c = *static_cast<void **>(c))
+  {
+    REQUIRE(chunks.insert(c).second);
+    last = c;
+  }
+  REQUIRE(chunks.size() == n);
+
+  p.free_batch(first, last);
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    void *c = p.malloc();
+    REQUIRE(chunks.count(c) == 1);
+  }
+}
+
+TEST_CASE("thread_cached_pool single thread")
+{
+  gpcl::thread_cached_pool<> p(64, 4, 8);
+
+  std::vector<void *> v;
+  for (int i = 0; i < 100; ++i)
+  {
+    void *c = p.malloc();
+    REQUIRE(c != nullptr);
+    std::memset(c, i, 64);
+    v.push_back(c);
+  }
+  REQUIRE(std::set<void *>(v.begin(), v.end()).size() == v.size());
+
+  for (void *c : v)
+    p.free(c);
+
+  // A chunk freed by this thread is handed out again first.
+  void *c = p.malloc();
+  REQUIRE(c == v.back());
+  p.free(c);
+  p.flush();
+}
+
+TEST_CASE("thread_cached_pool multiple threads")
+{
+  gpcl::thread_cached_pool<> p(sizeof(void *) * 2, 16, 64);
+  std::atomic<int> errors{0};
+
+  auto worker = [&p, &errors] {
+    std::vector<void *> v;
+    for (int round = 0; round < 100; ++round)
+    {
+      for (int i = 0; i < 50; ++i)
+      {
+        auto *c = static_cast<std::size_t *>(p.malloc());
+        if (!c)
+        {
+          ++errors;
+          return;
+        }
+        c[1] = reinterpret_cast<std::size_t>(&v);
+        v.push_back(c);
+      }
+      for (void *c : v)
+      {
+        if (static_cast<std::size_t *>(c)[1] !=
+            reinterpret_cast<std::size_t>(&v))
+          ++errors;
+        p.free(c);
+      }
+      v.clear();
+    }
+  };
+
+  {
+    gpcl::thread t1(worker);
+    gpcl::thread t2(worker);
+    gpcl::thread t3(worker);
+    gpcl::join_all(t1, t2, t3);
+  }
+  REQUIRE(errors == 0);
+
+  // The exited threads have returned their caches to the pool.
+  void *first = nullptr;
+  REQUIRE(p.underlying_pool().malloc_batch(1000, first) >= 50);
+}
+
+TEST_CASE("lockfree_singleton_pool multiple threads")
+{
+  using pool_type =
+      gpcl::lockfree_singleton_pool<struct lockfree_test_tag, 16>;
+  REQUIRE(pool_type::is_lock_free());
+  std::atomic<int> errors{0};
+
+  auto worker = [&errors](std::size_t id) {
+    std::vector<std::size_t *> v;
+    for (int round = 0; round < 1000; ++round)
+    {
+      for (int i = 0; i < 20; ++i)
+      {
+        auto *c = static_cast<std::size_t *>(pool_type::malloc());
+        c[1] = id;
+        v.push_back(c);
+      }
+      for (auto *c : v)
+      {
+        if (c[1] != id)
+          ++errors;
+        pool_type::free(c);
+      }
+      v.clear();
+    }
+  };
+
+  {
+    gpcl::thread t1(worker, 1);
+    gpcl::thread t2(worker, 2);
+    gpcl::thread t3(worker, 3);
+    gpcl::thread t4(worker, 4);
+    gpcl::join_all(t1, t2, t3, t4);
+  }
+  REQUIRE(errors == 0);
+}
+
+TEST_CASE("pool_allocator with lockfree_singleton_pool")
+{
+  using allocator_type =
+      gpcl::pool_allocator<int, gpcl::lockfree_singleton_pool>;
+
+  std::list<int, allocator_type> l;
+  std::vector<int, allocator_type> v;
+  for (int i = 0; i < 1000; ++i)
+  {
+    l.push_back(i);
+    v.push_back(i);
+  }
+
+  int i = 0;
+  for (int x : l)
+    REQUIRE(x == i++);
+  REQUIRE(v.size() == 1000);
+  REQUIRE(v[999] == 999);
+}
+
+TEST_CASE("bitmap_segregated_storage malloc_n across words")
+{
+  alignas(std::max_align_t) static char block[4096];
+  gpcl::bitmap_segregated_storage<> s;
+  s.add_block(block, sizeof block, 16);
+
+  std::vector<char *> v;
+  while (!s.empty())
+    v.push_back(static_cast<char *>(s.malloc(16)));
+  REQUIRE(v.size() > 128);
+  for (std::size_t i = 1; i < v.size(); ++i)
+    REQUIRE(v[i] == v[i - 1] + 16);
+  REQUIRE(s.malloc_n(1, 16) == nullptr);
+
+  // Free [60, 140) except 100; the longest runs are [60, 100) and
+  // [101, 140).
+  for (std::size_t i = 60; i < 140; ++i)
+    if (i != 100)
+      s.ordered_free(v[i]);
+  REQUIRE(s.malloc_n(41, 16) == nullptr);
+  REQUIRE(s.malloc_n(39, 16) == v[60]);
+  REQUIRE(s.malloc_n(39, 16) == v[101]);
+  REQUIRE(s.malloc_n(1, 16) == v[99]);
+  REQUIRE(s.empty());
+
+  s.ordered_free_n(v[60], 39, 16);
+  s.free(v[99]);
+  s.free(v[100]);
+  REQUIRE(s.malloc_n(41, 16) == v[60]);
+
+  s.free_n(v[3], 16, 70);
+  REQUIRE(s.malloc(16) == v[3]);
+}
+
+TEST_CASE("pool with bitmap_segregated_storage")
+{
+  using pool_type =
+      gpcl::pool<gpcl::default_malloc_free_user_allocator, gpcl::mutex,
+                 gpcl::bitmap_segregated_storage<>>;
+  pool_type p(24);
+
+  std::vector<void *> singles;
+  std::vector<std::pair<char *, std::size_t>> arrays;
+  for (std::size_t i = 0; i < 2000; ++i)
+  {
+    singles.push_back(p.malloc());
+    REQUIRE(singles.back() != nullptr);
+    std::size_t n = i % 7 + 1;
+    auto *a = static_cast<char *>(p.ordered_malloc(n));
+    REQUIRE(a != nullptr);
+    std::memset(a, int(i), n * 24);
+    arrays.emplace_back(a, n);
+  }
+
+  for (std::size_t i = 0; i < arrays.size(); ++i)
+  {
+    auto [a, n] = arrays[i];
+    for (std::size_t j = 0; j < n * 24; ++j)
+      REQUIRE(a[j] == char(i));
+  }
+
+  for (std::size_t i = 0; i < singles.size(); i += 2)
+    p.ordered_free(singles[i]);
+  for (auto [a, n] : arrays)
+    p.ordered_free(a, n);
+
+  // The freed arrays coalesce into runs.
+  REQUIRE(p.ordered_malloc(32) != nullptr);
+
+  void *first = nullptr;
+  REQUIRE(p.malloc_batch(16, first) == 16);
+}
+
+template <typename Pool>
+static void check_release_memory()
+{
+  Pool p(64, 8, 32);
+
+  std::vector<void *> v;
+  for (int i = 0; i < 1000; ++i)
+    v.push_back(p.ordered_malloc());
+  REQUIRE(p.get_next_size() == 32);
+
+  // Every block still holds a live chunk.
+  for (std::size_t i = 0; i < v.size(); ++i)
+    if (i % 8 != 0)
+      p.ordered_free(v[i]);
+  REQUIRE_FALSE(p.release_memory());
+
+  for (std::size_t i = 0; i < v.size(); i += 8)
+    p.ordered_free(v[i]);
+  REQUIRE(p.release_memory());
+  REQUIRE_FALSE(p.release_memory());
+
+  void *c = p.malloc();
+  REQUIRE(c != nullptr);
+  std::memset(c, 0, 64);
+  p.free(c);
+
+  REQUIRE(p.purge_memory());
+  REQUIRE_FALSE(p.purge_memory());
+  REQUIRE(p.get_next_size() == 8);
+  REQUIRE(p.ordered_malloc(4) != nullptr);
+}
+
+TEST_CASE("pool release_memory and purge_memory")
+{
+  check_release_memory<gpcl::pool<>>();
+  check_release_memory<
+      gpcl::pool<gpcl::default_new_delete_user_allocator, gpcl::mutex,
+                 gpcl::bitmap_segregated_storage<>>>();
+}
+
+TEST_CASE("pool statistics")
+{
+  using pool_type =
+      gpcl::pool<gpcl::default_malloc_free_user_allocator, gpcl::mutex,
+                 gpcl::simple_segregated_storage<>, gpcl::pool_statistics>;
+  pool_type p(32, 16);
+  auto &stats = p.statistics();
+
+  std::size_t traced = 0;
+  stats.set_trace_hook(
+      [](void *context, const gpcl::allocation_event &event) {
+        REQUIRE(event.ptr != nullptr);
+        REQUIRE(event.bytes % 32 == 0);
+        ++*static_cast<std::size_t *>(context);
+      },
+      &traced, 4);
+
+  std::vector<void *> v;
+  for (int i = 0; i < 40; ++i)
+    v.push_back(p.malloc());
+  void *array = p.ordered_malloc(10);
+  REQUIRE(stats.live_chunks() == 50);
+  REQUIRE(stats.blocks() >= 2);
+  REQUIRE(stats.bytes_reserved() >= 50 * 32);
+
+  for (void *c : v)
+    p.free(c);
+  p.ordered_free(array, 10);
+  REQUIRE(stats.live_chunks() == 0);
+  REQUIRE(stats.peak_live_chunks() == 50);
+  REQUIRE(traced == 21);
+
+  stats.reset_peak();
+  REQUIRE(stats.peak_live_chunks() == 0);
+
+  p.purge_memory();
+  REQUIRE(stats.blocks() == 0);
+  REQUIRE(stats.bytes_reserved() == 0);
+}
+
+TEST_CASE("pool max_size caps the block size")
+{
+  using pool_type =
+      gpcl::pool<gpcl::default_new_delete_user_allocator, gpcl::mutex,
+                 gpcl::simple_segregated_storage<>, gpcl::pool_statistics>;
+
+  // Every block has max_size chunks, starting with the first one.
+  pool_type p(16, 32, 8);
+  REQUIRE(p.get_next_size() == 8);
+  auto &stats = p.statistics();
+  std::vector<void *> v;
+  for (int i = 0; i < 100; ++i)
+  {
+    v.push_back(p.malloc());
+    REQUIRE(stats.bytes_reserved() == stats.blocks() * 8 * 16);
+  }
+  REQUIRE(stats.blocks() > 1);
+  REQUIRE(p.get_next_size() == 8);
+  for (void *c : v)
+    p.free(c);
+
+  // An array that does not fit in a capped block still gets one.
+  REQUIRE(p.ordered_malloc(20) != nullptr);
+  REQUIRE(p.get_next_size() == 8);
+
+  // Lowering the cap applies to the next block.
+  pool_type q(16, 8);
+  q.set_max_size(4);
+  REQUIRE(q.get_next_size() == 4);
+  q.set_next_size(16);
+  REQUIRE(q.get_next_size() == 4);
+  REQUIRE(q.malloc() != nullptr);
+  REQUIRE(q.statistics().bytes_reserved() == 4 * 16);
+  q.set_max_size(0);
+  q.set_next_size(16);
+  REQUIRE(q.get_next_size() == 16);
+}
+
+TEST_CASE("pool statistics count contention")
+{
+  using pool_type =
+      gpcl::singleton_pool<struct statistics_test_tag, 16,
+                           gpcl::default_malloc_free_user_allocator,
+                           gpcl::pool_statistics>;
+
+  auto worker = [] {
+    for (int i = 0; i < 20000; ++i)
+      pool_type::free(pool_type::malloc());
+  };
+  {
+    gpcl::thread t1(worker);
+    gpcl::thread t2(worker);
+    gpcl::thread t3(worker);
+    gpcl::join_all(t1, t2, t3);
+  }
+
+  auto &stats = pool_type::statistics();
+  REQUIRE(stats.live_chunks() == 0);
+  REQUIRE(stats.peak_live_chunks() >= 1);
+  REQUIRE(stats.peak_live_chunks() <= 3);
+  if (stats.contentions() == 0)
+    REQUIRE(stats.contention_wait().is_zero());
+}
+
+TEST_CASE("object_pool statistics")
+{
+  gpcl::object_pool<std::string, gpcl::default_new_delete_user_allocator,
+                    gpcl::mutex, gpcl::pool_statistics>
+      p;
+  auto *s = p.construct("hello");
+  REQUIRE(*s == "hello");
+  REQUIRE(p.statistics().live_chunks() == 1);
+  p.destroy(s);
+  REQUIRE(p.statistics().live_chunks() == 0);
+}
@@ -0,0 +1,148 @@
+#include <gpcl/big_reader_lock.hpp>
+#include <gpcl/shared_lock.hpp>
+#include <gpcl/shared_mutex.hpp>
+#include <gpcl/thread.hpp>
+#include <gpcl/unique_lock.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <atomic>
+#include <chrono>
+#include <vector>
+
+namespace {
+
+// Readers check that the two halves of a pair are equal while writers
+// change both; a torn read means a writer was not excluded.
+template <typename SharedMutex>
+void check_readers_and_writers(SharedMutex &m)
+{
+  constexpr int readers = 6;
+  constexpr int writers = 2;
+  constexpr int count = 5000;
+  long a = 0, b = 0;
+  std::atomic<int> torn{0};
+  std::vector<gpcl::thread> ts;
+  for (int i = 0; i < readers; ++i)
+  {
+    ts.emplace_back([&] {
+      for (int j = 0; j < count; ++j)
+      {
+        gpcl::shared_lock<SharedMutex> lock(m);
+        if (a != b)
+          ++torn;
+      }
+    });
+  }
+  for (int i = 0; i < writers; ++i)
+  {
+    ts.emplace_back([&] {
+      for (int j = 0; j < count; ++j)
+      {
+        gpcl::unique_lock<SharedMutex> lock(m);
+        ++a;
+        ++b;
+      }
+    });
+  }
+  for (gpcl::thread &t : ts)
+    t.join();
+  REQUIRE(torn == 0);
+  REQUIRE(a == long(writers) * count);
+  REQUIRE(b == a);
+}
+
+} // namespace
+
+TEST_CASE("shared_mutex shared and exclusive ownership")
+{
+  gpcl::shared_mutex m;
+
+  m.lock_shared();
+  bool other_shared = false;
+  bool other_exclusive = true;
+  gpcl::thread t1([&] {
+    other_shared = m.try_lock_shared();
+    if (other_shared)
+      m.unlock_shared();
+    other_exclusive = m.try_lock();
+  });
+  t1.join();
+  m.unlock_shared();
+  REQUIRE(other_shared);
+  REQUIRE_FALSE(other_exclusive);
+
+  m.lock();
+  gpcl::thread t2([&] { other_shared = m.try_lock_shared(); });
+  t2.join();
+  m.unlock();
+  REQUIRE_FALSE(other_shared);
+
+  check_readers_and_writers(m);
+}
+
+TEST_CASE("shared_timed_mutex times out")
+{
+  using namespace std::chrono_literals;
+  gpcl::shared_timed_mutex m;
+
+  m.lock();
+  bool shared = true;
+  bool exclusive = true;
+  gpcl::thread t([&] {
+    shared = m.try_lock_shared_for(20ms);
+    exclusive = m.try_lock_for(20ms);
+  });
+  t.join();
+  REQUIRE_FALSE(shared);
+  REQUIRE_FALSE(exclusive);
+  m.unlock();
+
+  REQUIRE(m.try_lock_shared_for(20ms));
+  REQUIRE(m.try_lock_shared_for(20ms));
+  m.unlock_shared();
+  m.unlock_shared();
+  REQUIRE(m.try_lock_for(20ms));
+  m.unlock();
+
+  check_readers_and_writers(m);
+}
+
+TEST_CASE("shared_lock ownership")
+{
+  gpcl::shared_mutex m;
+  {
+    gpcl::shared_lock<gpcl::shared_mutex> lock(m, gpcl::defer_lock);
+    REQUIRE_FALSE(lock.owns_lock());
+    REQUIRE(lock.try_lock());
+    gpcl::shared_lock<gpcl::shared_mutex> moved(std::move(lock));
+    REQUIRE_FALSE(lock.owns_lock());
+    REQUIRE(moved.owns_lock());
+    REQUIRE(&moved.mutex() == &m);
+  }
+  REQUIRE(m.try_lock());
+  m.unlock();
+}
+
+TEST_CASE("big_reader_lock excludes writers")
+{
+  gpcl::big_reader_lock m;
+  REQUIRE(m.slots() >= 1);
+
+  m.lock_shared();
+  REQUIRE_FALSE(m.try_lock());
+  REQUIRE(m.try_lock_shared());
+  m.unlock_shared();
+  m.unlock_shared();
+
+  m.lock();
+  bool other_shared = true;
+  gpcl::thread t([&] { other_shared = m.try_lock_shared(); });
+  t.join();
+  REQUIRE_FALSE(other_shared);
+  m.unlock();
+
+  check_readers_and_writers(m);
+
+  // Fewer counters than threads makes readers share them.
+  gpcl::big_reader_lock shared_slots(1);
+  check_readers_and_writers(shared_slots);
+}
@@ -0,0 +1,190 @@
+#include <gpcl/shm_mpsc_channel.hpp>
+#include <gpcl/thread.hpp>
+#include "shm_name.hpp"
+#include <catch2/catch_test_macros.hpp>
+#include <cstring>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+struct channel_name : shm_name
+{
+  channel_name()
+      : shm_name("/gpcl_channel_test_", &gpcl::shm_mpsc_channel::remove)
+  {
+  }
+};
+
+struct record
+{
+  unsigned producer;
+  unsigned seq;
+};
+
+} // namespace
+
+TEST_CASE("shm_mpsc_channel reserve and peek")
+{
+  channel_name name;
+  gpcl::shm_mpsc_channel channel(gpcl::create_only, name.c_str(), 256);
+  REQUIRE(channel.capacity() == 256);
+  REQUIRE(channel.try_peek().data() == nullptr);
+
+  // Enough messages for the positions to wrap around many times.
+  for (unsigned i = 0; i < 1000; ++i)
+  {
+    std::size_t size = i % 53;
+    gpcl::mutable_buffer buf = channel.try_reserve(size + 10);
+    REQUIRE(buf.data() != nullptr);
+    REQUIRE(buf.size() == size + 10);
+    std::memset(buf.data(), static_cast<int>(i & 0xff), size);
+    channel.commit(size);
+
+    gpcl::const_buffer msg = channel.try_peek();
+    REQUIRE(msg.data() != nullptr);
+    REQUIRE(msg.size() == size);
+    REQUIRE(std::string(msg.data(), size) ==
+            std::string(size, static_cast<char>(i)));
+    channel.release();
+  }
+  REQUIRE(channel.try_peek().data() == nullptr);
+
+  REQUIRE_THROWS_AS(channel.try_reserve(channel.max_msg_size() + 1),
+                    std::system_error);
+
+  // Fill the channel.
+  std::size_t count = 0;
+  for (;;)
+  {
+    gpcl::mutable_buffer buf = channel.try_reserve(24);
+    if (!buf.data())
+      break;
+    channel.commit(buf.size());
+    ++count;
+  }
+  REQUIRE(count > 1);
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    REQUIRE(channel.peek().size() == 24);
+    channel.release();
+  }
+}
+
+TEST_CASE("shm_mpsc_channel out of order commit")
+{
+  channel_name name;
+  gpcl::shm_mpsc_channel consumer(gpcl::create_only, name.c_str(), 256);
+  gpcl::shm_mpsc_channel first(gpcl::open_only, name.c_str());
+  gpcl::shm_mpsc_channel second(gpcl::open_only, name.c_str());
+
+  gpcl::mutable_buffer a = first.try_reserve(1);
+  gpcl::mutable_buffer b = second.try_reserve(1);
+  a[0] = 'a';
+  b[0] = 'b';
+
+  // The first reserved message holds back the second.
+  second.commit(1);
+  REQUIRE(consumer.try_peek().data() == nullptr);
+
+  first.commit(1);
+  REQUIRE(consumer.try_peek()[0] == 'a');
+  consumer.release();
+  REQUIRE(consumer.try_peek()[0] == 'b');
+  consumer.release();
+  REQUIRE(consumer.try_peek().data() == nullptr);
+}
+
+TEST_CASE("shm_mpsc_channel producers racing a draining consumer")
+{
+  // A producer's view of the write position may be overtaken by the
+  // consumer before it looks at the read position. That must not make it
+  // see a full channel and sleep on an empty one.
+  channel_name name;
+  gpcl::shm_mpsc_channel channel(gpcl::create_only, name.c_str(), 256);
+  constexpr unsigned producers = 4;
+  constexpr unsigned count = 20000;
+
+  std::vector<gpcl::thread> threads;
+  for (unsigned p = 0; p < producers; ++p)
+  {
+    threads.emplace_back([&name, p] {
+      gpcl::shm_mpsc_channel producer(gpcl::open_only, name.c_str());
+      for (unsigned i = 0; i < count; ++i)
+      {
+        gpcl::mutable_buffer buf = producer.reserve(sizeof(record));
+        record r{p, i};
+        std::memcpy(buf.data(), &r, sizeof r);
+        producer.commit(sizeof r);
+      }
+    });
+  }
+
+  std::vector<unsigned> next(producers);
+  bool ok = true;
+  for (unsigned i = 0; i < producers * count; ++i)
+  {
+    gpcl::const_buffer msg = channel.peek();
+    record r;
+    std::memcpy(&r, msg.data(), sizeof r);
+    ok = ok && r.producer < producers && r.seq == next[r.producer]++;
+    channel.release();
+  }
+  for (gpcl::thread &t : threads)
+    t.join();
+  REQUIRE(ok);
+  REQUIRE(channel.try_peek().data() == nullptr);
+}
+
+TEST_CASE("shm_mpsc_channel between processes")
+{
+  channel_name name;
+  gpcl::shm_mpsc_channel channel(gpcl::create_only, name.c_str(), 1024);
+  constexpr unsigned producers = 3;
+  constexpr unsigned count = 50000;
+
+  std::vector<pid_t> pids;
+  for (unsigned p = 0; p < producers; ++p)
+  {
+    pid_t pid = ::fork();
+    REQUIRE(pid != -1);
+    if (pid == 0)
+    {
+      gpcl::shm_mpsc_channel producer(gpcl::open_only, name.c_str());
+      for (unsigned i = 0; i < count; ++i)
+      {
+        gpcl::mutable_buffer buf = producer.reserve(sizeof(record));
+        record r{p, i};
+        std::memcpy(buf.data(), &r, sizeof r);
+        producer.commit(sizeof r);
+      }
+      ::_exit(0);
+    }
+    pids.push_back(pid);
+  }
+
+  // Messages of every producer arrive in order.
+  std::vector<unsigned> next(producers);
+  bool ok = true;
+  for (unsigned i = 0; i < producers * count; ++i)
+  {
+    gpcl::const_buffer msg = channel.peek();
+    record r;
+    ok = ok && msg.size() == sizeof r;
+    std::memcpy(&r, msg.data(), sizeof r);
+    ok = ok && r.producer < producers && r.seq == next[r.producer]++;
+    channel.release();
+  }
+  REQUIRE(ok);
+  REQUIRE(channel.try_peek().data() == nullptr);
+
+  for (pid_t pid : pids)
+  {
+    int status = 0;
+    REQUIRE(::waitpid(pid, &status, 0) == pid);
+    REQUIRE(WIFEXITED(status));
+    REQUIRE(WEXITSTATUS(status) == 0);
+  }
+}
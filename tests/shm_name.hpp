@@ -0,0 +1,41 @@
+#ifndef GPCL_TESTS_SHM_NAME_HPP
+#define GPCL_TESTS_SHM_NAME_HPP
+
+#include <gpcl/zstring.hpp>
+#include <string>
+#include <system_error>
+#include <unistd.h>
+
+// A name for a shared memory object or message queue, made unique to the
+// test process by appending its pid to prefix. Whatever the name refers to
+// is removed before and after the test.
+class shm_name
+{
+public:
+  using remove_function = void (*)(gpcl::czstring<>, std::error_code &);
+
+  shm_name(const char *prefix, remove_function remove)
+      : value_(prefix + std::to_string(::getpid())), remove_(remove)
+  {
+    remove_object();
+  }
+
+  ~shm_name() { remove_object(); }
+
+  shm_name(const shm_name &) = delete;
+  shm_name &operator=(const shm_name &) = delete;
+
+  const char *c_str() const { return value_.c_str(); }
+
+private:
+  void remove_object()
+  {
+    std::error_code ec;
+    remove_(value_.c_str(), ec);
+  }
+
+  std::string value_;
+  remove_function remove_;
+};
+
+#endif // GPCL_TESTS_SHM_NAME_HPP
@@ -0,0 +1,111 @@
+#include <gpcl/shm_spsc_ring.hpp>
+#include "shm_name.hpp"
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+struct ring_name : shm_name
+{
+  ring_name() : shm_name("/gpcl_ring_test_", &gpcl::shm_spsc_ring::remove) {}
+};
+
+// Message i has size i % 61 and consists of the byte i.
+std::vector<char> make_message(std::size_t i)
+{
+  return std::vector<char>(i % 61, static_cast<char>(i));
+}
+
+} // namespace
+
+TEST_CASE("shm_spsc_ring send and receive")
+{
+  ring_name name;
+  gpcl::shm_spsc_ring ring(gpcl::create_only, name.c_str(), 200);
+  REQUIRE(ring.capacity() == 256);
+  REQUIRE(ring.max_msg_size() == 120);
+
+  char buf[128];
+  std::size_t len = 0;
+  REQUIRE_FALSE(ring.try_receive(buf, len));
+
+  // Enough messages for the positions to wrap around many times.
+  for (std::size_t i = 0; i < 1000; ++i)
+  {
+    std::vector<char> msg = make_message(i);
+    REQUIRE(ring.try_send(msg));
+    REQUIRE(ring.try_receive(buf, len));
+    REQUIRE(len == msg.size());
+    REQUIRE(std::equal(msg.begin(), msg.end(), buf));
+  }
+  REQUIRE_FALSE(ring.try_receive(buf, len));
+
+  std::vector<char> big(ring.max_msg_size() + 1);
+  REQUIRE_THROWS_AS(ring.send(big), std::system_error);
+
+  // A message is kept in the ring if the buffer is too small for it.
+  ring.send(gpcl::span<const char>("hello", 5));
+  REQUIRE_THROWS_AS(ring.receive(gpcl::span<char>(buf, 4)), std::system_error);
+  REQUIRE(ring.receive(buf) == 5);
+  REQUIRE(std::memcmp(buf, "hello", 5) == 0);
+}
+
+TEST_CASE("shm_spsc_ring batch commit")
+{
+  ring_name name;
+  gpcl::shm_spsc_ring producer(gpcl::create_only, name.c_str(), 256);
+  gpcl::shm_spsc_ring consumer(gpcl::open_only, name.c_str());
+
+  char buf[128];
+  std::size_t len = 0;
+  std::size_t written = 0;
+  while (producer.try_write(make_message(written + 1)))
+    ++written;
+  REQUIRE(written > 1);
+  REQUIRE_FALSE(consumer.try_receive(buf, len));
+
+  producer.commit();
+  for (std::size_t i = 0; i < written; ++i)
+  {
+    REQUIRE(consumer.try_receive(buf, len));
+    REQUIRE(len == make_message(i + 1).size());
+  }
+  REQUIRE_FALSE(consumer.try_receive(buf, len));
+}
+
+TEST_CASE("shm_spsc_ring between processes")
+{
+  ring_name name;
+  gpcl::shm_spsc_ring ring(gpcl::create_only, name.c_str(), 512);
+  constexpr std::size_t count = 100000;
+
+  pid_t pid = ::fork();
+  REQUIRE(pid != -1);
+  if (pid == 0)
+  {
+    gpcl::shm_spsc_ring producer(gpcl::open_only, name.c_str());
+    for (std::size_t i = 0; i < count; ++i)
+      producer.send(make_message(i));
+    ::_exit(0);
+  }
+
+  char buf[128];
+  bool ok = true;
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    std::vector<char> msg = make_message(i);
+    std::size_t len = ring.receive(buf);
+    ok = ok && len == msg.size() && std::equal(msg.begin(), msg.end(), buf);
+  }
+  REQUIRE(ok);
+
+  int status = 0;
+  REQUIRE(::waitpid(pid, &status, 0) == pid);
+  REQUIRE(WIFEXITED(status));
+  REQUIRE(WEXITSTATUS(status) == 0);
+}
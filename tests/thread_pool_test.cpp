@@ -0,0 +1,79 @@
+#include <gpcl/thread_pool.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+namespace {
+
+long fib(gpcl::thread_pool &pool, int n, std::atomic<long> &sum)
+{
+  if (n < 2)
+  {
+    sum += n;
+    return n;
+  }
+  pool.post([&pool, n, &sum] { fib(pool, n - 1, sum); });
+  pool.post([&pool, n, &sum] { fib(pool, n - 2, sum); });
+  return 0;
+}
+
+} // namespace
+
+TEST_CASE("thread_pool runs posted tasks")
+{
+  gpcl::thread_pool pool(4);
+  REQUIRE(pool.size() == 4);
+
+  std::atomic<int> count{0};
+  for (int i = 0; i < 10000; ++i)
+    pool.post([&count] { ++count; });
+  pool.wait_idle();
+  REQUIRE(count == 10000);
+
+  // A callable too large for a task node is stored on the heap.
+  std::array<long, 64> values{};
+  values.fill(1);
+  std::atomic<long> total{0};
+  for (int i = 0; i < 100; ++i)
+  {
+    pool.post([values, &total] {
+      for (long v : values)
+        total += v;
+    });
+  }
+  pool.wait_idle();
+  REQUIRE(total == 6400);
+}
+
+TEST_CASE("thread_pool runs tasks posted from tasks")
+{
+  gpcl::thread_pool pool(3);
+  std::atomic<long> sum{0};
+  pool.post([&] { fib(pool, 20, sum); });
+  pool.wait_idle();
+  REQUIRE(sum == 6765);
+}
+
+TEST_CASE("thread_pool shutdown runs queued tasks")
+{
+  std::atomic<int> count{0};
+  {
+    gpcl::thread_attributes attr;
+    attr.stack_size(256 * 1024);
+    gpcl::thread_pool pool(2, attr);
+    for (int i = 0; i < 1000; ++i)
+    {
+      pool.post([&pool, &count] {
+        pool.post([&count] { ++count; });
+        ++count;
+      });
+    }
+  }
+  REQUIRE(count == 2000);
+
+  gpcl::thread_pool pool;
+  REQUIRE(pool.size() >= 1);
+  pool.shutdown();
+  pool.shutdown();
+}
@@ -7,3 +7,22 @@ TEST_CASE("test duration")
   CHECK_THROWS(gpcl::duration::max.checked_add(gpcl::duration::second));
 }
 #endif
+
+TEST_CASE("instant deadlines")
+{
+  gpcl::instant now = gpcl::instant::now();
+  gpcl::instant deadline = now.checked_add(gpcl::duration::second);
+  CHECK(deadline > now);
+  CHECK(deadline.saturating_duration_since(now) == gpcl::duration::second);
+  CHECK(now.saturating_add(gpcl::duration::max).duration_since_startup() ==
+        gpcl::duration::max);
+}
+
+TEST_CASE("duration units")
+{
+  gpcl::duration d = gpcl::duration::from_micros(1'234'567);
+  CHECK(d.as_secs() == 1);
+  CHECK(d.subsec_nanos() == 234'567'000);
+  CHECK(d.subsec_micros() == 234'567);
+  CHECK(d.subsec_millis() == 234);
+}
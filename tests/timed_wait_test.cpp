@@ -0,0 +1,106 @@
+#include <gpcl/condition_variable.hpp>
+#include <gpcl/event.hpp>
+#include <gpcl/mutex.hpp>
+#include <gpcl/semaphore.hpp>
+#include <gpcl/thread.hpp>
+#include <gpcl/time.hpp>
+#include <gpcl/unique_lock.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+
+namespace {
+
+const gpcl::duration timeout = gpcl::duration::from_millis(20);
+
+} // namespace
+
+TEST_CASE("condition_variable waits until the deadline")
+{
+  gpcl::mutex m;
+  gpcl::condition_variable cv;
+  gpcl::unique_lock<gpcl::mutex> lock(m);
+
+  gpcl::instant start = gpcl::instant::now();
+  REQUIRE(cv.wait_until(lock, start.saturating_add(timeout)) ==
+          gpcl::cv_status::timeout);
+  REQUIRE(start.elapsed() >= timeout);
+
+  // A system_time deadline is waited for, not treated as a timeout.
+  start = gpcl::instant::now();
+  REQUIRE_FALSE(cv.wait_until(lock, gpcl::system_time::now().checked_add(
+                                        timeout),
+                              [] { return false; }));
+  REQUIRE(start.elapsed() >= timeout);
+
+  start = gpcl::instant::now();
+  REQUIRE_FALSE(cv.wait_for(lock, timeout, [] { return false; }));
+  REQUIRE(start.elapsed() >= timeout);
+  REQUIRE(lock.owns_lock());
+
+  bool ready = false;
+  gpcl::thread t([&] {
+    gpcl::unique_lock<gpcl::mutex> l(m);
+    ready = true;
+    cv.notify_one();
+  });
+  REQUIRE(cv.wait_until(lock, gpcl::instant::now().saturating_add(
+                                  gpcl::duration::from_secs(10)),
+                        [&] { return ready; }));
+  lock.unlock();
+  t.join();
+}
+
+TEST_CASE("timed_mutex takes instant deadlines")
+{
+  gpcl::timed_mutex m;
+  m.lock();
+  bool locked = true;
+  gpcl::duration waited;
+  gpcl::thread t([&] {
+    gpcl::instant start = gpcl::instant::now();
+    locked = m.try_lock_until(start.saturating_add(timeout));
+    waited = start.elapsed();
+  });
+  t.join();
+  REQUIRE_FALSE(locked);
+  REQUIRE(waited >= timeout);
+
+  using namespace std::chrono_literals;
+  gpcl::thread t2([&] { locked = m.try_lock_for(20ms); });
+  t2.join();
+  REQUIRE_FALSE(locked);
+  m.unlock();
+
+  REQUIRE(m.try_lock_for(timeout));
+  m.unlock();
+}
+
+TEST_CASE("semaphore timed wait")
+{
+  gpcl::semaphore sem(1);
+  REQUIRE(sem.try_wait_for(timeout));
+
+  gpcl::instant start = gpcl::instant::now();
+  REQUIRE_FALSE(sem.try_wait_until(start.saturating_add(timeout)));
+  REQUIRE(start.elapsed() >= timeout);
+
+  sem.post();
+  REQUIRE(sem.try_wait_until(gpcl::instant::now()));
+}
+
+TEST_CASE("event timed wait")
+{
+  gpcl::mutex m;
+  gpcl::event e;
+  gpcl::unique_lock<gpcl::mutex> lock(m);
+
+  gpcl::instant start = gpcl::instant::now();
+  REQUIRE_FALSE(e.wait_for(lock, timeout));
+  REQUIRE(start.elapsed() >= timeout);
+
+  using namespace std::chrono_literals;
+  REQUIRE_FALSE(e.wait_for(lock, 1ms));
+
+  e.signal_all(lock);
+  REQUIRE(e.wait_until(lock, gpcl::instant::now()));
+}